@@ -1,785 +1,2467 @@
-#include <iostream>
-#include <vector>
-#include <queue>
-#include <utility>
-#include <chrono>
-#include <fstream>
-#include <algorithm>
-#include <random>
-#include <limits.h>
-
-using namespace std;
-using namespace std::chrono;
-
-class GrafMacierz
-{
-    int V;
-    vector<vector<int>> macierz;
-
-public:
-    GrafMacierz(int V) : V(V), macierz(V, vector<int>(V, 0)) {}
-
-    void dodajKrawedz(int u, int v, int w)
-    {
-        macierz[u][v] = w;
-        macierz[v][u] = w;
-    }
-
-    vector<vector<int>> pobierzMacierz() const
-    {
-        return macierz;
-    }
-
-    int pobierzV() const
-    {
-        return V;
-    }
-
-    void wczytajZPliku(const string &nazwaPliku)
-    {
-        ifstream plik(nazwaPliku);
-        if (!plik)
-        {
-            cerr << "Nie można otworzyć pliku " << nazwaPliku << endl;
-            exit(1);
-        }
-        int E;
-        plik >> V >> E;
-        macierz = vector<vector<int>>(V, vector<int>(V, 0));
-        for (int i = 0; i < E; i++)
-        {
-            int u, v, w;
-            plik >> u >> v >> w;
-            dodajKrawedz(u, v, w);
-        }
-        plik.close();
-    }
-
-    void wyswietl() const
-    {
-        for (const auto &wiersz : macierz)
-        {
-            for (const auto &wartosc : wiersz)
-            {
-                cout << wartosc << " ";
-            }
-            cout << endl;
-        }
-    }
-};
-
-class GrafLista
-{
-    int V;
-    vector<vector<pair<int, int>>> listaSasiedztwa;
-
-public:
-    GrafLista(int V) : V(V), listaSasiedztwa(V) {}
-
-    void dodajKrawedz(int u, int v, int w)
-    {
-        listaSasiedztwa[u].push_back({v, w});
-        listaSasiedztwa[v].push_back({u, w});
-    }
-
-    vector<vector<pair<int, int>>> pobierzListeSasiedztwa() const
-    {
-        return listaSasiedztwa;
-    }
-
-    int pobierzV() const
-    {
-        return V;
-    }
-
-    void wczytajZPliku(const string &nazwaPliku)
-    {
-        ifstream plik(nazwaPliku);
-        if (!plik)
-        {
-            cerr << "Nie można otworzyć pliku " << nazwaPliku << endl;
-            exit(1);
-        }
-        int E;
-        plik >> V >> E;
-        listaSasiedztwa = vector<vector<pair<int, int>>>(V);
-        for (int i = 0; i < E; i++)
-        {
-            int u, v, w;
-            plik >> u >> v >> w;
-            dodajKrawedz(u, v, w);
-        }
-        plik.close();
-    }
-
-    void wyswietl() const
-    {
-        for (int i = 0; i < V; i++)
-        {
-            cout << i << ": ";
-            for (const auto &p : listaSasiedztwa[i])
-            {
-                cout << "(" << p.first << ", " << p.second << ") ";
-            }
-            cout << endl;
-        }
-    }
-};
-
-void generujLosowyGraf(int V, double gestosc, GrafMacierz &gm, GrafLista &gl)
-{
-    gm = GrafMacierz(V);
-    gl = GrafLista(V);
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dist(1, 1000);
-    int krawedzie = gestosc / 100.0 * V * (V - 1) / 2;
-    while (krawedzie > 0)
-    {
-        int u = rand() % V;
-        int v = rand() % V;
-        if (u != v && gm.pobierzMacierz()[u][v] == 0)
-        {
-            int w = dist(gen);
-            gm.dodajKrawedz(u, v, w);
-            gl.dodajKrawedz(u, v, w);
-            krawedzie--;
-        }
-    }
-}
-
-vector<vector<int>> krawedzieDoMacierzy(int V, const vector<pair<int, int>> &krawedzie, const vector<vector<int>> &macierz)
-{
-    vector<vector<int>> macierzMST(V, vector<int>(V, 0));
-    for (const auto &krawedz : krawedzie)
-    {
-        int u = krawedz.first;
-        int v = krawedz.second;
-        macierzMST[u][v] = macierz[u][v];
-        macierzMST[v][u] = macierz[u][v];
-    }
-    return macierzMST;
-}
-
-void wyswietlMacierz(const vector<vector<int>> &macierz)
-{
-    for (const auto &wiersz : macierz)
-    {
-        for (const auto &wartosc : wiersz)
-        {
-            cout << wartosc << " ";
-        }
-        cout << endl;
-    }
-}
-
-void primMSTMacierz(const GrafMacierz &graf, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<int>> macierz = graf.pobierzMacierz();
-    vector<int> klucz(V, INT_MAX);
-    vector<int> rodzic(V, -1);
-    vector<bool> wMST(V, false);
-    vector<pair<int, int>> krawedzieMST;
-    int wagaMST = 0;
-
-    klucz[0] = 0;
-
-    for (int licznik = 0; licznik < V - 1; licznik++)
-    {
-        int min = INT_MAX, u;
-        for (int v = 0; v < V; v++)
-            if (!wMST[v] && klucz[v] < min)
-                min = klucz[v], u = v;
-
-        wMST[u] = true;
-        for (int v = 0; v < V; v++)
-            if (macierz[u][v] && !wMST[v] && macierz[u][v] < klucz[v])
-                rodzic[v] = u, klucz[v] = macierz[u][v];
-    }
-
-    for (int i = 1; i < V; i++)
-    {
-        krawedzieMST.push_back({rodzic[i], i});
-        wagaMST += macierz[rodzic[i]][i];
-    }
-    cout << "Całkowita waga MST: " << wagaMST << "\n";
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania MST Prima (Macierz): " << czas.count() << " milisekund\n";
-
-    if (!symulacja)
-    {
-        vector<vector<int>> macierzMST = krawedzieDoMacierzy(V, krawedzieMST, macierz);
-        cout << "Macierz MST:\n";
-        wyswietlMacierz(macierzMST);
-    }
-}
-
-void primMSTLista(const GrafLista &graf, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<pair<int, int>>> listaSasiedztwa = graf.pobierzListeSasiedztwa();
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-    vector<int> klucz(V, INT_MAX);
-    vector<int> rodzic(V, -1);
-    vector<bool> wMST(V, false);
-    vector<pair<int, int>> krawedzieMST;
-    int wagaMST = 0;
-
-    int src = 0;
-    pq.push({0, src});
-    klucz[src] = 0;
-
-    while (!pq.empty())
-    {
-        int u = pq.top().second;
-        pq.pop();
-        wMST[u] = true;
-
-        for (auto x : listaSasiedztwa[u])
-        {
-            int v = x.first;
-            int waga = x.second;
-            if (!wMST[v] && klucz[v] > waga)
-            {
-                klucz[v] = waga;
-                pq.push({klucz[v], v});
-                rodzic[v] = u;
-            }
-        }
-    }
-
-    for (int i = 1; i < V; ++i)
-    {
-        krawedzieMST.push_back({rodzic[i], i});
-        for (auto x : listaSasiedztwa[rodzic[i]])
-        {
-            if (x.first == i)
-            {
-                wagaMST += x.second;
-                break;
-            }
-        }
-    }
-    cout << "Całkowita waga MST: " << wagaMST << "\n";
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania MST Prima (Lista): " << czas.count() << " milisekund\n\n";
-
-    if (!symulacja)
-    {
-        cout << "Lista sąsiedztwa MST:\n";
-        for (int i = 1; i < V; ++i)
-        {
-            cout << rodzic[i] << " - " << i << " \n";
-        }
-    }
-}
-
-struct Krawedz
-{
-    int u, v, waga;
-    bool operator<(const Krawedz &k) const
-    {
-        return waga < k.waga;
-    }
-};
-
-class DSU
-{
-    vector<int> rodzic, ranga;
-
-public:
-    DSU(int n)
-    {
-        rodzic.resize(n);
-        ranga.resize(n);
-        for (int i = 0; i < n; i++)
-        {
-            rodzic[i] = i;
-            ranga[i] = 0;
-        }
-    }
-
-    int znajdz(int u)
-    {
-        if (u != rodzic[u])
-            rodzic[u] = znajdz(rodzic[u]);
-        return rodzic[u];
-    }
-
-    void polacz(int u, int v)
-    {
-        u = znajdz(u);
-        v = znajdz(v);
-        if (u != v)
-        {
-            if (ranga[u] < ranga[v])
-            {
-                rodzic[u] = v;
-            }
-            else if (ranga[u] > ranga[v])
-            {
-                rodzic[v] = u;
-            }
-            else
-            {
-                rodzic[v] = u;
-                ranga[u]++;
-            }
-        }
-    }
-};
-
-void kruskalMSTMacierz(const GrafMacierz &graf, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<int>> macierz = graf.pobierzMacierz();
-    vector<Krawedz> krawedzie;
-    vector<pair<int, int>> krawedzieMST;
-    int wagaMST = 0;
-
-    for (int u = 0; u < V; u++)
-    {
-        for (int v = u + 1; v < V; v++)
-        {
-            if (macierz[u][v])
-            {
-                krawedzie.push_back({u, v, macierz[u][v]});
-            }
-        }
-    }
-
-    sort(krawedzie.begin(), krawedzie.end());
-
-    DSU dsu(V);
-    for (const auto &krawedz : krawedzie)
-    {
-        int u = krawedz.u;
-        int v = krawedz.v;
-        int waga = krawedz.waga;
-
-        if (dsu.znajdz(u) != dsu.znajdz(v))
-        {
-            krawedzieMST.push_back({u, v});
-            wagaMST += waga;
-            dsu.polacz(u, v);
-        }
-    }
-    cout << "Całkowita waga MST: " << wagaMST << "\n";
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania MST Kruskala (Macierz): " << czas.count() << " milisekund\n";
-
-    if (!symulacja)
-    {
-        vector<vector<int>> macierzMST = krawedzieDoMacierzy(V, krawedzieMST, macierz);
-        cout << "Macierz MST:\n";
-        wyswietlMacierz(macierzMST);
-    }
-}
-
-void kruskalMSTLista(const GrafLista &graf, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<pair<int, int>>> listaSasiedztwa = graf.pobierzListeSasiedztwa();
-    vector<Krawedz> krawedzie;
-    vector<pair<int, int>> krawedzieMST;
-    int wagaMST = 0;
-
-    for (int u = 0; u < V; u++)
-    {
-        for (auto &x : listaSasiedztwa[u])
-        {
-            int v = x.first;
-            int waga = x.second;
-            if (u < v)
-            {
-                krawedzie.push_back({u, v, waga});
-            }
-        }
-    }
-
-    sort(krawedzie.begin(), krawedzie.end());
-
-    DSU dsu(V);
-    for (const auto &krawedz : krawedzie)
-    {
-        int u = krawedz.u;
-        int v = krawedz.v;
-        int waga = krawedz.waga;
-
-        if (dsu.znajdz(u) != dsu.znajdz(v))
-        {
-            krawedzieMST.push_back({u, v});
-            wagaMST += waga;
-            dsu.polacz(u, v);
-        }
-    }
-    cout << "Całkowita waga MST: " << wagaMST << "\n";
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania MST Kruskala (Lista): " << czas.count() << " milisekund\n\n";
-
-    if (!symulacja)
-    {
-        cout << "Lista sąsiedztwa MST:\n";
-        for (const auto &k : krawedzieMST)
-        {
-            cout << k.first << " - " << k.second << "\n";
-        }
-    }
-}
-
-void dijkstraMacierz(const GrafMacierz &graf, int zrodlo, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<int>> macierz = graf.pobierzMacierz();
-    vector<int> odleglosci(V, INT_MAX);
-    vector<bool> odwiedzone(V, false);
-    odleglosci[zrodlo] = 0;
-
-    for (int i = 0; i < V - 1; i++)
-    {
-        int min = INT_MAX, u;
-        for (int v = 0; v < V; v++)
-        {
-            if (!odwiedzone[v] && odleglosci[v] <= min)
-            {
-                min = odleglosci[v];
-                u = v;
-            }
-        }
-
-        odwiedzone[u] = true;
-
-        for (int v = 0; v < V; v++)
-        {
-            if (!odwiedzone[v] && macierz[u][v] && odleglosci[u] != INT_MAX && odleglosci[u] + macierz[u][v] < odleglosci[v])
-            {
-                odleglosci[v] = odleglosci[u] + macierz[u][v];
-            }
-        }
-    }
-
-    if (!symulacja)
-    {
-        cout << "Odległości od źródła " << zrodlo << ":\n";
-    }
-    for (int i = 0; i < V; i++)
-    {
-        if (!symulacja)
-        {
-            cout << "Do wierzchołka " << i << ": " << odleglosci[i] << "\n";
-        }
-    }
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania algorytmu Dijkstry (Macierz): " << czas.count() << " milisekund\n";
-}
-
-void dijkstraLista(const GrafLista &graf, int zrodlo, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<pair<int, int>>> listaSasiedztwa = graf.pobierzListeSasiedztwa();
-    vector<int> odleglosci(V, INT_MAX);
-    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
-    odleglosci[zrodlo] = 0;
-    pq.push({0, zrodlo});
-
-    while (!pq.empty())
-    {
-        int u = pq.top().second;
-        pq.pop();
-
-        for (auto x : listaSasiedztwa[u])
-        {
-            int v = x.first;
-            int waga = x.second;
-            if (odleglosci[u] + waga < odleglosci[v])
-            {
-                odleglosci[v] = odleglosci[u] + waga;
-                pq.push({odleglosci[v], v});
-            }
-        }
-    }
-
-    if (!symulacja)
-    {
-        cout << "Odległości od źródła " << zrodlo << ":\n";
-    }
-    for (int i = 0; i < V; i++)
-    {
-        if (!symulacja)
-        {
-            cout << "Do wierzchołka " << i << ": " << odleglosci[i] << "\n";
-        }
-    }
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania algorytmu Dijkstry (Lista): " << czas.count() << " milisekund\n\n";
-}
-
-void BellmanFordMacierz(const GrafMacierz &graf, int zrodlo, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<int>> macierz = graf.pobierzMacierz();
-    vector<int> odleglosci(V, INT_MAX);
-    odleglosci[zrodlo] = 0;
-
-    for (int i = 1; i <= V - 1; i++)
-    {
-        for (int u = 0; u < V; u++)
-        {
-            for (int v = 0; v < V; v++)
-            {
-                if (macierz[u][v] && odleglosci[u] != INT_MAX && odleglosci[u] + macierz[u][v] < odleglosci[v])
-                {
-                    odleglosci[v] = odleglosci[u] + macierz[u][v];
-                }
-            }
-        }
-    }
-
-    for (int u = 0; u < V; u++)
-    {
-        for (int v = 0; v < V; v++)
-        {
-            if (macierz[u][v] && odleglosci[u] != INT_MAX && odleglosci[u] + macierz[u][v] < odleglosci[v])
-            {
-                cout << "Graf zawiera cykl o ujemnej wadze!\n";
-                return;
-            }
-        }
-    }
-
-    if (!symulacja)
-    {
-        cout << "Odległości od źródła " << zrodlo << ":\n";
-    }
-    for (int i = 0; i < V; i++)
-    {
-        if (!symulacja)
-        {
-            cout << "Do wierzchołka " << i << ": " << odleglosci[i] << "\n";
-        }
-    }
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania algorytmu Bellmana-Forda (Macierz): " << czas.count() << " milisekund\n";
-}
-
-void BellmanFordLista(const GrafLista &graf, int zrodlo, bool symulacja = false)
-{
-    auto start = high_resolution_clock::now();
-
-    int V = graf.pobierzV();
-    vector<vector<pair<int, int>>> listaSasiedztwa = graf.pobierzListeSasiedztwa();
-    vector<int> odleglosci(V, INT_MAX);
-    odleglosci[zrodlo] = 0;
-
-    for (int i = 1; i <= V - 1; i++)
-    {
-        for (int u = 0; u < V; u++)
-        {
-            for (auto x : listaSasiedztwa[u])
-            {
-                int v = x.first;
-                int waga = x.second;
-                if (odleglosci[u] != INT_MAX && odleglosci[u] + waga < odleglosci[v])
-                {
-                    odleglosci[v] = odleglosci[u] + waga;
-                }
-            }
-        }
-    }
-
-    for (int u = 0; u < V; u++)
-    {
-        for (auto x : listaSasiedztwa[u])
-        {
-            int v = x.first;
-            int waga = x.second;
-            if (odleglosci[u] != INT_MAX && odleglosci[u] + waga < odleglosci[v])
-            {
-                cout << "Graf zawiera cykl o ujemnej wadze!\n";
-                return;
-            }
-        }
-    }
-
-    if (!symulacja)
-    {
-        cout << "Odległości od źródła " << zrodlo << ":\n";
-    }
-    for (int i = 0; i < V; i++)
-    {
-        if (!symulacja)
-        {
-            cout << "Do wierzchołka " << i << ": " << odleglosci[i] << "\n";
-        }
-    }
-
-    auto stop = high_resolution_clock::now();
-    auto czas = duration_cast<milliseconds>(stop - start);
-    cout << "Czas wykonania algorytmu Bellmana-Forda (Lista): " << czas.count() << " milisekund\n\n";
-}
-
-void wyswietlMenu()
-{
-    cout << "Menu:\n";
-    cout << "1. Wczytaj dane z pliku\n";
-    cout << "2. Wygeneruj graf losowo\n";
-    cout << "3. Wyświetl graf listowo i macierzowo\n";
-    cout << "4. Algorytm Prima (macierzowo i listowo) z wyświetleniem wyników\n";
-    cout << "5. Algorytm Kruskala (macierzowo i listowo) z wyświetleniem wyników\n";
-    cout << "6. Algorytm Dijkstry (macierzowo i listowo) z wyświetleniem wyników\n";
-    cout << "7. Algorytm Bellmana-Forda (macierzowo i listowo) z wyświetleniem wyników\n";
-    cout << "8. Tryb symulacji\n";
-    cout << "9. Wyjście\n";
-}
-
-int main()
-{
-    GrafMacierz gm(0);
-    GrafLista gl(0);
-    int wybor;
-    string nazwaPliku;
-    int V = 0, zrodlo = 0, liczbaSymulacji = 1;
-    double gestosc = 0.0;
-    bool symulacja = false;
-    while (true)
-    {
-        wyswietlMenu();
-        cin >> wybor;
-        switch (wybor)
-        {
-        case 1:
-            cout << "Podaj nazwę pliku: ";
-            cin >> nazwaPliku;
-            gm.wczytajZPliku(nazwaPliku);
-            gl.wczytajZPliku(nazwaPliku);
-            break;
-        case 2:
-            cout << "Podaj liczbę wierzchołków: ";
-            cin >> V;
-            cout << "Podaj gęstość grafu (w procentach): ";
-            cin >> gestosc;
-            generujLosowyGraf(V, gestosc, gm, gl);
-            break;
-        case 3:
-            cout << "\nGraf w formie macierzowej:\n";
-            gm.wyswietl();
-            cout << "\nGraf w formie listowej:\n";
-            gl.wyswietl();
-            break;
-        case 4:
-            if (!symulacja)
-            {
-                primMSTMacierz(gm);
-                cout << "\n";
-                primMSTLista(gl);
-            }
-            else
-            {
-                for (int i = 0; i < liczbaSymulacji; i++)
-                {
-                    generujLosowyGraf(V, gestosc, gm, gl);
-                    primMSTMacierz(gm, symulacja);
-                    cout << "\n";
-                    primMSTLista(gl, symulacja);
-                }
-            }
-            break;
-        case 5:
-            if (!symulacja)
-            {
-                kruskalMSTMacierz(gm);
-                cout << "\n";
-                kruskalMSTLista(gl);
-            }
-            else
-            {
-                for (int i = 0; i < liczbaSymulacji; i++)
-                {
-                    generujLosowyGraf(V, gestosc, gm, gl);
-                    kruskalMSTMacierz(gm, symulacja);
-                    cout << "\n";
-                    kruskalMSTLista(gl, symulacja);
-                }
-            }
-            break;
-        case 6:
-            cout << "Podaj wierzchołek źródłowy: ";
-            cin >> zrodlo;
-            if (!symulacja)
-            {
-                dijkstraMacierz(gm, zrodlo);
-                cout << "\n";
-                dijkstraLista(gl, zrodlo);
-            }
-            else
-            {
-                for (int i = 0; i < liczbaSymulacji; i++)
-                {
-                    generujLosowyGraf(V, gestosc, gm, gl);
-                    dijkstraMacierz(gm, zrodlo, symulacja);
-                    cout << "\n";
-                    dijkstraLista(gl, zrodlo, symulacja);
-                }
-            }
-            break;
-        case 7:
-            cout << "Podaj wierzchołek źródłowy: ";
-            cin >> zrodlo;
-            if (!symulacja)
-            {
-                BellmanFordMacierz(gm, zrodlo);
-                cout << "\n";
-                BellmanFordLista(gl, zrodlo);
-            }
-            else
-            {
-                for (int i = 0; i < liczbaSymulacji; i++)
-                {
-                    generujLosowyGraf(V, gestosc, gm, gl);
-                    BellmanFordMacierz(gm, zrodlo, symulacja);
-                    cout << "\n";
-                    BellmanFordLista(gl, zrodlo, symulacja);
-                }
-            }
-            break;
-        case 8:
-            cout << "Podaj liczbę symulacji: ";
-            cin >> liczbaSymulacji;
-            symulacja = true;
-            break;
-        case 9:
-            return 0;
-        default:
-            cout << "Nieprawidłowa opcja! Spróbuj ponownie.\n";
-        }
-    }
-}
\ No newline at end of file
+#include "grafy.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace grafy;
+
+// Zamienia graf tekstowy (format graf.txt) na binarny format CSR.
+int trybKonwersji(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        cerr << "Użycie: grafy konwertuj WEJSCIE.txt WYJSCIE.bin\n";
+        return 1;
+    }
+    auto start = steady_clock::now();
+    GrafCSR gc;
+    wczytajGraf(argv[0], nullptr, &gc);
+    gc.zapiszBinarnie(argv[1]);
+    auto czas = duration_cast<milliseconds>(steady_clock::now() - start);
+    cerr << "Zapisano graf: V = " << gc.pobierzV() << ", E = " << gc.pobierzLiczbeSasiadow() / 2
+         << " w " << czas.count() << " milisekund\n";
+    return 0;
+}
+
+// Kruskal poza pamięcią: krawędzie z pliku tekstowego są sortowane w seriach mieszczących się
+// w budżecie i scalane z plików tymczasowych.
+int trybKruskalaZewnetrznego(int argc, char **argv)
+{
+    const char *UZYCIE = "Użycie: grafy kruskal-zewnetrzny PLIK.txt [--budzet MB] [--katalog KATALOG] [--watki N]\n";
+    if (argc < 1 || argc % 2 != 1)
+    {
+        cerr << UZYCIE;
+        return 1;
+    }
+    size_t budzetMB = 256;
+    string katalog = ".";
+    int watki = 1;
+    try
+    {
+        for (int i = 1; i < argc; i += 2)
+        {
+            string opcja = argv[i], wartosc = argv[i + 1];
+            if (opcja == "--budzet")
+                budzetMB = stoull(wartosc);
+            else if (opcja == "--katalog")
+                katalog = wartosc;
+            else if (opcja == "--watki")
+                watki = stoi(wartosc);
+            else
+            {
+                cerr << "Nieznana opcja " << opcja << "\n" << UZYCIE;
+                return 1;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość opcji\n" << UZYCIE;
+        return 1;
+    }
+    if (watki < 1)
+        watki = 1;
+
+    PulaWatkow pula(watki);
+    StatystykiZewnetrzne st;
+    auto start = steady_clock::now();
+    WynikMST wynik = obliczKruskalZewnetrzny(argv[0], budzetMB << 20, katalog, pula, &st);
+    auto czas = duration_cast<milliseconds>(steady_clock::now() - start);
+    cout << "Całkowita waga MST: " << wynik.waga << " (" << wynik.krawedzie.size() << " krawędzi)\n";
+    cout << "Czas wykonania MST Kruskala (zewnętrznie): " << czas.count() << " milisekund\n";
+    cout << opiszStatystyki(st) << "\n";
+    cout << "Szczytowy RSS " << szczytowyRSS() << " kB\n";
+    return 0;
+}
+
+void wyswietlPamiec(size_t bajtyGrafu, size_t bajtyRobocze, size_t bajtyKolejki, ostream &wyjscie = cout)
+{
+    wyjscie << "Pamięć: graf " << bajtyGrafu << " B, obszar roboczy " << bajtyRobocze << " B, kolejka " << bajtyKolejki
+         << " B, szczytowy RSS " << szczytowyRSS() << " kB\n";
+}
+
+void wyswietlPamiec(size_t bajtyGrafu, const ObszarRoboczy &obszar, ostream &wyjscie = cout)
+{
+    wyswietlPamiec(bajtyGrafu, obszar.pobierzZajete(), obszar.pobierzBajtyKolejki(), wyjscie);
+}
+
+template <typename Macierz>
+void primMSTMacierz(const Macierz &macierz, ObszarRoboczy &obszar, bool symulacja, ostream &wyjscie)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikMST wynik = obliczPrimMSTMacierzWektorowo(macierz, obszar);
+    auto stop = high_resolution_clock::now();
+
+    wyjscie << "Całkowita waga MST: " << wynik.waga << "\n";
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania MST Prima (Macierz, jądro " << nazwaZestawu(najlepszyZestawInstrukcji()) << "): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(macierz.pobierzRozmiarBajtow(), obszar, wyjscie);
+
+    if (!symulacja)
+    {
+        wyjscie << "Macierz MST:\n";
+        Pisarz p(wyjscie);
+        zapiszMacierzMST(p, wynik, macierz);
+    }
+}
+
+void primMSTMacierz(const GrafMacierz &graf, ObszarRoboczy &obszar, bool symulacja = false, ostream &wyjscie = cout)
+{
+    graf.zWidokiem([&](const auto &macierz)
+                   { primMSTMacierz(macierz, obszar, symulacja, wyjscie); });
+}
+
+void primMSTLista(WidokCSR graf, ObszarRoboczy &obszar, bool symulacja = false,
+                  RodzajKolejki rodzaj = RodzajKolejki::Binarna, ostream &wyjscie = cout)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikMST wynik = obliczPrimMSTLista(graf, obszar, rodzaj);
+    auto stop = high_resolution_clock::now();
+
+    wyjscie << "Całkowita waga MST: " << wynik.waga << "\n";
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania MST Prima (Lista): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), obszar, wyjscie);
+    wyjscie << "\n";
+
+    if (!symulacja)
+    {
+        wyjscie << "Lista sąsiedztwa MST:\n";
+        Pisarz p(wyjscie);
+        zapiszKrawedzieMST(p, wynik);
+    }
+}
+
+template <typename Macierz>
+void kruskalMSTMacierz(const Macierz &macierz, ObszarRoboczy &obszar, bool symulacja, ostream &wyjscie)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikMST wynik = obliczKruskalMSTMacierz(macierz, obszar);
+    auto stop = high_resolution_clock::now();
+
+    wyjscie << "Całkowita waga MST: " << wynik.waga << "\n";
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania MST Kruskala (Macierz): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(macierz.pobierzRozmiarBajtow(), obszar, wyjscie);
+
+    if (!symulacja)
+    {
+        wyjscie << "Macierz MST:\n";
+        Pisarz p(wyjscie);
+        zapiszMacierzMST(p, wynik, macierz);
+    }
+}
+
+void kruskalMSTMacierz(const GrafMacierz &graf, ObszarRoboczy &obszar, bool symulacja = false, ostream &wyjscie = cout)
+{
+    graf.zWidokiem([&](const auto &macierz)
+                   { kruskalMSTMacierz(macierz, obszar, symulacja, wyjscie); });
+}
+
+void kruskalMSTLista(WidokCSR graf, ObszarRoboczy &obszar, bool symulacja = false, ostream &wyjscie = cout)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikMST wynik = obliczKruskalMSTLista(graf, obszar);
+    auto stop = high_resolution_clock::now();
+
+    wyjscie << "Całkowita waga MST: " << wynik.waga << "\n";
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania MST Kruskala (Lista): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), obszar, wyjscie);
+    wyjscie << "\n";
+
+    if (!symulacja)
+    {
+        wyjscie << "Lista sąsiedztwa MST:\n";
+        Pisarz p(wyjscie);
+        zapiszKrawedzieMST(p, wynik);
+    }
+}
+
+void boruvkaMSTLista(WidokCSR graf, int watki, bool symulacja = false)
+{
+    PulaWatkow pula(watki);
+    StatystykiBoruvki st;
+    auto start = high_resolution_clock::now();
+    WynikMST wynik = obliczBoruvkaMSTLista(graf, pula, &st);
+    auto stop = high_resolution_clock::now();
+
+    cout << "Całkowita waga MST: " << wynik.waga << "\n";
+    auto czas = duration_cast<milliseconds>(stop - start);
+    cout << "Czas wykonania MST Borůvki (Lista, " << watki << " wątków): " << czas.count() << " milisekund\n";
+    for (size_t i = 0; i < st.rundy.size(); i++)
+    {
+        cout << "Runda " << i + 1 << ": " << st.rundy[i].skladowe << " składowych, " << st.rundy[i].krawedzie
+             << " krawędzi, " << fixed << setprecision(3) << st.rundy[i].czas << defaultfloat << setprecision(6)
+             << " ms\n";
+    }
+    cout << "\n";
+
+    if (!symulacja)
+    {
+        cout << "Lista krawędzi MST:\n";
+        Pisarz p(cout);
+        zapiszKrawedzieMST(p, wynik);
+    }
+}
+
+void dynamiczneMSTLista(WidokCSR graf, bool symulacja = false)
+{
+    auto start = high_resolution_clock::now();
+    DynamiczneMST mst(graf);
+    auto stop = high_resolution_clock::now();
+    cout << "Zbudowano MST (waga " << mst.calkowitaWaga() << ", " << mst.liczbaKrawedziLasu() << " krawędzi) w "
+         << duration_cast<milliseconds>(stop - start).count() << " milisekund\n";
+
+    if (symulacja)
+    {
+        const int ZMIANY = 1000;
+        mt19937_64 gen(random_device{}());
+        start = high_resolution_clock::now();
+        losoweZmianyMST(mst, graf, ZMIANY, gen);
+        stop = high_resolution_clock::now();
+        cout << "Czas " << ZMIANY << " losowych zmian krawędzi: " << duration_cast<microseconds>(stop - start).count()
+             << " mikrosekund, waga MST po zmianach: " << mst.calkowitaWaga() << "\n\n";
+        return;
+    }
+
+    cout << "Polecenia: d u v w - dodaj krawędź lub zmień jej wagę, u u v - usuń krawędź,\n"
+         << "           w - waga MST, m - krawędzie MST, k - koniec\n";
+    char polecenie;
+    while (cout << "> " && cin >> polecenie && polecenie != 'k')
+    {
+        int u, v, w;
+        switch (polecenie)
+        {
+        case 'd':
+            cin >> u >> v >> w;
+            if (u < 0 || v < 0 || u >= mst.pobierzV() || v >= mst.pobierzV())
+            {
+                cout << "Nieprawidłowy wierzchołek\n";
+                break;
+            }
+            start = high_resolution_clock::now();
+            mst.dodajKrawedz(u, v, w);
+            stop = high_resolution_clock::now();
+            cout << "Waga MST: " << mst.calkowitaWaga() << " (" << duration_cast<microseconds>(stop - start).count()
+                 << " mikrosekund)\n";
+            break;
+        case 'u':
+            cin >> u >> v;
+            if (u < 0 || v < 0 || u >= mst.pobierzV() || v >= mst.pobierzV())
+            {
+                cout << "Nieprawidłowy wierzchołek\n";
+                break;
+            }
+            start = high_resolution_clock::now();
+            if (!mst.usunKrawedz(u, v))
+            {
+                cout << "Nie ma krawędzi " << u << " - " << v << "\n";
+                break;
+            }
+            stop = high_resolution_clock::now();
+            cout << "Waga MST: " << mst.calkowitaWaga() << " (" << duration_cast<microseconds>(stop - start).count()
+                 << " mikrosekund)\n";
+            break;
+        case 'w':
+            cout << "Waga MST: " << mst.calkowitaWaga() << ", krawędzi: " << mst.liczbaKrawedziLasu() << "\n";
+            break;
+        case 'm':
+        {
+            Pisarz p(cout);
+            zapiszKrawedzieMST(p, mst.drzewoRozpinajace());
+            break;
+        }
+        default:
+            cout << "Nieznane polecenie\n";
+        }
+    }
+    cout << "\n";
+}
+
+void kruskalMSTRownolegle(const GrafMacierz &gm, WidokCSR gc, TrybKruskala tryb, int watki, bool symulacja = false)
+{
+    PulaWatkow pula(watki);
+    const char *nazwy[] = {"Macierz", "Lista"};
+    for (int r = 0; r < 2; r++)
+    {
+        StatystykiKruskala st;
+        auto start = high_resolution_clock::now();
+        WynikMST wynik = r == 0 ? obliczKruskalMSTMacierz(gm, tryb, pula, &st) : obliczKruskalMSTLista(gc, tryb, pula, &st);
+        auto stop = high_resolution_clock::now();
+
+        cout << "Całkowita waga MST: " << wynik.waga << "\n";
+        auto czas = duration_cast<milliseconds>(stop - start);
+        cout << "Czas wykonania MST Kruskala (" << nazwy[r] << ", " << nazwaTrybuKruskala(tryb) << ", " << watki
+             << " wątków): " << czas.count() << " milisekund\n";
+        cout << "Posortowane krawędzie: " << st.posortowane << " z " << st.krawedzie << "\n\n";
+
+        if (!symulacja)
+        {
+            cout << "Lista krawędzi MST:\n";
+            {
+                Pisarz p(cout);
+                zapiszKrawedzieMST(p, wynik);
+            }
+            cout << "\n";
+        }
+    }
+}
+
+void dijkstraMacierz(const GrafMacierz &graf, int zrodlo, ObszarRoboczy &obszar, bool symulacja = false,
+                     ostream &wyjscie = cout)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczDijkstraMacierzWektorowo(graf, zrodlo, obszar);
+    auto stop = high_resolution_clock::now();
+
+    if (!symulacja)
+    {
+        Pisarz p(wyjscie);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania algorytmu Dijkstry (Macierz, jądro " << nazwaZestawu(najlepszyZestawInstrukcji()) << "): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), obszar, wyjscie);
+}
+
+void floydWarshallMacierz(const GrafMacierz &graf, int watki, const string &plikWynikowy, bool symulacja = false)
+{
+    PulaWatkow pula(watki);
+    auto start = high_resolution_clock::now();
+    MacierzOdleglosci wynik = obliczFloydWarshallMacierz(graf, pula);
+    auto stop = high_resolution_clock::now();
+
+    if (wynik.ujemnyCykl)
+    {
+        cout << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+
+    if (!symulacja)
+    {
+        if (plikWynikowy.empty() || plikWynikowy == "-")
+        {
+            cout << "Macierz odległości:\n";
+            wynik.zapisz(cout);
+        }
+        else
+        {
+            ofstream plik(plikWynikowy);
+            if (!plik)
+            {
+                cerr << "Nie można otworzyć pliku " << plikWynikowy << endl;
+                exit(1);
+            }
+            wynik.zapisz(plik);
+            cout << "Zapisano macierz odległości do " << plikWynikowy << "\n";
+        }
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    cout << "Czas wykonania algorytmu Floyda-Warshalla (Macierz, " << watki << " wątków): " << czas.count()
+         << " milisekund\n\n";
+}
+
+// Macierz odległości Johnsona powstaje w pamięci, gdy 4 * V^2 bajtów mieści się w budżecie;
+// inaczej odległości z kolejnych źródeł są wypisywane w miarę liczenia, w kolejności kończenia.
+const int64_t DOMYSLNY_BUDZET_JOHNSONA = 1LL << 30;
+
+void johnsonLista(WidokCSR graf, int watki, RodzajKolejki rodzaj, ostream &wyjscie, ostream &raport, bool binarnie,
+                  int64_t budzetBajtow = DOMYSLNY_BUDZET_JOHNSONA, bool symulacja = false)
+{
+    int V = graf.pobierzV();
+    bool strumieniowo = (int64_t)V * V * (int64_t)sizeof(int) > budzetBajtow;
+    PulaWatkow pula(watki);
+    StatystykiJohnsona st;
+    bool bezCyklu = true;
+    Pisarz p(wyjscie);
+    auto start = high_resolution_clock::now();
+    if (strumieniowo)
+    {
+        vector<int> zrodla(V);
+        iota(zrodla.begin(), zrodla.end(), 0);
+        bezCyklu = obliczJohnsonStrumieniowo(graf, zrodla, pula, rodzaj, [&](int64_t, const WynikOdleglosci &wynik)
+                                             {
+            if (symulacja)
+                return;
+            if (binarnie)
+                zapiszBinarnie(p, wynik);
+            else
+                zapiszOdleglosci(p, wynik);
+            p.oproznij(); },
+                                             &st);
+    }
+    else
+    {
+        MacierzOdleglosci wynik = obliczJohnsonLista(graf, pula, rodzaj, &st);
+        bezCyklu = !wynik.ujemnyCykl;
+        if (bezCyklu && !symulacja)
+        {
+            if (binarnie)
+                zapiszBinarnie(p, wynik);
+            else
+            {
+                p.oproznij();
+                wynik.zapisz(wyjscie);
+            }
+        }
+    }
+    auto stop = high_resolution_clock::now();
+    p.oproznij();
+    wyjscie.flush();
+
+    if (!bezCyklu)
+    {
+        raport << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+    auto czas = duration_cast<milliseconds>(stop - start);
+    raport << "Czas wykonania algorytmu Johnsona (Lista, " << watki << " wątków, "
+           << (strumieniowo ? "strumieniowo" : "macierz odległości") << "): " << czas.count() << " milisekund\n";
+    raport << opiszStatystyki(st) << "\n";
+    raport << "Szczytowy RSS " << szczytowyRSS() << " kB\n\n";
+}
+
+void dijkstraLista(WidokCSR graf, int zrodlo, ObszarRoboczy &obszar, bool symulacja = false,
+                   RodzajKolejki rodzaj = RodzajKolejki::Binarna, ostream &wyjscie = cout)
+{
+    obszar.resetuj();
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczDijkstraLista(graf, zrodlo, obszar, rodzaj);
+    auto stop = high_resolution_clock::now();
+
+    if (!symulacja)
+    {
+        Pisarz p(wyjscie);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania algorytmu Dijkstry (Lista): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), obszar, wyjscie);
+    wyjscie << "\n";
+}
+
+// Zapytanie o jedną parę wierzchołków we wszystkich wariantach: Dijkstra macierzowy i listowy
+// kończony po ustaleniu celu, dwukierunkowy Dijkstra i A* z punktami orientacyjnymi (ALT).
+void sciezkaPunktPunkt(const GrafMacierz &gm, WidokCSR gc, int zrodlo, int cel, ObszarRoboczy &obszar,
+                       bool symulacja = false)
+{
+    if (zrodlo < 0 || zrodlo >= gc.pobierzV() || cel < 0 || cel >= gc.pobierzV())
+    {
+        cout << "Nieprawidłowy wierzchołek!\n";
+        return;
+    }
+    const int PUNKTY = 8;
+    auto start = high_resolution_clock::now();
+    PunktyOrientacyjne punkty(gc, PUNKTY);
+    auto czasPunktow = duration_cast<microseconds>(high_resolution_clock::now() - start);
+    PrzeszukiwanieDoCelu przod, tyl;
+
+    auto wypisz = [&](const char *nazwa, auto &&oblicz)
+    {
+        obszar.resetuj();
+        auto start = high_resolution_clock::now();
+        WynikZapytania wynik = oblicz();
+        auto stop = high_resolution_clock::now();
+        if (!symulacja)
+        {
+            Pisarz p(cout);
+            zapiszSciezke(p, wynik);
+        }
+        cout << "Czas wykonania (" << nazwa << "): " << duration_cast<microseconds>(stop - start).count()
+             << " mikrosekund, ustalone wierzchołki: " << wynik.ustalone << "\n";
+    };
+    wypisz("Dijkstra do celu, Macierz", [&]
+           { return obliczDijkstraMacierzDoCelu(gm, zrodlo, cel, obszar); });
+    wypisz("Dijkstra do celu, Lista", [&]
+           { return obliczDijkstraDoCelu(gc, zrodlo, cel, przod); });
+    wypisz("Dijkstra dwukierunkowy, Lista", [&]
+           { return obliczDijkstraDwukierunkowy(gc, zrodlo, cel, przod, tyl); });
+    wypisz("A* z punktami orientacyjnymi, Lista", [&]
+           { return obliczALT(gc, zrodlo, cel, punkty, przod); });
+    cout << "Przygotowanie " << punkty.pobierzPunkty().size() << " punktów orientacyjnych: " << czasPunktow.count()
+         << " mikrosekund\n\n";
+}
+
+void deltaSteppingLista(WidokCSR graf, int zrodlo, int watki, int delta, bool symulacja = false)
+{
+    PulaWatkow pula(watki);
+    StatystykiDeltaStepping st;
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczDeltaStepping(graf, zrodlo, pula, delta, &st);
+    auto stop = high_resolution_clock::now();
+
+    if (!symulacja)
+    {
+        Pisarz p(cout);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    cout << "Czas wykonania algorytmu delta-stepping (Lista): " << czas.count() << " milisekund\n";
+    cout << "Fazy: " << opiszStatystyki(st) << "\n\n";
+}
+
+void BellmanFordMacierz(const GrafMacierz &graf, int zrodlo, bool symulacja = false, ostream &wyjscie = cout)
+{
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczBellmanFordMacierz(graf, zrodlo);
+    auto stop = high_resolution_clock::now();
+
+    if (wynik.ujemnyCykl)
+    {
+        wyjscie << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+
+    if (!symulacja)
+    {
+        Pisarz p(wyjscie);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania algorytmu Bellmana-Forda (Macierz): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), wynik.odleglosci.capacity() * sizeof(int), 0, wyjscie); // poza wynikiem nic nie przydziela
+}
+
+void BellmanFordLista(WidokCSR graf, int zrodlo, bool symulacja = false, ostream &wyjscie = cout)
+{
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczBellmanFordLista(graf, zrodlo);
+    auto stop = high_resolution_clock::now();
+
+    if (wynik.ujemnyCykl)
+    {
+        wyjscie << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+
+    if (!symulacja)
+    {
+        Pisarz p(wyjscie);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    wyjscie << "Czas wykonania algorytmu Bellmana-Forda (Lista): " << czas.count() << " milisekund\n";
+    wyswietlPamiec(graf.pobierzRozmiarBajtow(), wynik.odleglosci.capacity() * sizeof(int), 0, wyjscie);
+    wyjscie << "\n";
+}
+
+void BellmanFordListaSzybki(WidokCSR graf, int zrodlo, TrybBellmanaForda tryb, int watki, bool symulacja = false)
+{
+    PulaWatkow pula(tryb == TrybBellmanaForda::Rownolegly ? watki : 1);
+    StatystykiBellmanaForda st;
+    auto start = high_resolution_clock::now();
+    WynikOdleglosci wynik = obliczBellmanFordLista(graf, zrodlo, tryb, pula, &st);
+    auto stop = high_resolution_clock::now();
+
+    if (wynik.ujemnyCykl)
+    {
+        cout << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+
+    if (!symulacja)
+    {
+        Pisarz p(cout);
+        zapiszOdleglosci(p, wynik);
+    }
+
+    auto czas = duration_cast<milliseconds>(stop - start);
+    cout << "Czas wykonania algorytmu Bellmana-Forda (Lista, " << nazwaTrybuBellmanaForda(tryb) << "): "
+         << czas.count() << " milisekund\n";
+    cout << "Rundy: " << st.rundy << ", relaksacje: " << st.relaksacje << "\n\n";
+}
+
+struct StatystykiCzasu
+{
+    int64_t min = 0, mediana = 0, p95 = 0;
+    double srednia = 0, odchylenie = 0;
+};
+
+StatystykiCzasu policzStatystyki(vector<int64_t> czasy)
+{
+    StatystykiCzasu s;
+    if (czasy.empty())
+        return s;
+    sort(czasy.begin(), czasy.end());
+    size_t n = czasy.size();
+    s.min = czasy[0];
+    s.mediana = n % 2 ? czasy[n / 2] : (czasy[n / 2 - 1] + czasy[n / 2]) / 2;
+    s.p95 = czasy[(size_t)ceil(0.95 * n) - 1];
+    for (int64_t c : czasy)
+        s.srednia += c;
+    s.srednia /= n;
+    if (n > 1)
+    {
+        double suma = 0;
+        for (int64_t c : czasy)
+            suma += (c - s.srednia) * (c - s.srednia);
+        s.odchylenie = sqrt(suma / (n - 1));
+    }
+    return s;
+}
+
+// Pary wierzchołków dla zapytań punkt-punkt i struktury, które zapytania zachowują między
+// przebiegami. Jedne dla grafu, wspólne dla wszystkich wariantów.
+struct ZapytaniaBenchmarku
+{
+    vector<pair<int, int>> pary;
+    PunktyOrientacyjne punkty;
+    double czasPunktow = 0; // milisekundy budowy punktów orientacyjnych
+    PrzeszukiwanieDoCelu przod, tyl;
+};
+
+// Wszystko, czego potrzebuje pojedynczy przebieg algorytmu w benchmarku.
+struct DaneBenchmarku
+{
+    const GrafMacierz &gm;
+    const GrafCSR &gc;
+    int zrodlo;
+    PulaWatkow &pula;
+    int delta;
+    string &szczegoly;     // opcjonalny opis przebiegu (np. czasy faz), zapisywany w wynikach
+    ObszarRoboczy &obszar; // resetowany przed każdym przebiegiem, poza mierzonym czasem
+    ZapytaniaBenchmarku &zapytania;
+};
+
+// Jedna pozycja benchmarku: algorytm w danym wariancie na danej reprezentacji. Funkcja
+// zwraca sumę kontrolną wyniku (waga MST, suma osiągalnych odległości albo -1 przy ujemnym
+// cyklu), żeby kompilator nie mógł pominąć obliczeń i żeby dało się porównać warianty.
+// Algorytmy wielowątkowe są mierzone dla każdej liczby wątków z --watki. Opcjonalne
+// przygotuj jest wołane raz przed rozgrzewką i nie wlicza się do czasu.
+struct AlgorytmBenchmarku
+{
+    string nazwa;
+    string reprezentacja;
+    string wariant;
+    function<long long(const DaneBenchmarku &)> uruchom;
+    bool wielowatkowy = false;
+    function<void(const DaneBenchmarku &)> przygotuj;
+};
+
+long long sumaKontrolna(const WynikMST &wynik)
+{
+    return wynik.waga;
+}
+
+long long sumaKontrolna(const MacierzOdleglosci &wynik)
+{
+    if (wynik.ujemnyCykl)
+        return -1;
+    long long suma = 0;
+    for (int u = 0; u < wynik.pobierzV(); u++)
+        for (int v = 0; v < wynik.pobierzV(); v++)
+            if (wynik.odleglosc(u, v) != INT_MAX)
+                suma += wynik.odleglosc(u, v);
+    return suma;
+}
+
+long long sumaKontrolna(const WynikOdleglosci &wynik)
+{
+    if (wynik.ujemnyCykl)
+        return -1;
+    long long suma = 0;
+    for (int d : wynik.odleglosci)
+        if (d != INT_MAX)
+            suma += d;
+    return suma;
+}
+
+vector<AlgorytmBenchmarku> zbudujAlgorytmyBenchmarku()
+{
+    vector<AlgorytmBenchmarku> a = {
+        {"prim", "macierz", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczPrimMSTMacierz(d.gm, d.obszar)); }},
+        {"kruskal", "macierz", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczKruskalMSTMacierz(d.gm, d.obszar)); }},
+        {"kruskal", "lista", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczKruskalMSTLista(d.gc, d.obszar)); }},
+        {"dijkstra", "macierz", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczDijkstraMacierz(d.gm, d.zrodlo, d.obszar)); }},
+        {"bellman-ford", "macierz", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczBellmanFordMacierz(d.gm, d.zrodlo)); }},
+        {"bellman-ford", "lista", "podstawowy", [](const DaneBenchmarku &d)
+         { return sumaKontrolna(obliczBellmanFordLista(d.gc, d.zrodlo)); }},
+    };
+    for (RodzajKolejki r : {RodzajKolejki::Binarna, RodzajKolejki::DArna, RodzajKolejki::Parujaca, RodzajKolejki::Kubelkowa})
+    {
+        a.push_back({"prim", "lista", nazwaKolejki(r), [r](const DaneBenchmarku &d)
+                     { return sumaKontrolna(obliczPrimMSTLista(d.gc, d.obszar, r)); }});
+        a.push_back({"dijkstra", "lista", nazwaKolejki(r), [r](const DaneBenchmarku &d)
+                     { return sumaKontrolna(obliczDijkstraLista(d.gc, d.zrodlo, d.obszar, r)); }});
+    }
+    // Jądra wektorowe O(V^2) dla każdego zestawu instrukcji obsługiwanego przez procesor oraz
+    // podział każdego wiersza między wątki. Wariant z wątkami wymusza podział niezależnie od V
+    // (progWatkow = 0), żeby dało się zmierzyć, od jakiego rozmiaru się opłaca.
+    for (ZestawInstrukcji zestaw : {ZestawInstrukcji::Skalarny, ZestawInstrukcji::AVX2, ZestawInstrukcji::AVX512})
+    {
+        if (!czyObslugiwany(zestaw))
+            continue;
+        string wariant = string("jadro-") + nazwaZestawu(zestaw);
+        a.push_back({"prim", "macierz", wariant, [zestaw](const DaneBenchmarku &d)
+                     { return sumaKontrolna(obliczPrimMSTMacierzWektorowo(d.gm, d.obszar, {zestaw})); }});
+        a.push_back({"dijkstra", "macierz", wariant, [zestaw](const DaneBenchmarku &d)
+                     { return sumaKontrolna(obliczDijkstraMacierzWektorowo(d.gm, d.zrodlo, d.obszar, {zestaw})); }});
+    }
+    a.push_back({"prim", "macierz", "jadro-watki", [](const DaneBenchmarku &d)
+                 { return sumaKontrolna(obliczPrimMSTMacierzWektorowo(d.gm, d.obszar, {najlepszyZestawInstrukcji(), &d.pula, 0})); },
+                 true});
+    a.push_back({"dijkstra", "macierz", "jadro-watki", [](const DaneBenchmarku &d)
+                 { return sumaKontrolna(obliczDijkstraMacierzWektorowo(d.gm, d.zrodlo, d.obszar, {najlepszyZestawInstrukcji(), &d.pula, 0})); },
+                 true});
+    // Kruskal z sortowaniem pozycyjnym i filtrujący; w szczegółach liczby krawędzi posortowanych
+    // i odrzuconych bez sortowania oraz czasy faz.
+    for (TrybKruskala tryb : {TrybKruskala::Pozycyjny, TrybKruskala::Filtrujacy})
+    {
+        a.push_back({"kruskal", "macierz", nazwaTrybuKruskala(tryb), [tryb](const DaneBenchmarku &d)
+                     {
+                         StatystykiKruskala st;
+                         long long suma = sumaKontrolna(obliczKruskalMSTMacierz(d.gm, tryb, d.pula, &st));
+                         d.szczegoly = opiszStatystyki(st);
+                         return suma;
+                     },
+                     true});
+        a.push_back({"kruskal", "lista", nazwaTrybuKruskala(tryb), [tryb](const DaneBenchmarku &d)
+                     {
+                         StatystykiKruskala st;
+                         long long suma = sumaKontrolna(obliczKruskalMSTLista(d.gc, tryb, d.pula, &st));
+                         d.szczegoly = opiszStatystyki(st);
+                         return suma;
+                     },
+                     true});
+    }
+    // Mikrobenchmark zbiorów rozłącznych: łączenie wzdłuż wszystkich krawędzi grafu, w kolejności
+    // listy sąsiedztwa. Suma kontrolna to liczba udanych połączeń (V - liczba składowych).
+    a.push_back({"zbiory-rozlaczne", "lista", "dsu", [](const DaneBenchmarku &d)
+                 {
+                     WidokCSR g = d.gc;
+                     DSU dsu(g.pobierzV());
+                     long long polaczenia = 0;
+                     for (int u = 0; u < g.pobierzV(); u++)
+                         for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+                             if (u < g.sasiedzi[j] && dsu.znajdz(u) != dsu.znajdz(g.sasiedzi[j]))
+                             {
+                                 dsu.polacz(u, g.sasiedzi[j]);
+                                 polaczenia++;
+                             }
+                     return polaczenia;
+                 }});
+    a.push_back({"zbiory-rozlaczne", "lista", "rozmiar", [](const DaneBenchmarku &d)
+                 {
+                     WidokCSR g = d.gc;
+                     ZbiorRozlaczny zbiory(g.pobierzV());
+                     long long polaczenia = 0;
+                     for (int u = 0; u < g.pobierzV(); u++)
+                         for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+                             if (u < g.sasiedzi[j])
+                                 polaczenia += zbiory.polacz(u, g.sasiedzi[j]);
+                     return polaczenia;
+                 }});
+    a.push_back({"zbiory-rozlaczne", "lista", "wspolbiezny", [](const DaneBenchmarku &d)
+                 {
+                     WidokCSR g = d.gc;
+                     ZbiorRozlacznyWspolbiezny zbiory(g.pobierzV());
+                     vector<long long> polaczenia(d.pula.rozmiar(), 0);
+                     d.pula.dlaPrzedzialow(g.pobierzV(), [&](int t, int64_t od, int64_t doK)
+                                           {
+                         for (int u = (int)od; u < doK; u++)
+                             for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+                                 if (u < g.sasiedzi[j])
+                                     polaczenia[t] += zbiory.polacz(u, g.sasiedzi[j]); });
+                     long long suma = 0;
+                     for (long long p : polaczenia)
+                         suma += p;
+                     return suma;
+                 },
+                 true});
+    // Budowa dynamicznego MST i losowe usunięcia oraz ponowne dodania krawędzi (losoweZmianyMST);
+    // w szczegółach czas budowy i średni czas jednej zmiany.
+    a.push_back({"dynamiczne-mst", "lista", "1000-zmian", [](const DaneBenchmarku &d)
+                 {
+                     const int ZMIANY = 1000;
+                     auto t0 = steady_clock::now();
+                     DynamiczneMST mst(d.gc);
+                     auto t1 = steady_clock::now();
+                     mt19937_64 gen(12345);
+                     losoweZmianyMST(mst, d.gc, ZMIANY, gen);
+                     auto t2 = steady_clock::now();
+                     ostringstream opis;
+                     opis << fixed << setprecision(3) << "budowa_ms=" << duration<double, milli>(t1 - t0).count()
+                          << " zmiany=" << ZMIANY << " ns_na_zmiane=" << duration<double, nano>(t2 - t1).count() / ZMIANY;
+                     d.szczegoly = opis.str();
+                     return (long long)mst.calkowitaWaga();
+                 }});
+    // W szczegółach liczby składowych i krawędzi oraz czas każdej rundy.
+    a.push_back({"boruvka", "lista", "podstawowy", [](const DaneBenchmarku &d)
+                 {
+                     StatystykiBoruvki st;
+                     long long suma = sumaKontrolna(obliczBoruvkaMSTLista(d.gc, d.pula, &st));
+                     d.szczegoly = opiszStatystyki(st);
+                     return suma;
+                 },
+                 true});
+    // Punkt odniesienia dla Floyda-Warshalla: Dijkstra macierzowy z każdego wierzchołka.
+    a.push_back({"floyd-warshall", "macierz", "dijkstra-z-kazdego", [](const DaneBenchmarku &d)
+                 {
+                     long long suma = 0;
+                     for (int u = 0; u < d.gm.pobierzV(); u++)
+                     {
+                         d.obszar.resetuj();
+                         WynikOdleglosci w = obliczDijkstraMacierz(d.gm, u, d.obszar);
+                         for (int x : w.odleglosci)
+                             if (x != INT_MAX)
+                                 suma += x;
+                     }
+                     return suma;
+                 }});
+    a.push_back({"floyd-warshall", "macierz", "kafelkowy", [](const DaneBenchmarku &d)
+                 { return sumaKontrolna(obliczFloydWarshallMacierz(d.gm, d.pula)); },
+                 true});
+    // Johnson na tym samym grafie co Floyd-Warshall, więc sumy kontrolne są porównywalne.
+    a.push_back({"floyd-warshall", "lista", "johnson", [](const DaneBenchmarku &d)
+                 {
+                     StatystykiJohnsona st;
+                     long long suma = sumaKontrolna(obliczJohnsonLista(d.gc, d.pula, RodzajKolejki::Binarna, &st));
+                     d.szczegoly = opiszStatystyki(st);
+                     return suma;
+                 },
+                 true});
+    for (TrybBellmanaForda tryb : {TrybBellmanaForda::Rundy, TrybBellmanaForda::Kolejka, TrybBellmanaForda::Rownolegly})
+    {
+        a.push_back({"bellman-ford", "lista", nazwaTrybuBellmanaForda(tryb), [tryb](const DaneBenchmarku &d)
+                     {
+                         StatystykiBellmanaForda st;
+                         long long suma = sumaKontrolna(obliczBellmanFordLista(d.gc, d.zrodlo, tryb, d.pula, &st));
+                         d.szczegoly = "rundy=" + to_string(st.rundy) + " relaksacje=" + to_string(st.relaksacje);
+                         return suma;
+                     },
+                     tryb == TrybBellmanaForda::Rownolegly});
+    }
+    a.push_back({"dijkstra", "lista", "delta-stepping", [](const DaneBenchmarku &d)
+                 {
+                     StatystykiDeltaStepping st;
+                     long long suma = sumaKontrolna(obliczDeltaStepping(d.gc, d.zrodlo, d.pula, d.delta, &st));
+                     d.szczegoly = opiszStatystyki(st);
+                     return suma;
+                 },
+                 true});
+
+    // Partia Dijkstry ze źródeł wszystkich par z --zapytania na puli z kradzieżą pracy. Suma
+    // kontrolna to suma osiągalnych odległości ze wszystkich źródeł.
+    a.push_back({"dijkstra", "lista", "partia", [](const DaneBenchmarku &d)
+                 {
+                     vector<int> zrodla;
+                     for (auto para : d.zapytania.pary)
+                         zrodla.push_back(para.first);
+                     PartiaZapytan partia(d.pula);
+                     long long suma = 0;
+                     StatystykiPartii st = partia.wykonaj(d.gc, zrodla, RodzajKolejki::Binarna, [&](int64_t, const WynikOdleglosci &w, int64_t)
+                                                          { suma += sumaKontrolna(w); });
+                     d.szczegoly = opiszStatystyki(st);
+                     return suma;
+                 },
+                 true});
+
+    // Zapytania punkt-punkt: wszystkie pary z --zapytania w jednym przebiegu. Suma kontrolna to
+    // suma odległości osiągalnych celów; w szczegółach średnia liczba ustalonych wierzchołków.
+    auto zapytania = [](const DaneBenchmarku &d, auto &&zapytanie)
+    {
+        long long suma = 0;
+        int64_t ustalone = 0;
+        for (auto [zrodlo, cel] : d.zapytania.pary)
+        {
+            d.obszar.resetuj();
+            WynikZapytania w = zapytanie(zrodlo, cel);
+            if (w.odleglosc != INT_MAX)
+                suma += w.odleglosc;
+            ustalone += w.ustalone;
+        }
+        ostringstream opis;
+        opis << fixed << setprecision(1) << "zapytania=" << d.zapytania.pary.size()
+             << " ustalone_na_zapytanie=" << (double)ustalone / max<size_t>(d.zapytania.pary.size(), 1);
+        d.szczegoly = opis.str();
+        return suma;
+    };
+    a.push_back({"punkt-punkt", "lista", "pelny", [zapytania](const DaneBenchmarku &d)
+                 {
+                     return zapytania(d, [&](int zrodlo, int cel)
+                                      {
+                         WynikOdleglosci pelny = obliczDijkstraLista(d.gc, zrodlo, d.obszar);
+                         WynikZapytania w;
+                         w.zrodlo = zrodlo;
+                         w.cel = cel;
+                         w.odleglosc = pelny.odleglosci[cel];
+                         if (w.odleglosc != INT_MAX)
+                             w.sciezka = odtworzSciezke(pelny, cel);
+                         for (int x : pelny.odleglosci)
+                             w.ustalone += x != INT_MAX;
+                         return w; });
+                 }});
+    a.push_back({"punkt-punkt", "macierz", "do-celu", [zapytania](const DaneBenchmarku &d)
+                 {
+                     return zapytania(d, [&](int zrodlo, int cel)
+                                      { return obliczDijkstraMacierzDoCelu(d.gm, zrodlo, cel, d.obszar); });
+                 }});
+    a.push_back({"punkt-punkt", "lista", "do-celu", [zapytania](const DaneBenchmarku &d)
+                 {
+                     return zapytania(d, [&](int zrodlo, int cel)
+                                      { return obliczDijkstraDoCelu(d.gc, zrodlo, cel, d.zapytania.przod); });
+                 }});
+    a.push_back({"punkt-punkt", "lista", "dwukierunkowy", [zapytania](const DaneBenchmarku &d)
+                 {
+                     return zapytania(d, [&](int zrodlo, int cel)
+                                      { return obliczDijkstraDwukierunkowy(d.gc, zrodlo, cel, d.zapytania.przod, d.zapytania.tyl); });
+                 }});
+    a.push_back({"punkt-punkt", "lista", "alt", [zapytania](const DaneBenchmarku &d)
+                 {
+                     long long suma = zapytania(d, [&](int zrodlo, int cel)
+                                                { return obliczALT(d.gc, zrodlo, cel, d.zapytania.punkty, d.zapytania.przod); });
+                     ostringstream opis;
+                     opis << fixed << setprecision(3) << " punkty=" << d.zapytania.punkty.pobierzPunkty().size()
+                          << " przygotowanie_ms=" << d.zapytania.czasPunktow;
+                     d.szczegoly += opis.str();
+                     return suma;
+                 },
+                 false, [](const DaneBenchmarku &d)
+                 {
+                     const int PUNKTY = 8;
+                     auto t0 = steady_clock::now();
+                     d.zapytania.punkty = PunktyOrientacyjne(d.gc, PUNKTY);
+                     d.zapytania.czasPunktow = duration<double, milli>(steady_clock::now() - t0).count();
+                 }});
+    return a;
+}
+
+const vector<AlgorytmBenchmarku> &algorytmyBenchmarku()
+{
+    static const vector<AlgorytmBenchmarku> algorytmy = zbudujAlgorytmyBenchmarku();
+    return algorytmy;
+}
+
+struct KonfiguracjaBenchmarku
+{
+    vector<string> algorytmy = {"prim", "kruskal", "boruvka", "dijkstra", "bellman-ford", "floyd-warshall"};
+    vector<string> reprezentacje = {"macierz", "lista"};
+    vector<string> warianty; // puste - wszystkie
+    vector<int> wierzcholki = {100, 200, 400};
+    vector<double> gestosci = {25, 50, 75, 99};
+    int powtorzenia = 10;
+    int rozgrzewka = 2;
+    vector<uint64_t> ziarna = {42}; // każde ziarno daje osobny graf dla każdej pary (V, gęstość)
+    int watkiGeneratora = 1;
+    vector<int> watki = {1};
+    int delta = 0;
+    int zrodlo = 0;
+    SzerokoscWagi szerokosc = SzerokoscWagi::Int32; // typ wag w macierzy
+    int maksWaga = 1000;                            // wagi generatora to 1..maksWaga
+    int zapytania = 100;                            // pary wierzchołków w przebiegu punkt-punkt
+    string format = "csv";
+    string wyjscie;
+};
+
+struct WynikBenchmarku
+{
+    string algorytm, reprezentacja, wariant;
+    int watki;
+    int V;
+    double gestosc;
+    uint64_t ziarno;
+    int64_t E;
+    int powtorzenia;
+    StatystykiCzasu czas;
+    long long sumaKontrolna;
+    string szczegoly;
+    Liczniki liczniki;                                  // średnio na jeden pomiar
+    int64_t sprzetowe[LicznikiSprzetowe::LICZBA] = {}; // średnio na jeden pomiar, -1 - niedostępne
+    size_t bajtyGrafu = 0;
+    size_t bajtyRobocze = 0, bajtyKolejki = 0; // największe w jednym pomiarze
+    int64_t szczytowyRSS = -1;                 // kB, po pomiarach
+};
+
+// Kolumny liczników w kolejności wypisywania; -1 oznacza wartość niedostępną.
+vector<pair<const char *, int64_t>> kolumnyLicznikow(const WynikBenchmarku &w)
+{
+    const Liczniki &l = w.liczniki;
+    int64_t brak = GRAFY_LICZNIKI ? 0 : -1;
+    return {{"krawedzie", brak ? brak : l.krawedzie},
+            {"relaksacje", brak ? brak : l.relaksacje},
+            {"wstawienia", brak ? brak : l.wstawienia},
+            {"zdjecia", brak ? brak : l.zdjecia},
+            {"nieaktualne", brak ? brak : l.nieaktualne},
+            {"znajdz", brak ? brak : l.znajdz},
+            {"kroki_znajdz", brak ? brak : l.krokiZnajdz},
+            {"komorki", brak ? brak : l.komorki},
+            {"cykle", w.sprzetowe[0]},
+            {"instrukcje", w.sprzetowe[1]},
+            {"chybienia_cache", w.sprzetowe[2]},
+            {"chybienia_galezi", w.sprzetowe[3]},
+            {"pamiec_graf", (int64_t)w.bajtyGrafu},
+            {"pamiec_robocza", (int64_t)w.bajtyRobocze},
+            {"pamiec_kolejki", (int64_t)w.bajtyKolejki},
+            {"szczyt_rss_kb", w.szczytowyRSS}};
+}
+
+vector<string> podzielListe(const string &tekst)
+{
+    vector<string> elementy;
+    size_t poczatek = 0;
+    while (poczatek <= tekst.size())
+    {
+        size_t koniec = tekst.find(',', poczatek);
+        if (koniec == string::npos)
+            koniec = tekst.size();
+        if (koniec > poczatek)
+            elementy.push_back(tekst.substr(poczatek, koniec - poczatek));
+        poczatek = koniec + 1;
+    }
+    return elementy;
+}
+
+void wyswietlPomocBenchmarku()
+{
+    cerr << "Użycie: grafy bench [opcje]\n"
+         << "  --algorytm A[,B...]      prim, kruskal, boruvka, dijkstra, bellman-ford,\n"
+         << "                           floyd-warshall, zbiory-rozlaczne, dynamiczne-mst, punkt-punkt\n"
+         << "  --reprezentacja R[,...]  macierz, lista\n"
+         << "  --warianty W[,...]       np. binarna, 4-arna, parujaca, kubelkowa (domyślnie wszystkie)\n"
+         << "  --wierzcholki V[,...]    liczby wierzchołków\n"
+         << "  --gestosci G[,...]       gęstości w procentach\n"
+         << "  --powtorzenia N          liczba mierzonych powtórzeń\n"
+         << "  --rozgrzewka N           liczba niemierzonych przebiegów przed pomiarem\n"
+         << "  --ziarno S[,...]         ziarna generatora grafów (każde daje osobny graf)\n"
+         << "  --watki-generatora N     liczba wątków generatora grafów\n"
+         << "  --watki T[,...]          liczby wątków dla algorytmów wielowątkowych\n"
+         << "  --delta D                szerokość kubełka delta-stepping (0 - automatyczna)\n"
+         << "  --zrodlo S               wierzchołek źródłowy dla Dijkstry i Bellmana-Forda\n"
+         << "  --szerokosc 32|16|8      bity na wagę w macierzy (16 i 8 - bez wag ujemnych)\n"
+         << "  --maks-waga W            wagi generatora z zakresu 1..W (domyślnie 1000)\n"
+         << "  --zapytania N            pary wierzchołków w jednym przebiegu punkt-punkt (domyślnie 100)\n"
+         << "  --format csv|json        format wyników\n"
+         << "  --wyjscie PLIK           plik wyników (domyślnie standardowe wyjście)\n"
+         << "\nKolumny krawedzie..komorki to średnie liczniki operacji na pomiar (puste przy GRAFY_LICZNIKI=0).\n"
+         << "Kolumny cykle..chybienia_galezi pochodzą z perf_event_open, liczą tylko wątek wywołujący\n"
+         << "w trybie użytkownika i są puste, gdy liczniki sprzętowe są niedostępne.\n"
+         << "Kolumny pamiec_* podają bajty grafu, obszaru roboczego i kolejki w jednym pomiarze,\n"
+         << "a szczyt_rss_kb szczytowy RSS procesu po pomiarach.\n";
+}
+
+bool wczytajKonfiguracjeBenchmarku(int argc, char **argv, KonfiguracjaBenchmarku &k)
+{
+    try
+    {
+        for (int i = 0; i < argc; i++)
+        {
+            string opcja = argv[i];
+            if (opcja == "--pomoc" || opcja == "-h")
+                return false;
+            if (i + 1 >= argc)
+            {
+                cerr << "Brak wartości dla opcji " << opcja << "\n";
+                return false;
+            }
+            string wartosc = argv[++i];
+            if (opcja == "--algorytm")
+                k.algorytmy = podzielListe(wartosc);
+            else if (opcja == "--reprezentacja")
+                k.reprezentacje = podzielListe(wartosc);
+            else if (opcja == "--warianty")
+                k.warianty = podzielListe(wartosc);
+            else if (opcja == "--wierzcholki")
+            {
+                k.wierzcholki.clear();
+                for (const auto &e : podzielListe(wartosc))
+                    k.wierzcholki.push_back(stoi(e));
+            }
+            else if (opcja == "--gestosci")
+            {
+                k.gestosci.clear();
+                for (const auto &e : podzielListe(wartosc))
+                    k.gestosci.push_back(stod(e));
+            }
+            else if (opcja == "--powtorzenia")
+                k.powtorzenia = stoi(wartosc);
+            else if (opcja == "--rozgrzewka")
+                k.rozgrzewka = stoi(wartosc);
+            else if (opcja == "--ziarno")
+            {
+                k.ziarna.clear();
+                for (const auto &e : podzielListe(wartosc))
+                    k.ziarna.push_back(stoull(e));
+            }
+            else if (opcja == "--watki-generatora")
+                k.watkiGeneratora = stoi(wartosc);
+            else if (opcja == "--watki")
+            {
+                k.watki.clear();
+                for (const auto &e : podzielListe(wartosc))
+                    k.watki.push_back(stoi(e));
+            }
+            else if (opcja == "--delta")
+                k.delta = stoi(wartosc);
+            else if (opcja == "--zrodlo")
+                k.zrodlo = stoi(wartosc);
+            else if (opcja == "--szerokosc")
+            {
+                if (wartosc != "32" && wartosc != "16" && wartosc != "8")
+                {
+                    cerr << "Nieprawidłowa szerokość wag " << wartosc << "\n";
+                    return false;
+                }
+                k.szerokosc = wartosc == "8" ? SzerokoscWagi::UInt8 : wartosc == "16" ? SzerokoscWagi::UInt16 : SzerokoscWagi::Int32;
+            }
+            else if (opcja == "--maks-waga")
+                k.maksWaga = stoi(wartosc);
+            else if (opcja == "--zapytania")
+                k.zapytania = stoi(wartosc);
+            else if (opcja == "--format")
+                k.format = wartosc;
+            else if (opcja == "--wyjscie")
+                k.wyjscie = wartosc;
+            else
+            {
+                cerr << "Nieznana opcja " << opcja << "\n";
+                return false;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość liczbowa w opcjach\n";
+        return false;
+    }
+    bool watkiPoprawne = !k.watki.empty();
+    for (int t : k.watki)
+        watkiPoprawne = watkiPoprawne && t >= 1;
+    if (k.powtorzenia < 1 || k.rozgrzewka < 0 || !watkiPoprawne || k.ziarna.empty() || (k.format != "csv" && k.format != "json"))
+    {
+        cerr << "Nieprawidłowa liczba powtórzeń, rozgrzewek lub format\n";
+        return false;
+    }
+    int64_t maksDlaSzerokosci = zTypemWagi(k.szerokosc, [](auto t)
+                                          { return CechyWagi<decltype(t)>::MAKS; });
+    if (k.maksWaga < 1 || k.maksWaga > maksDlaSzerokosci)
+    {
+        cerr << "Największa waga musi być z zakresu 1.." << maksDlaSzerokosci << " dla wybranej szerokości wag\n";
+        return false;
+    }
+    for (const auto &a : k.algorytmy)
+    {
+        bool znany = false;
+        for (const auto &opis : algorytmyBenchmarku())
+            znany = znany || opis.nazwa == a;
+        if (!znany)
+        {
+            cerr << "Nieznany algorytm " << a << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void zapiszWynikiBenchmarku(ostream &out, const vector<WynikBenchmarku> &wyniki, const string &format)
+{
+    if (format == "csv")
+    {
+        out << "algorytm,reprezentacja,wariant,watki,V,gestosc,ziarno,E,powtorzenia,min_ns,mediana_ns,p95_ns,srednia_ns,odchylenie_ns,suma_kontrolna,szczegoly";
+        for (const auto &kolumna : kolumnyLicznikow(WynikBenchmarku()))
+            out << "," << kolumna.first;
+        out << "\n";
+        for (const auto &w : wyniki)
+        {
+            out << w.algorytm << "," << w.reprezentacja << "," << w.wariant << "," << w.watki << "," << w.V << "," << w.gestosc << "," << w.ziarno << "," << w.E << ","
+                << w.powtorzenia << "," << w.czas.min << "," << w.czas.mediana << "," << w.czas.p95 << ","
+                << fixed << setprecision(1) << w.czas.srednia << "," << w.czas.odchylenie << defaultfloat << setprecision(6) << ","
+                << w.sumaKontrolna << ",\"" << w.szczegoly << "\"";
+            for (const auto &kolumna : kolumnyLicznikow(w))
+            {
+                out << ",";
+                if (kolumna.second >= 0)
+                    out << kolumna.second;
+            }
+            out << "\n";
+        }
+        return;
+    }
+    out << "[\n";
+    for (size_t i = 0; i < wyniki.size(); i++)
+    {
+        const auto &w = wyniki[i];
+        out << "  {\"algorytm\": \"" << w.algorytm << "\", \"reprezentacja\": \"" << w.reprezentacja
+            << "\", \"wariant\": \"" << w.wariant << "\", \"watki\": " << w.watki << ", \"V\": " << w.V << ", \"gestosc\": " << w.gestosc << ", \"ziarno\": " << w.ziarno << ", \"E\": " << w.E
+            << ", \"powtorzenia\": " << w.powtorzenia << ", \"min_ns\": " << w.czas.min
+            << ", \"mediana_ns\": " << w.czas.mediana << ", \"p95_ns\": " << w.czas.p95
+            << fixed << setprecision(1) << ", \"srednia_ns\": " << w.czas.srednia
+            << ", \"odchylenie_ns\": " << w.czas.odchylenie << defaultfloat << setprecision(6)
+            << ", \"suma_kontrolna\": " << w.sumaKontrolna << ", \"szczegoly\": \"" << w.szczegoly << "\"";
+        for (const auto &kolumna : kolumnyLicznikow(w))
+        {
+            out << ", \"" << kolumna.first << "\": ";
+            if (kolumna.second >= 0)
+                out << kolumna.second;
+            else
+                out << "null";
+        }
+        out << "}" << (i + 1 < wyniki.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Rozgrzewka i pomiary jednego algorytmu; wypełnia wszystko poza parametrami grafu.
+WynikBenchmarku zmierzAlgorytm(const AlgorytmBenchmarku &algorytm, const GrafMacierz &gm, const GrafCSR &gc, int zrodlo,
+                               PulaWatkow &pula, ObszarRoboczy &obszar, ZapytaniaBenchmarku &zapytania,
+                               const KonfiguracjaBenchmarku &k)
+{
+    string szczegoly;
+    DaneBenchmarku d{gm, gc, zrodlo, pula, k.delta, szczegoly, obszar, zapytania};
+    if (algorytm.przygotuj)
+        algorytm.przygotuj(d);
+    long long suma = 0;
+    for (int i = 0; i < k.rozgrzewka; i++)
+    {
+        obszar.resetuj();
+        suma = algorytm.uruchom(d);
+    }
+
+    // Liczniki obejmują tylko pomiary, bez rozgrzewki; sprzętowe liczą wyłącznie ten wątek.
+    zerujLiczniki();
+    LicznikiSprzetowe sprzetowe;
+    int64_t sumySprzetowe[LicznikiSprzetowe::LICZBA] = {};
+    vector<int64_t> czasy;
+    size_t bajtyRobocze = 0, bajtyKolejki = 0;
+    for (int i = 0; i < k.powtorzenia; i++)
+    {
+        obszar.resetuj();
+        sprzetowe.start();
+        auto start = steady_clock::now();
+        suma = algorytm.uruchom(d);
+        auto stop = steady_clock::now();
+        sprzetowe.stop();
+        czasy.push_back(duration_cast<nanoseconds>(stop - start).count());
+        for (int j = 0; j < LicznikiSprzetowe::LICZBA; j++)
+            sumySprzetowe[j] += sprzetowe.odczytaj(j);
+        bajtyRobocze = max(bajtyRobocze, obszar.pobierzZajete());
+        bajtyKolejki = max(bajtyKolejki, obszar.pobierzBajtyKolejki());
+    }
+
+    WynikBenchmarku w;
+    w.algorytm = algorytm.nazwa;
+    w.reprezentacja = algorytm.reprezentacja;
+    w.wariant = algorytm.wariant;
+    w.powtorzenia = k.powtorzenia;
+    w.czas = policzStatystyki(czasy);
+    w.sumaKontrolna = suma;
+    w.szczegoly = szczegoly;
+
+    int64_t n = max(k.powtorzenia, 1);
+    Liczniki l = zbierzLiczniki();
+    w.liczniki.krawedzie = l.krawedzie / n;
+    w.liczniki.relaksacje = l.relaksacje / n;
+    w.liczniki.wstawienia = l.wstawienia / n;
+    w.liczniki.zdjecia = l.zdjecia / n;
+    w.liczniki.nieaktualne = l.nieaktualne / n;
+    w.liczniki.znajdz = l.znajdz / n;
+    w.liczniki.krokiZnajdz = l.krokiZnajdz / n;
+    w.liczniki.komorki = l.komorki / n;
+    for (int j = 0; j < LicznikiSprzetowe::LICZBA; j++)
+        w.sprzetowe[j] = sprzetowe.dostepny(j) ? sumySprzetowe[j] / n : -1;
+    w.bajtyGrafu = algorytm.reprezentacja == "macierz" ? gm.pobierzRozmiarBajtow() : WidokCSR(gc).pobierzRozmiarBajtow();
+    w.bajtyRobocze = bajtyRobocze;
+    w.bajtyKolejki = bajtyKolejki;
+    w.szczytowyRSS = szczytowyRSS();
+    return w;
+}
+
+bool wybranyDoBenchmarku(const AlgorytmBenchmarku &algorytm, const KonfiguracjaBenchmarku &k)
+{
+    auto zawiera = [](const vector<string> &lista, const string &x)
+    { return find(lista.begin(), lista.end(), x) != lista.end(); };
+    return zawiera(k.algorytmy, algorytm.nazwa) && zawiera(k.reprezentacje, algorytm.reprezentacja) &&
+           (k.warianty.empty() || zawiera(k.warianty, algorytm.wariant));
+}
+
+// Tryb nieinteraktywny: dla każdej pary (V, gęstość) generuje po jednym grafie z każdego ziarna,
+// a potem mierzy każdy wybrany algorytm na każdej wybranej reprezentacji. Mierzone jest
+// wyłącznie obliczenie - bez generowania grafu i bez wypisywania wyników.
+int trybBenchmarku(int argc, char **argv)
+{
+    KonfiguracjaBenchmarku k;
+    if (!wczytajKonfiguracjeBenchmarku(argc, argv, k))
+    {
+        wyswietlPomocBenchmarku();
+        return 1;
+    }
+
+    vector<WynikBenchmarku> wyniki;
+    for (int V : k.wierzcholki)
+    {
+        for (double gestosc : k.gestosci)
+        {
+            for (uint64_t ziarno : k.ziarna)
+            {
+                // budujemy tylko reprezentacje, które będą mierzone
+                bool potrzebnaMacierz = false, potrzebnaLista = false;
+                for (const auto &algorytm : algorytmyBenchmarku())
+                {
+                    if (wybranyDoBenchmarku(algorytm, k))
+                    {
+                        potrzebnaMacierz = potrzebnaMacierz || algorytm.reprezentacja == "macierz";
+                        potrzebnaLista = potrzebnaLista || algorytm.reprezentacja == "lista";
+                    }
+                }
+                GrafMacierz gm(0, UkladMacierzy::Pelna, k.szerokosc);
+                GrafCSR gc(0);
+                GeneratorGrafow(ziarno, k.watkiGeneratora, 1, k.maksWaga).generuj(V, gestosc, potrzebnaMacierz ? &gm : nullptr, nullptr, potrzebnaLista ? &gc : nullptr);
+                int zrodlo = min(k.zrodlo, V - 1);
+                ObszarRoboczy obszar; // wspólny dla wszystkich algorytmów na tym grafie
+                ZapytaniaBenchmarku zapytania;
+                mt19937_64 losowe(ziarno);
+                for (int i = 0; i < k.zapytania && V > 0; i++)
+                    zapytania.pary.push_back({(int)(losowe() % V), (int)(losowe() % V)});
+
+                for (const auto &nazwa : k.algorytmy)
+                {
+                    for (const auto &reprezentacja : k.reprezentacje)
+                    {
+                        for (const auto &algorytm : algorytmyBenchmarku())
+                        {
+                            if (algorytm.nazwa != nazwa || algorytm.reprezentacja != reprezentacja ||
+                                !wybranyDoBenchmarku(algorytm, k))
+                                continue;
+
+                            for (int watki : k.watki)
+                            {
+                                if (!algorytm.wielowatkowy && watki != k.watki[0])
+                                    continue;
+                                if (!algorytm.wielowatkowy)
+                                    watki = 1;
+                                cerr << nazwa << " (" << reprezentacja << ", " << algorytm.wariant << ", " << watki
+                                     << " wątków) V=" << V << " gestosc=" << gestosc << " ziarno=" << ziarno << "\n";
+                                PulaWatkow pula(watki);
+                                WynikBenchmarku w = zmierzAlgorytm(algorytm, gm, gc, zrodlo, pula, obszar, zapytania, k);
+                                w.watki = watki;
+                                w.V = V;
+                                w.gestosc = gestosc;
+                                w.ziarno = ziarno;
+                                w.E = GeneratorGrafow::liczbaKrawedzi(V, gestosc);
+                                wyniki.push_back(w);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (k.wyjscie.empty())
+    {
+        zapiszWynikiBenchmarku(cout, wyniki, k.format);
+    }
+    else
+    {
+        ofstream plik(k.wyjscie);
+        if (!plik)
+        {
+            cerr << "Nie można otworzyć pliku " << k.wyjscie << endl;
+            return 1;
+        }
+        zapiszWynikiBenchmarku(plik, wyniki, k.format);
+    }
+    return 0;
+}
+
+// Wiersze pliku JSON zapisanego przez zapiszWynikiBenchmarku: jeden obiekt na linię, wartości
+// bez znaków cudzysłowu w środku. Każdy wiersz to pary klucz - wartość w postaci tekstowej.
+bool wczytajWynikiJSON(const string &nazwa, vector<unordered_map<string, string>> &wiersze)
+{
+    ifstream plik(nazwa);
+    if (!plik)
+    {
+        cerr << "Nie można otworzyć pliku " << nazwa << endl;
+        return false;
+    }
+    string linia;
+    while (getline(plik, linia))
+    {
+        size_t i = linia.find('{');
+        if (i == string::npos)
+            continue;
+        unordered_map<string, string> wiersz;
+        while ((i = linia.find('"', i)) != string::npos)
+        {
+            size_t koniecKlucza = linia.find('"', i + 1);
+            size_t dwukropek = linia.find(':', koniecKlucza);
+            if (koniecKlucza == string::npos || dwukropek == string::npos)
+                break;
+            string klucz = linia.substr(i + 1, koniecKlucza - i - 1);
+            size_t poczatek = linia.find_first_not_of(' ', dwukropek + 1), koniec;
+            if (poczatek == string::npos)
+                break;
+            if (linia[poczatek] == '"')
+            {
+                koniec = linia.find('"', poczatek + 1);
+                if (koniec == string::npos)
+                    break;
+                wiersz[klucz] = linia.substr(poczatek + 1, koniec - poczatek - 1);
+                koniec++;
+            }
+            else
+            {
+                koniec = linia.find_first_of(",}", poczatek);
+                if (koniec == string::npos)
+                    koniec = linia.size();
+                wiersz[klucz] = linia.substr(poczatek, koniec - poczatek);
+            }
+            i = koniec;
+        }
+        wiersze.push_back(wiersz);
+    }
+    return true;
+}
+
+// Jednostronna wartość p dla statystyki t o df stopniach swobody; t jest sprowadzane do rozkładu
+// normalnego przybliżeniem Wallace'a, dokładnym do kilku procent wartości p już od df = 3.
+double wartoscPStudenta(double t, double df)
+{
+    double z = sqrt(df * log1p(t * t / df)) * (8 * df + 1) / (8 * df + 3);
+    return 0.5 * erfc((t < 0 ? -z : z) / sqrt(2.0));
+}
+
+// Porównanie przebiegu benchmarku z zapisaną bazą. Wiersze są parowane po algorytmie, reprezentacji,
+// wariancie, wątkach, V, gęstości i ziarnie. Spowolnienie jest zgłaszane, gdy test t Welcha na
+// średnich daje p < alfa, a mediana wzrosła o więcej niż prog procent; poprawa - symetrycznie.
+// Inna suma kontrolna oznacza inny wynik algorytmu i też jest błędem.
+int trybPorownania(int argc, char **argv)
+{
+    const char *UZYCIE = "Użycie: grafy porownaj BAZA.json WYNIKI.json [--prog PROCENT] [--alfa A]\n"
+                         "Kod wyjścia 2 oznacza istotne spowolnienie albo inną sumę kontrolną.\n";
+    if (argc < 2 || argc % 2 != 0)
+    {
+        cerr << UZYCIE;
+        return 1;
+    }
+    double prog = 5, alfa = 0.01;
+    try
+    {
+        for (int i = 2; i < argc; i += 2)
+        {
+            string opcja = argv[i], wartosc = argv[i + 1];
+            if (opcja == "--prog")
+                prog = stod(wartosc);
+            else if (opcja == "--alfa")
+                alfa = stod(wartosc);
+            else
+            {
+                cerr << "Nieznana opcja " << opcja << "\n"
+                     << UZYCIE;
+                return 1;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość liczbowa w opcjach\n";
+        return 1;
+    }
+    if (prog < 0 || alfa <= 0 || alfa >= 1)
+    {
+        cerr << "Próg musi być nieujemny, a alfa z przedziału (0, 1)\n";
+        return 1;
+    }
+
+    vector<unordered_map<string, string>> baza, biezace;
+    if (!wczytajWynikiJSON(argv[0], baza) || !wczytajWynikiJSON(argv[1], biezace))
+        return 1;
+    auto klucz = [](unordered_map<string, string> &w)
+    {
+        return w["algorytm"] + "/" + w["reprezentacja"] + "/" + w["wariant"] + " watki=" + w["watki"] + " V=" + w["V"] +
+               " gestosc=" + w["gestosc"] + " ziarno=" + w["ziarno"];
+    };
+    auto liczba = [](unordered_map<string, string> &w, const char *pole)
+    {
+        auto it = w.find(pole);
+        return it == w.end() || it->second == "null" ? 0.0 : atof(it->second.c_str());
+    };
+    unordered_map<string, unordered_map<string, string> *> wBazie;
+    for (auto &w : baza)
+        wBazie[klucz(w)] = &w;
+
+    int spowolnienia = 0, poprawy = 0, inneWyniki = 0, porownane = 0;
+    unordered_map<string, bool> sparowane;
+    cout << fixed << setprecision(1);
+    for (auto &w : biezace)
+    {
+        string k = klucz(w);
+        auto it = wBazie.find(k);
+        if (it == wBazie.end())
+        {
+            cout << "NOWY       " << k << "\n";
+            continue;
+        }
+        unordered_map<string, string> &b = *it->second;
+        sparowane[k] = true;
+        porownane++;
+
+        double nb = max(liczba(b, "powtorzenia"), 1.0), nc = max(liczba(w, "powtorzenia"), 1.0);
+        double mb = liczba(b, "srednia_ns"), mc = liczba(w, "srednia_ns");
+        double vb = pow(liczba(b, "odchylenie_ns"), 2) / nb, vc = pow(liczba(w, "odchylenie_ns"), 2) / nc;
+        double medianaB = liczba(b, "mediana_ns"), medianaC = liczba(w, "mediana_ns");
+        double zmiana = medianaB > 0 ? 100 * (medianaC / medianaB - 1) : 0;
+        // test t Welcha; przy zerowej wariancji (jedno powtórzenie) rozstrzyga sama różnica median
+        double p = 1;
+        if (vb + vc > 0)
+        {
+            double t = (mc - mb) / sqrt(vb + vc);
+            double df = (vb + vc) * (vb + vc) /
+                        ((nb > 1 ? vb * vb / (nb - 1) : 0) + (nc > 1 ? vc * vc / (nc - 1) : 0) + 1e-300);
+            p = wartoscPStudenta(fabs(t), max(df, 1.0));
+        }
+        else if (mc != mb)
+            p = 0;
+
+        string stan = "bez zmian";
+        if (b["suma_kontrolna"] != w["suma_kontrolna"])
+        {
+            stan = "INNY WYNIK";
+            inneWyniki++;
+        }
+        else if (p < alfa && zmiana > prog && mc > mb)
+        {
+            stan = "WOLNIEJ";
+            spowolnienia++;
+        }
+        else if (p < alfa && zmiana < -prog && mc < mb)
+        {
+            stan = "szybciej";
+            poprawy++;
+        }
+        cout << left << setw(11) << stan << right << k << "  mediana " << medianaB << " -> " << medianaC << " ns ("
+             << showpos << zmiana << noshowpos << "%) p=" << setprecision(4) << p << setprecision(1) << "\n";
+    }
+    for (auto &b : baza)
+        if (!sparowane.count(klucz(b)))
+            cout << "BRAK       " << klucz(b) << "\n";
+    cout << "Porównane: " << porownane << ", wolniej: " << spowolnienia << ", szybciej: " << poprawy
+         << ", inny wynik: " << inneWyniki << " (próg " << prog << "%, alfa " << defaultfloat << alfa << ")\n";
+    return spowolnienia || inneWyniki ? 2 : 0;
+}
+
+// Lista źródeł w postaci "0,5,7", "10-20" (przedziały domknięte, można łączyć z pojedynczymi)
+// albo "wszystkie". Zwraca false przy błędzie składni lub wierzchołku spoza grafu.
+bool wczytajZrodla(const string &tekst, int V, vector<int> &zrodla)
+{
+    zrodla.clear();
+    if (tekst == "wszystkie")
+    {
+        for (int v = 0; v < V; v++)
+            zrodla.push_back(v);
+        return true;
+    }
+    try
+    {
+        for (const auto &element : podzielListe(tekst))
+        {
+            size_t kreska = element.find('-', 1);
+            int od = stoi(element.substr(0, kreska));
+            int doW = kreska == string::npos ? od : stoi(element.substr(kreska + 1));
+            if (od < 0 || doW >= V || od > doW)
+                return false;
+            for (int v = od; v <= doW; v++)
+                zrodla.push_back(v);
+        }
+    }
+    catch (const exception &)
+    {
+        return false;
+    }
+    return !zrodla.empty();
+}
+
+// Dijkstra z wielu źródeł naraz; wyniki są wypisywane do wyjscie w miarę kończenia zapytań,
+// a na końcu do raport przepustowość i percentyle opóźnień.
+void dijkstraWieluZrodel(WidokCSR graf, const vector<int> &zrodla, int watki, RodzajKolejki rodzaj, ostream &wyjscie,
+                         ostream &raport, bool binarnie, bool symulacja = false)
+{
+    PulaWatkow pula(watki);
+    PartiaZapytan partia(pula);
+    Pisarz p(wyjscie);
+    StatystykiPartii st = partia.wykonaj(graf, zrodla, rodzaj, [&](int64_t, const WynikOdleglosci &wynik, int64_t)
+                                         {
+        if (symulacja)
+            return;
+        if (binarnie)
+            zapiszBinarnie(p, wynik);
+        else
+            zapiszOdleglosci(p, wynik);
+        p.oproznij(); });
+    p.oproznij();
+    wyjscie.flush();
+    raport << "Partia Dijkstry (" << nazwaKolejki(rodzaj) << "): " << opiszStatystyki(st) << "\n";
+    raport << "Pamięć: obszary robocze wątków " << partia.pobierzRozmiarBajtow() << " B, szczytowy RSS " << szczytowyRSS()
+           << " kB\n";
+}
+
+bool wczytajRodzajKolejki(const string &nazwa, RodzajKolejki &rodzaj)
+{
+    for (RodzajKolejki r : {RodzajKolejki::Binarna, RodzajKolejki::DArna, RodzajKolejki::Parujaca, RodzajKolejki::Kubelkowa})
+        if (nazwa == nazwaKolejki(r))
+        {
+            rodzaj = r;
+            return true;
+        }
+    return false;
+}
+
+
+// Wczytuje graf raz i liczy odległości z listy źródeł na puli wątków.
+int trybWieluZrodel(int argc, char **argv)
+{
+    const char *UZYCIE = "Użycie: grafy zrodla PLIK --zrodla LISTA [--watki N] [--kolejka binarna|4-arna|parujaca|kubelkowa]\n"
+                         "                   [--wyjscie PLIK] [--binarnie 0|1]\n"
+                         "LISTA to np. 0,5,7 albo 0-99 albo wszystkie.\n";
+    if (argc < 1 || argc % 2 != 1)
+    {
+        cerr << UZYCIE;
+        return 1;
+    }
+    string listaZrodel, plikWyjscia;
+    int watki = (int)max(1u, thread::hardware_concurrency());
+    bool binarnie = false;
+    RodzajKolejki rodzaj = RodzajKolejki::Binarna;
+    try
+    {
+        for (int i = 1; i < argc; i += 2)
+        {
+            string opcja = argv[i], wartosc = argv[i + 1];
+            if (opcja == "--zrodla")
+                listaZrodel = wartosc;
+            else if (opcja == "--watki")
+                watki = max(stoi(wartosc), 1);
+            else if (opcja == "--wyjscie")
+                plikWyjscia = wartosc;
+            else if (opcja == "--binarnie")
+                binarnie = stoi(wartosc) != 0;
+            else if (opcja == "--kolejka")
+            {
+                if (!wczytajRodzajKolejki(wartosc, rodzaj))
+                {
+                    cerr << "Nieznana kolejka " << wartosc << "\n" << UZYCIE;
+                    return 1;
+                }
+            }
+            else
+            {
+                cerr << "Nieznana opcja " << opcja << "\n" << UZYCIE;
+                return 1;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość opcji\n" << UZYCIE;
+        return 1;
+    }
+
+    auto start = steady_clock::now();
+    GrafCSR gc;
+    wczytajGraf(argv[0], nullptr, &gc);
+    cerr << "Wczytano graf (V = " << gc.pobierzV() << ") w "
+         << duration_cast<milliseconds>(steady_clock::now() - start).count() << " milisekund\n";
+    vector<int> zrodla;
+    if (!wczytajZrodla(listaZrodel, gc.pobierzV(), zrodla))
+    {
+        cerr << "Nieprawidłowa lista źródeł\n" << UZYCIE;
+        return 1;
+    }
+    if (plikWyjscia.empty())
+    {
+        dijkstraWieluZrodel(gc, zrodla, watki, rodzaj, cout, cerr, binarnie);
+        return 0;
+    }
+    ofstream plik(plikWyjscia, binarnie ? ios::binary : ios::out);
+    if (!plik)
+    {
+        cerr << "Nie można otworzyć pliku " << plikWyjscia << "\n";
+        return 1;
+    }
+    dijkstraWieluZrodel(gc, zrodla, watki, rodzaj, plik, cerr, binarnie);
+    return 0;
+}
+
+// Odległości między wszystkimi parami algorytmem Johnsona dla grafu z pliku.
+int trybJohnsona(int argc, char **argv)
+{
+    const char *UZYCIE = "Użycie: grafy johnson PLIK [--watki N] [--kolejka binarna|4-arna|parujaca|kubelkowa]\n"
+                         "                    [--wyjscie PLIK] [--binarnie 0|1] [--skierowany 0|1] [--budzet MB]\n"
+                         "Macierz odległości powstaje, gdy 4 * V^2 bajtów mieści się w budżecie (domyślnie 1024 MB);\n"
+                         "inaczej odległości z kolejnych źródeł są wypisywane w miarę liczenia.\n";
+    if (argc < 1 || argc % 2 != 1)
+    {
+        cerr << UZYCIE;
+        return 1;
+    }
+    string plikWyjscia;
+    int watki = (int)max(1u, thread::hardware_concurrency());
+    bool binarnie = false, skierowany = false;
+    int64_t budzet = DOMYSLNY_BUDZET_JOHNSONA;
+    RodzajKolejki rodzaj = RodzajKolejki::Binarna;
+    try
+    {
+        for (int i = 1; i < argc; i += 2)
+        {
+            string opcja = argv[i], wartosc = argv[i + 1];
+            if (opcja == "--watki")
+                watki = max(stoi(wartosc), 1);
+            else if (opcja == "--wyjscie")
+                plikWyjscia = wartosc;
+            else if (opcja == "--binarnie")
+                binarnie = stoi(wartosc) != 0;
+            else if (opcja == "--skierowany")
+                skierowany = stoi(wartosc) != 0;
+            else if (opcja == "--budzet")
+                budzet = stoll(wartosc) << 20;
+            else if (opcja == "--kolejka")
+            {
+                if (!wczytajRodzajKolejki(wartosc, rodzaj))
+                {
+                    cerr << "Nieznana kolejka " << wartosc << "\n" << UZYCIE;
+                    return 1;
+                }
+            }
+            else
+            {
+                cerr << "Nieznana opcja " << opcja << "\n" << UZYCIE;
+                return 1;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość opcji\n" << UZYCIE;
+        return 1;
+    }
+
+    auto start = steady_clock::now();
+    GrafCSR gc;
+    wczytajGraf(argv[0], nullptr, &gc, skierowany);
+    cerr << "Wczytano graf (V = " << gc.pobierzV() << ", łuki = " << gc.pobierzLiczbeSasiadow() << ") w "
+         << duration_cast<milliseconds>(steady_clock::now() - start).count() << " milisekund\n";
+    if (plikWyjscia.empty())
+    {
+        johnsonLista(gc, watki, rodzaj, cout, cerr, binarnie, budzet);
+        return 0;
+    }
+    ofstream plik(plikWyjscia, binarnie ? ios::binary : ios::out);
+    if (!plik)
+    {
+        cerr << "Nie można otworzyć pliku " << plikWyjscia << "\n";
+        return 1;
+    }
+    johnsonLista(gc, watki, rodzaj, plik, cerr, binarnie, budzet);
+    return 0;
+}
+
+// Plik z kalibracją modelu kosztów trybu automatycznego, domyślnie w katalogu bieżącym.
+const char *DOMYSLNY_PLIK_KALIBRACJI = "grafy_kalibracja.txt";
+
+// Wczytuje kalibrację z pliku, a gdy jej nie ma, jest z innej maszyny albo kalibruj jest
+// ustawione - mierzy ją od nowa i zapisuje do tego pliku.
+bool przygotujModelKosztow(ModelKosztow &model, const string &plik, bool kalibruj, ostream &raport)
+{
+    if (!kalibruj && model.wczytaj(plik))
+    {
+        raport << "Model kosztów: wczytano kalibrację z " << plik << "\n";
+        return true;
+    }
+    raport << "Model kosztów: kalibracja na tej maszynie...\n";
+    auto start = steady_clock::now();
+    model.kalibruj();
+    raport << "Model kosztów: skalibrowano w " << duration_cast<milliseconds>(steady_clock::now() - start).count()
+           << " milisekund";
+    if (model.zapisz(plik))
+        raport << ", zapisano do " << plik << "\n";
+    else
+        raport << ", nie można zapisać do " << plik << "\n";
+    return !model.pusty();
+}
+
+string opiszOcene(const OcenaAuto &o)
+{
+    return o.algorytm + (o.macierz ? string(" (Macierz, ") + nazwaSzerokosci(o.szerokosc) + "-bitowe wagi)" : string(" (Lista)"));
+}
+
+// Tryb automatyczny: model kosztów wybiera algorytm i reprezentację, zbuduj(ocena) buduje w gm
+// albo gc tylko tę reprezentację, a wynik trafia do wyjscie. Do raport trafiają oceny
+// wszystkich kandydatów i czasy przewidywane obok rzeczywistych.
+template <typename Zbuduj>
+void wykonajAutomatycznie(const ModelKosztow &model, ZadanieAuto zadanie, const CechyGrafu &cechy,
+                          const GotoweReprezentacje &gotowe, int zrodlo, GrafMacierz &gm, GrafCSR &gc, Zbuduj &&zbuduj,
+                          ObszarRoboczy &obszar, ostream &wyjscie, ostream &raport, bool symulacja = false)
+{
+    vector<OcenaAuto> oceny = ocenKandydatow(model, zadanie, cechy, gotowe);
+    if (oceny.empty())
+    {
+        raport << "Model kosztów nie zna żadnego kandydata - potrzebna nowa kalibracja\n";
+        return;
+    }
+    raport << fixed << setprecision(3) << "Graf: V = " << cechy.V << ", E = " << cechy.E << ", wagi " << cechy.minWaga
+           << ".." << cechy.maksWaga << "\nKandydaci (przewidywana budowa + obliczenie):\n";
+    for (const auto &o : oceny)
+        raport << "  " << opiszOcene(o) << ": " << o.budowa / 1e6 << " + " << o.obliczenie / 1e6 << " ms\n";
+    const OcenaAuto &wybor = oceny[0];
+    raport << "Wybór: " << opiszOcene(wybor) << "\n";
+
+    auto start = steady_clock::now();
+    zbuduj(wybor);
+    double budowa = duration<double, nano>(steady_clock::now() - start).count();
+    if (wybor.budowa > 0)
+        raport << "Budowa reprezentacji: przewidywana " << wybor.budowa / 1e6 << " ms, rzeczywista " << budowa / 1e6
+               << " ms\n";
+
+    WynikMST mst;
+    WynikOdleglosci odleglosci;
+    obszar.resetuj();
+    start = steady_clock::now();
+    wykonajAlgorytmAuto(wybor.algorytm, wybor.macierz, gm, gc, zrodlo, obszar, mst, odleglosci);
+    double obliczenie = duration<double, nano>(steady_clock::now() - start).count();
+    raport << "Obliczenie: przewidywane " << wybor.obliczenie / 1e6 << " ms, rzeczywiste " << obliczenie / 1e6
+           << " ms (rzeczywiste / przewidywane = " << setprecision(2) << obliczenie / wybor.obliczenie << ")\n"
+           << defaultfloat << setprecision(6);
+    raport.flush();
+
+    if (odleglosci.ujemnyCykl)
+    {
+        wyjscie << "Graf zawiera cykl o ujemnej wadze!\n";
+        return;
+    }
+    if (symulacja)
+        return;
+    Pisarz p(wyjscie);
+    if (zadanie == ZadanieAuto::MST)
+    {
+        p << "Całkowita waga MST: " << mst.waga << "\nLista sąsiedztwa MST:\n";
+        zapiszKrawedzieMST(p, mst);
+    }
+    else
+        zapiszOdleglosci(p, odleglosci);
+}
+
+// Wczytuje graf z pliku, wybiera algorytm modelem kosztów i buduje tylko potrzebną reprezentację.
+// Plik tekstowy jest czytany do listy krawędzi, z której powstaje wybrana reprezentacja;
+// plik binarny jest już listą (odwzorowaną w pamięci), więc macierz powstaje z niej.
+int trybAutomatyczny(int argc, char **argv)
+{
+    const char *UZYCIE = "Użycie: grafy auto PLIK [--zadanie mst|odleglosci] [--zrodlo S] [--wyjscie PLIK]\n"
+                         "                 [--kalibracja PLIK] [--kalibruj 0|1]\n"
+                         "Kalibracja modelu kosztów jest zapisywana w pliku (domyślnie grafy_kalibracja.txt)\n"
+                         "i mierzona od nowa, gdy go brak, pochodzi z innego procesora albo --kalibruj 1.\n";
+    if (argc < 1 || argc % 2 != 1)
+    {
+        cerr << UZYCIE;
+        return 1;
+    }
+    string plikWyjscia, plikKalibracji = DOMYSLNY_PLIK_KALIBRACJI;
+    ZadanieAuto zadanie = ZadanieAuto::MST;
+    int zrodlo = 0;
+    bool kalibruj = false;
+    try
+    {
+        for (int i = 1; i < argc; i += 2)
+        {
+            string opcja = argv[i], wartosc = argv[i + 1];
+            if (opcja == "--zadanie" && (wartosc == "mst" || wartosc == "odleglosci"))
+                zadanie = wartosc == "mst" ? ZadanieAuto::MST : ZadanieAuto::Odleglosci;
+            else if (opcja == "--zrodlo")
+                zrodlo = stoi(wartosc);
+            else if (opcja == "--wyjscie")
+                plikWyjscia = wartosc;
+            else if (opcja == "--kalibracja")
+                plikKalibracji = wartosc;
+            else if (opcja == "--kalibruj")
+                kalibruj = stoi(wartosc) != 0;
+            else
+            {
+                cerr << "Nieznana opcja lub wartość " << opcja << " " << wartosc << "\n" << UZYCIE;
+                return 1;
+            }
+        }
+    }
+    catch (const exception &)
+    {
+        cerr << "Nieprawidłowa wartość opcji\n" << UZYCIE;
+        return 1;
+    }
+
+    ModelKosztow model;
+    if (!przygotujModelKosztow(model, plikKalibracji, kalibruj, cerr))
+        return 1;
+
+    auto start = steady_clock::now();
+    GrafCSR gc(0);
+    GrafMacierz gm(0);
+    vector<Krawedz> krawedzie;
+    GotoweReprezentacje gotowe;
+    CechyGrafu cechy;
+    if (czyGrafBinarny(argv[0]))
+    {
+        gc.wczytajBinarnie(argv[0]);
+        gotowe.lista = true;
+        cechy = cechyGrafu(gc);
+    }
+    else
+        cechy = cechyGrafu(wczytajKrawedzie(argv[0], krawedzie), krawedzie);
+    cerr << "Wczytano graf w " << duration_cast<milliseconds>(steady_clock::now() - start).count() << " milisekund\n";
+    if (zrodlo < 0 || zrodlo >= max(cechy.V, 1))
+    {
+        cerr << "Nieprawidłowy wierzchołek źródłowy " << zrodlo << "\n";
+        return 1;
+    }
+
+    auto zbuduj = [&](const OcenaAuto &wybor)
+    {
+        if (wybor.macierz)
+        {
+            gm = GrafMacierz(0, UkladMacierzy::Pelna, wybor.szerokosc);
+            if (gotowe.lista)
+                zbudujMacierzZCSR(gc, gm);
+            else
+            {
+                gm = GrafMacierz(cechy.V, UkladMacierzy::Pelna, wybor.szerokosc);
+                for (const auto &k : krawedzie)
+                    gm.dodajKrawedz(k.u, k.v, k.waga);
+            }
+        }
+        else if (!gotowe.lista)
+            gc.zbudujZKrawedzi(cechy.V, krawedzie);
+        vector<Krawedz>().swap(krawedzie);
+    };
+    ObszarRoboczy obszar;
+    if (plikWyjscia.empty())
+    {
+        wykonajAutomatycznie(model, zadanie, cechy, gotowe, zrodlo, gm, gc, zbuduj, obszar, cout, cerr);
+        return 0;
+    }
+    ofstream plik(plikWyjscia);
+    if (!plik)
+    {
+        cerr << "Nie można otworzyć pliku " << plikWyjscia << "\n";
+        return 1;
+    }
+    wykonajAutomatycznie(model, zadanie, cechy, gotowe, zrodlo, gm, gc, zbuduj, obszar, plik, cerr);
+    return 0;
+}
+
+// Dane jednej próby trybu symulacji.
+struct GrafProby
+{
+    GrafMacierz gm{0};
+    GrafCSR gc{0};
+};
+
+// Próby trybu symulacji dla opcji 4-7: losowe grafy o parametrach z opcji 2 i formacie macierzy
+// wzor powstają w tle, a zmierz(graf, obszar, wyjscie) liczy je według harmonogramu z opcji 21.
+template <typename F>
+void wykonajProby(KonfiguracjaProb konfiguracja, int liczbaProb, int V, double gestosc, const GrafMacierz &wzor, F &&zmierz)
+{
+    konfiguracja.proby = liczbaProb;
+    HarmonogramProb<GrafProby> harmonogram(konfiguracja);
+    StatystykiProb st = harmonogram.wykonaj(
+        [&](int, GrafProby &g)
+        {
+            if (g.gm.pobierzUklad() != wzor.pobierzUklad() || g.gm.pobierzSzerokosc() != wzor.pobierzSzerokosc())
+                g.gm = GrafMacierz(0, wzor.pobierzUklad(), wzor.pobierzSzerokosc());
+            generujLosowyGraf(V, gestosc, g.gm, g.gc);
+        },
+        [&](int, const GrafProby &g, ObszarRoboczy &obszar, ostream &wyjscie)
+        { zmierz(g, obszar, wyjscie); },
+        cout);
+    cout << "Harmonogram prób: " << opiszStatystyki(st) << "\n";
+}
+
+void wyswietlMenu()
+{
+    cout << "Menu:\n";
+    cout << "1. Wczytaj dane z pliku\n";
+    cout << "2. Wygeneruj graf losowo\n";
+    cout << "3. Wyświetl graf listowo i macierzowo\n";
+    cout << "4. Algorytm Prima (macierzowo i listowo) z wyświetleniem wyników\n";
+    cout << "5. Algorytm Kruskala (macierzowo i listowo) z wyświetleniem wyników\n";
+    cout << "6. Algorytm Dijkstry (macierzowo i listowo) z wyświetleniem wyników\n";
+    cout << "7. Algorytm Bellmana-Forda (macierzowo i listowo) z wyświetleniem wyników\n";
+    cout << "8. Tryb symulacji\n";
+    cout << "9. Wyjście\n";
+    cout << "10. Format macierzy sąsiedztwa (układ i szerokość wag)\n";
+    cout << "11. Kolejka priorytetowa Prima i Dijkstry (listowo)\n";
+    cout << "12. Algorytm Dijkstry równolegle (delta-stepping, listowo)\n";
+    cout << "13. Algorytm Bellmana-Forda z wczesnym zakończeniem (listowo)\n";
+    cout << "14. Algorytm Kruskala równolegle (sortowanie pozycyjne lub filter-Kruskal)\n";
+    cout << "15. Algorytm Borůvki równolegle (listowo)\n";
+    cout << "16. Odległości między wszystkimi parami (Floyd-Warshall, macierzowo)\n";
+    cout << "17. Dynamiczne MST (dodawanie, usuwanie i zmiana wag krawędzi, listowo)\n";
+    cout << "18. Najkrótsza ścieżka między parą wierzchołków (do celu, dwukierunkowo, A* z punktami orientacyjnymi)\n";
+    cout << "19. Algorytm Dijkstry z wielu źródeł równolegle (listowo)\n";
+    cout << "20. Odległości między wszystkimi parami z wagami ujemnymi (Johnson, listowo)\n";
+    cout << "21. Harmonogram prób symulacji (próby równoległe, generatory w tle, tryb izolowany)\n";
+    cout << "22. Tryb automatyczny - wybór algorytmu i reprezentacji modelem kosztów\n";
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && string(argv[1]) == "bench")
+    {
+        return trybBenchmarku(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "konwertuj")
+    {
+        return trybKonwersji(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "kruskal-zewnetrzny")
+    {
+        return trybKruskalaZewnetrznego(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "zrodla")
+    {
+        return trybWieluZrodel(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "johnson")
+    {
+        return trybJohnsona(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "porownaj")
+    {
+        return trybPorownania(argc - 2, argv + 2);
+    }
+    if (argc > 1 && string(argv[1]) == "auto")
+    {
+        return trybAutomatyczny(argc - 2, argv + 2);
+    }
+
+    GrafMacierz gm(0);
+    GrafCSR gc(0);
+    int wybor;
+    string nazwaPliku;
+    int V = 0, zrodlo = 0, liczbaSymulacji = 1;
+    double gestosc = 0.0;
+    bool symulacja = false;
+    RodzajKolejki kolejka = RodzajKolejki::Binarna;
+    ObszarRoboczy obszar; // tablice pomocnicze algorytmów, wspólne dla kolejnych symulacji
+    KonfiguracjaProb harmonogram; // próby opcji 4-7 w trybie symulacji
+    ModelKosztow model;           // tryb automatyczny; kalibracja wczytywana przy pierwszym użyciu
+    while (true)
+    {
+        wyswietlMenu();
+        cin >> wybor;
+        switch (wybor)
+        {
+        case 1:
+        {
+            cout << "Podaj nazwę pliku: ";
+            cin >> nazwaPliku;
+            auto start = high_resolution_clock::now();
+            wczytajGraf(nazwaPliku, &gm, &gc);
+            auto czas = duration_cast<milliseconds>(high_resolution_clock::now() - start);
+            cout << "Wczytano graf (V = " << gc.pobierzV() << ", E = " << gc.pobierzLiczbeSasiadow() / 2
+                 << ") w " << czas.count() << " milisekund\n";
+            break;
+        }
+        case 2:
+            cout << "Podaj liczbę wierzchołków: ";
+            cin >> V;
+            cout << "Podaj gęstość grafu (w procentach): ";
+            cin >> gestosc;
+            generujLosowyGraf(V, gestosc, gm, gc);
+            break;
+        case 3:
+            cout << "\nGraf w formie macierzowej:\n";
+            {
+                Pisarz p(cout);
+                zapiszMacierz(p, gm);
+            }
+            cout << "\nGraf w formie listowej:\n";
+            {
+                Pisarz p(cout);
+                zapiszListe(p, gc);
+            }
+            break;
+        case 4:
+            if (!symulacja)
+            {
+                primMSTMacierz(gm, obszar);
+                cout << "\n";
+                primMSTLista(gc, obszar, false, kolejka);
+            }
+            else
+            {
+                wykonajProby(harmonogram, liczbaSymulacji, V, gestosc, gm, [&](const GrafProby &g, ObszarRoboczy &o, ostream &wyjscie)
+                             {
+                    primMSTMacierz(g.gm, o, symulacja, wyjscie);
+                    wyjscie << "\n";
+                    primMSTLista(g.gc, o, symulacja, kolejka, wyjscie); });
+            }
+            break;
+        case 5:
+            if (!symulacja)
+            {
+                kruskalMSTMacierz(gm, obszar);
+                cout << "\n";
+                kruskalMSTLista(gc, obszar);
+            }
+            else
+            {
+                wykonajProby(harmonogram, liczbaSymulacji, V, gestosc, gm, [&](const GrafProby &g, ObszarRoboczy &o, ostream &wyjscie)
+                             {
+                    kruskalMSTMacierz(g.gm, o, symulacja, wyjscie);
+                    wyjscie << "\n";
+                    kruskalMSTLista(g.gc, o, symulacja, wyjscie); });
+            }
+            break;
+        case 6:
+            cout << "Podaj wierzchołek źródłowy: ";
+            cin >> zrodlo;
+            if (!symulacja)
+            {
+                dijkstraMacierz(gm, zrodlo, obszar);
+                cout << "\n";
+                dijkstraLista(gc, zrodlo, obszar, false, kolejka);
+            }
+            else
+            {
+                wykonajProby(harmonogram, liczbaSymulacji, V, gestosc, gm, [&](const GrafProby &g, ObszarRoboczy &o, ostream &wyjscie)
+                             {
+                    dijkstraMacierz(g.gm, zrodlo, o, symulacja, wyjscie);
+                    wyjscie << "\n";
+                    dijkstraLista(g.gc, zrodlo, o, symulacja, kolejka, wyjscie); });
+            }
+            break;
+        case 7:
+            cout << "Podaj wierzchołek źródłowy: ";
+            cin >> zrodlo;
+            if (!symulacja)
+            {
+                BellmanFordMacierz(gm, zrodlo);
+                cout << "\n";
+                BellmanFordLista(gc, zrodlo);
+            }
+            else
+            {
+                wykonajProby(harmonogram, liczbaSymulacji, V, gestosc, gm, [&](const GrafProby &g, ObszarRoboczy &o, ostream &wyjscie)
+                             {
+                    BellmanFordMacierz(g.gm, zrodlo, symulacja, wyjscie);
+                    wyjscie << "\n";
+                    BellmanFordLista(g.gc, zrodlo, symulacja, wyjscie); });
+            }
+            break;
+        case 8:
+            cout << "Podaj liczbę symulacji: ";
+            cin >> liczbaSymulacji;
+            symulacja = true;
+            break;
+        case 9:
+            return 0;
+        case 10:
+        {
+            int ukladWybor, szerokoscWybor;
+            cout << "Układ macierzy (1 - pełna, 2 - górny trójkąt): ";
+            cin >> ukladWybor;
+            cout << "Szerokość wag (1 - 32 bity, 2 - 16 bitów, 3 - 8 bitów): ";
+            cin >> szerokoscWybor;
+            gm = gm.wInnymFormacie(ukladWybor == 2 ? UkladMacierzy::Trojkat : UkladMacierzy::Pelna,
+                                   szerokoscWybor == 3   ? SzerokoscWagi::UInt8
+                                   : szerokoscWybor == 2 ? SzerokoscWagi::UInt16
+                                                         : SzerokoscWagi::Int32);
+            cout << "Rozmiar macierzy: " << gm.pobierzRozmiarBajtow() << " bajtów\n";
+            break;
+        }
+        case 11:
+        {
+            int kolejkaWybor;
+            cout << "Kolejka (1 - binarna, 2 - 4-arna, 3 - parująca, 4 - kubełkowa): ";
+            cin >> kolejkaWybor;
+            const RodzajKolejki rodzaje[] = {RodzajKolejki::Binarna, RodzajKolejki::DArna, RodzajKolejki::Parujaca, RodzajKolejki::Kubelkowa};
+            kolejka = rodzaje[kolejkaWybor >= 1 && kolejkaWybor <= 4 ? kolejkaWybor - 1 : 0];
+            cout << "Wybrana kolejka: " << nazwaKolejki(kolejka) << "\n";
+            break;
+        }
+        case 12:
+        {
+            int watki, delta;
+            cout << "Podaj wierzchołek źródłowy: ";
+            cin >> zrodlo;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            cout << "Podaj szerokość kubełka (0 - automatyczna): ";
+            cin >> delta;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                deltaSteppingLista(gc, zrodlo, watki, delta);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    deltaSteppingLista(gc, zrodlo, watki, delta, symulacja);
+                }
+            }
+            break;
+        }
+        case 13:
+        {
+            int trybWybor, watki = 1;
+            cout << "Podaj wierzchołek źródłowy: ";
+            cin >> zrodlo;
+            cout << "Tryb (1 - rundy, 2 - kolejka, 3 - rundy wielowątkowo): ";
+            cin >> trybWybor;
+            TrybBellmanaForda tryb = trybWybor == 2   ? TrybBellmanaForda::Kolejka
+                                     : trybWybor == 3 ? TrybBellmanaForda::Rownolegly
+                                                      : TrybBellmanaForda::Rundy;
+            if (tryb == TrybBellmanaForda::Rownolegly)
+            {
+                cout << "Podaj liczbę wątków: ";
+                cin >> watki;
+                watki = max(watki, 1);
+            }
+            if (!symulacja)
+            {
+                BellmanFordListaSzybki(gc, zrodlo, tryb, watki);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    BellmanFordListaSzybki(gc, zrodlo, tryb, watki, symulacja);
+                }
+            }
+            break;
+        }
+        case 14:
+        {
+            int trybWybor, watki;
+            cout << "Tryb (1 - sortowanie pozycyjne, 2 - filter-Kruskal): ";
+            cin >> trybWybor;
+            TrybKruskala tryb = trybWybor == 2 ? TrybKruskala::Filtrujacy : TrybKruskala::Pozycyjny;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                kruskalMSTRownolegle(gm, gc, tryb, watki);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    kruskalMSTRownolegle(gm, gc, tryb, watki, symulacja);
+                }
+            }
+            break;
+        }
+        case 15:
+        {
+            int watki;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                boruvkaMSTLista(gc, watki);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    boruvkaMSTLista(gc, watki, symulacja);
+                }
+            }
+            break;
+        }
+        case 16:
+        {
+            int watki;
+            string plikWynikowy;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                cout << "Podaj nazwę pliku wynikowego (- aby wyświetlić): ";
+                cin >> plikWynikowy;
+                floydWarshallMacierz(gm, watki, plikWynikowy);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    floydWarshallMacierz(gm, watki, "", symulacja);
+                }
+            }
+            break;
+        }
+        case 17:
+            if (!symulacja)
+            {
+                dynamiczneMSTLista(gc);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    dynamiczneMSTLista(gc, symulacja);
+                }
+            }
+            break;
+        case 18:
+        {
+            int cel;
+            cout << "Podaj wierzchołek źródłowy: ";
+            cin >> zrodlo;
+            cout << "Podaj wierzchołek docelowy: ";
+            cin >> cel;
+            if (!symulacja)
+            {
+                sciezkaPunktPunkt(gm, gc, zrodlo, cel, obszar);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    sciezkaPunktPunkt(gm, gc, zrodlo, cel, obszar, symulacja);
+                }
+            }
+            break;
+        }
+        case 19:
+        {
+            string lista;
+            int watki;
+            vector<int> zrodla;
+            cout << "Podaj źródła (np. 0,5,7 albo 0-99 albo wszystkie): ";
+            cin >> lista;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                if (!wczytajZrodla(lista, gc.pobierzV(), zrodla))
+                {
+                    cout << "Nieprawidłowa lista źródeł!\n";
+                    break;
+                }
+                dijkstraWieluZrodel(gc, zrodla, watki, kolejka, cout, cout, false);
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    if (!wczytajZrodla(lista, gc.pobierzV(), zrodla))
+                    {
+                        cout << "Nieprawidłowa lista źródeł!\n";
+                        break;
+                    }
+                    dijkstraWieluZrodel(gc, zrodla, watki, kolejka, cout, cout, false, symulacja);
+                }
+            }
+            break;
+        }
+        case 20:
+        {
+            int watki;
+            string plikWynikowy;
+            cout << "Podaj liczbę wątków: ";
+            cin >> watki;
+            watki = max(watki, 1);
+            if (!symulacja)
+            {
+                cout << "Podaj nazwę pliku wynikowego (- aby wyświetlić): ";
+                cin >> plikWynikowy;
+                if (plikWynikowy == "-")
+                {
+                    johnsonLista(gc, watki, kolejka, cout, cout, false);
+                    break;
+                }
+                ofstream plik(plikWynikowy);
+                if (!plik)
+                {
+                    cout << "Nie można otworzyć pliku " << plikWynikowy << "\n";
+                    break;
+                }
+                johnsonLista(gc, watki, kolejka, plik, cout, false);
+                cout << "Zapisano odległości do " << plikWynikowy << "\n";
+            }
+            else
+            {
+                for (int i = 0; i < liczbaSymulacji; i++)
+                {
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                    johnsonLista(gc, watki, kolejka, cout, cout, false, DOMYSLNY_BUDZET_JOHNSONA, symulacja);
+                }
+            }
+            break;
+        }
+        case 22:
+        {
+            int zadanieWybor;
+            cout << "Zadanie (1 - drzewo rozpinające, 2 - odległości od źródła): ";
+            cin >> zadanieWybor;
+            ZadanieAuto zadanie = zadanieWybor == 2 ? ZadanieAuto::Odleglosci : ZadanieAuto::MST;
+            if (zadanie == ZadanieAuto::Odleglosci)
+            {
+                cout << "Podaj wierzchołek źródłowy: ";
+                cin >> zrodlo;
+            }
+            if (model.pusty() && !przygotujModelKosztow(model, DOMYSLNY_PLIK_KALIBRACJI, false, cout))
+                break;
+            // w menu obie reprezentacje już są, więc model porównuje same obliczenia
+            auto bezBudowy = [](const OcenaAuto &) {};
+            for (int i = 0; i < (symulacja ? liczbaSymulacji : 1); i++)
+            {
+                if (symulacja)
+                    generujLosowyGraf(V, gestosc, gm, gc);
+                if (zrodlo < 0 || zrodlo >= max(gc.pobierzV(), 1))
+                {
+                    cout << "Nieprawidłowy wierzchołek!\n";
+                    break;
+                }
+                GotoweReprezentacje gotowe{true, true, gm.pobierzSzerokosc()};
+                wykonajAutomatycznie(model, zadanie, cechyGrafu(gc), gotowe, zrodlo, gm, gc, bezBudowy, obszar, cout, cout,
+                                     symulacja);
+                cout << "\n";
+            }
+            break;
+        }
+        case 21:
+        {
+            int izolowany;
+            cout << "Próby liczone jednocześnie (każda na własnym rdzeniu, dostępnych " << dostepneRdzenie().size() << "): ";
+            cin >> harmonogram.rownolegle;
+            cout << "Wątki generujące grafy w tle (0 - generowanie przed każdą próbą): ";
+            cin >> harmonogram.generatory;
+            cout << "Tryb izolowany - jeden wątek pomiarowy na rdzeniu bez generatorów (1 - tak, 0 - nie): ";
+            cin >> izolowany;
+            harmonogram.rownolegle = max(harmonogram.rownolegle, 1);
+            harmonogram.generatory = max(harmonogram.generatory, 0);
+            harmonogram.izolowany = izolowany == 1;
+            break;
+        }
+        default:
+            cout << "Nieprawidłowa opcja! Spróbuj ponownie.\n";
+        }
+    }
+}
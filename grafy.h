@@ -0,0 +1,6749 @@
+// Biblioteka algorytmów grafowych: reprezentacje grafów, generator, kolejki priorytetowe,
+// algorytmy MST i najkrótszych ścieżek zwracające wyniki w strukturach oraz buforowany zapis
+// wyników. Całość jest w nagłówku (funkcje inline), więc wystarczy go dołączyć; grafy.cpp to
+// zbudowany na niej program z menu i trybem benchmarku.
+#ifndef GRAFY_H
+#define GRAFY_H
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <utility>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <random>
+#include <limits.h>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <deque>
+#include <unordered_map>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <type_traits>
+#include <limits>
+#include <numeric>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define GRAFY_ODWOLAJ_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#define GRAFY_ODWOLAJ_NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#ifdef GRAFY_ODWOLAJ_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef GRAFY_ODWOLAJ_LEAN_AND_MEAN
+#endif
+#ifdef GRAFY_ODWOLAJ_NOMINMAX
+#undef NOMINMAX
+#undef GRAFY_ODWOLAJ_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// Jądra AVX2/AVX-512 macierzowych Prima i Dijkstry, wybierane w czasie działania według
+// procesora. Kompilacja z -DGRAFY_WEKTORY=0 zostawia tylko jądra skalarne.
+#ifndef GRAFY_WEKTORY
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define GRAFY_WEKTORY 1
+#else
+#define GRAFY_WEKTORY 0
+#endif
+#endif
+#if GRAFY_WEKTORY
+#include <immintrin.h>
+#endif
+
+// Cała biblioteka jest w przestrzeni nazw grafy; nagłówek nie wciąga std do zasięgu globalnego.
+namespace grafy
+{
+
+// Krawędź u - v z wagą. Typy wagi i numeru wierzchołka są parametrami szablonu, żeby algorytmy
+// listowe działały też na wagach int64 i na grafach z V >= 2^31; Krawedz to wariant domyślny.
+template <typename W, typename Id>
+struct KrawedzOgolna
+{
+    Id u, v;
+    W waga;
+    bool operator<(const KrawedzOgolna &k) const
+    {
+        return waga < k.waga;
+    }
+};
+
+using Krawedz = KrawedzOgolna<int, int>;
+
+// Liczniki zdarzeń w gorących pętlach algorytmów. Kompilacja z -DGRAFY_LICZNIKI=0 usuwa je
+// całkowicie (LICZ rozwija się do niczego), więc nie wpływają wtedy na pomiary czasu.
+#ifndef GRAFY_LICZNIKI
+#define GRAFY_LICZNIKI 1
+#endif
+
+struct Liczniki
+{
+    int64_t krawedzie = 0;   // przejrzane krawędzie (łuki listy sąsiedztwa albo krawędzie wzięte z macierzy)
+    int64_t relaksacje = 0;  // udane zmniejszenia odległości lub klucza
+    int64_t wstawienia = 0;  // wstawienia i zmniejszenia klucza w kolejce priorytetowej
+    int64_t zdjecia = 0;     // zdjęcia minimum z kolejki priorytetowej
+    int64_t nieaktualne = 0; // nieaktualne wpisy pominięte przy zdejmowaniu (kolejka leniwa)
+    int64_t znajdz = 0;      // wyszukiwania korzenia w zbiorach rozłącznych
+    int64_t krokiZnajdz = 0; // suma długości ścieżek przebytych przy tych wyszukiwaniach
+    int64_t komorki = 0;     // odczytane pola macierzy
+
+    Liczniki &operator+=(const Liczniki &l)
+    {
+        krawedzie += l.krawedzie;
+        relaksacje += l.relaksacje;
+        wstawienia += l.wstawienia;
+        zdjecia += l.zdjecia;
+        nieaktualne += l.nieaktualne;
+        znajdz += l.znajdz;
+        krokiZnajdz += l.krokiZnajdz;
+        komorki += l.komorki;
+        return *this;
+    }
+};
+
+#if GRAFY_LICZNIKI
+// Każdy wątek liczy we własnej kopii (bez atomowych operacji w gorących pętlach) i rejestruje
+// ją tutaj; kończący się wątek dopisuje swoje wartości do zakonczone. Odczyt i zerowanie
+// odbywają się między uruchomieniami, gdy wątki puli czekają na zadanie.
+class RejestrLicznikow
+{
+    std::mutex m;
+    std::vector<Liczniki *> aktywne;
+    Liczniki zakonczone;
+
+public:
+    void dodaj(Liczniki *l)
+    {
+        std::lock_guard<std::mutex> blokada(m);
+        aktywne.push_back(l);
+    }
+
+    void usun(Liczniki *l)
+    {
+        std::lock_guard<std::mutex> blokada(m);
+        zakonczone += *l;
+        aktywne.erase(std::find(aktywne.begin(), aktywne.end(), l));
+    }
+
+    Liczniki zbierz()
+    {
+        std::lock_guard<std::mutex> blokada(m);
+        Liczniki suma = zakonczone;
+        for (Liczniki *l : aktywne)
+            suma += *l;
+        return suma;
+    }
+
+    void zeruj()
+    {
+        std::lock_guard<std::mutex> blokada(m);
+        zakonczone = Liczniki();
+        for (Liczniki *l : aktywne)
+            *l = Liczniki();
+    }
+};
+
+inline RejestrLicznikow &rejestrLicznikow()
+{
+    static RejestrLicznikow rejestr;
+    return rejestr;
+}
+
+struct LicznikiWatku
+{
+    Liczniki l;
+
+    LicznikiWatku()
+    {
+        rejestrLicznikow().dodaj(&l);
+    }
+
+    ~LicznikiWatku()
+    {
+        rejestrLicznikow().usun(&l);
+    }
+};
+
+inline Liczniki &licznikiWatku()
+{
+    thread_local LicznikiWatku liczniki;
+    return liczniki.l;
+}
+
+#define LICZ(pole, n) (licznikiWatku().pole += (n))
+
+inline Liczniki zbierzLiczniki()
+{
+    return rejestrLicznikow().zbierz();
+}
+
+inline void zerujLiczniki()
+{
+    rejestrLicznikow().zeruj();
+}
+#else
+#define LICZ(pole, n) ((void)0)
+
+inline Liczniki zbierzLiczniki()
+{
+    return Liczniki();
+}
+
+inline void zerujLiczniki()
+{
+}
+#endif
+
+// Sprzętowe liczniki wydajności przez perf_event_open (tylko Linux): cykle, instrukcje,
+// chybienia pamięci podręcznej ostatniego poziomu i błędnie przewidziane skoki, w trybie
+// użytkownika. Liczą tylko wątek, który je otworzył. Zdarzenia niedostępne (brak uprawnień,
+// maszyna wirtualna, inny system) mają deskryptor -1 i są raportowane jako puste.
+class LicznikiSprzetowe
+{
+public:
+    static const int LICZBA = 4;
+
+private:
+    int deskryptory[LICZBA] = {-1, -1, -1, -1};
+
+public:
+    LicznikiSprzetowe()
+    {
+#ifdef __linux__
+        const uint64_t zdarzenia[LICZBA] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < LICZBA; i++)
+        {
+            perf_event_attr atrybuty;
+            std::memset(&atrybuty, 0, sizeof(atrybuty));
+            atrybuty.size = sizeof(atrybuty);
+            atrybuty.type = PERF_TYPE_HARDWARE;
+            atrybuty.config = zdarzenia[i];
+            atrybuty.disabled = 1;
+            atrybuty.exclude_kernel = 1;
+            atrybuty.exclude_hv = 1;
+            deskryptory[i] = (int)syscall(SYS_perf_event_open, &atrybuty, 0, -1, -1, 0);
+        }
+#endif
+    }
+
+    LicznikiSprzetowe(const LicznikiSprzetowe &) = delete;
+    LicznikiSprzetowe &operator=(const LicznikiSprzetowe &) = delete;
+
+    ~LicznikiSprzetowe()
+    {
+#ifdef __linux__
+        for (int fd : deskryptory)
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    bool dostepny(int i) const
+    {
+        return deskryptory[i] >= 0;
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int fd : deskryptory)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop()
+    {
+#ifdef __linux__
+        for (int fd : deskryptory)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    int64_t odczytaj(int i) const
+    {
+        uint64_t wartosc = 0;
+#ifdef __linux__
+        if (deskryptory[i] < 0 || read(deskryptory[i], &wartosc, sizeof(wartosc)) != sizeof(wartosc))
+            return -1;
+#endif
+        return (int64_t)wartosc;
+    }
+};
+
+// Bufor o początku wyrównanym do linii pamięci podręcznej, wyzerowany przy tworzeniu.
+class BuforWyrownany
+{
+    unsigned char *dane = nullptr;
+    size_t rozmiar = 0;
+
+public:
+    static constexpr size_t WYROWNANIE = 64;
+
+    BuforWyrownany() = default;
+
+    explicit BuforWyrownany(size_t rozmiar) : rozmiar(rozmiar)
+    {
+        if (rozmiar > 0)
+        {
+            dane = static_cast<unsigned char *>(::operator new(rozmiar, std::align_val_t(WYROWNANIE)));
+            std::memset(dane, 0, rozmiar);
+        }
+    }
+
+    BuforWyrownany(const BuforWyrownany &inny) : BuforWyrownany(inny.rozmiar)
+    {
+        if (rozmiar > 0)
+            std::memcpy(dane, inny.dane, rozmiar);
+    }
+
+    BuforWyrownany(BuforWyrownany &&inny) noexcept : dane(inny.dane), rozmiar(inny.rozmiar)
+    {
+        inny.dane = nullptr;
+        inny.rozmiar = 0;
+    }
+
+    BuforWyrownany &operator=(BuforWyrownany inny) noexcept
+    {
+        std::swap(dane, inny.dane);
+        std::swap(rozmiar, inny.rozmiar);
+        return *this;
+    }
+
+    ~BuforWyrownany()
+    {
+        if (dane)
+            ::operator delete(dane, std::align_val_t(WYROWNANIE));
+    }
+
+    void wyzeruj()
+    {
+        if (rozmiar > 0)
+            std::memset(dane, 0, rozmiar);
+    }
+
+    template <typename T>
+    T *jako() const
+    {
+        return reinterpret_cast<T *>(dane);
+    }
+
+    size_t pobierzRozmiar() const
+    {
+        return rozmiar;
+    }
+};
+
+enum class UkladMacierzy
+{
+    Pelna,  // V wierszy, każdy zaczyna się na granicy linii pamięci podręcznej
+    Trojkat // tylko górny trójkąt (u <= v), spakowany wierszami
+};
+
+enum class SzerokoscWagi
+{
+    Int32,
+    UInt16, // wagi 0..65535, bez wag ujemnych
+    UInt8   // wagi 0..255, bez wag ujemnych
+};
+
+// Własności typu, w którym przechowywane są wagi. Sumy wag (długości ścieżek przy relaksacji,
+// waga MST) liczone są w akumulatorze Suma. Dla wag do 32 bitów jest on szerszy od wagi, więc
+// przy V < 2^31 sumy nie mogą się przepełnić; przy wagach int64 to wywołujący gwarantuje, że
+// każda ścieżka i waga MST mieszczą się w int64. Odległości są przechowywane w typie Odleglosc,
+// a NIESKONCZONOSC oznacza wierzchołek nieosiągalny. WASKIE mówi, czy wagi mieszczą się w 32
+// bitach - tylko takie obsługują kolejka kubełkowa i sortowanie pozycyjne.
+template <typename T>
+struct CechyWagi
+{
+    static_assert(std::is_integral_v<T> && (std::is_signed_v<T> || sizeof(T) < sizeof(int64_t)),
+                  "wagi muszą być liczbami całkowitymi mieszczącymi się w int64");
+    using Suma = int64_t;
+    static constexpr bool WASKIE = sizeof(T) <= sizeof(int32_t);
+    using Odleglosc = std::conditional_t<WASKIE, int, int64_t>;
+    static constexpr Odleglosc NIESKONCZONOSC = std::numeric_limits<Odleglosc>::max();
+    static constexpr int64_t MIN = std::numeric_limits<T>::min();
+    static constexpr int64_t MAKS = std::numeric_limits<T>::max();
+};
+
+// Akumulator wag i typ odległości dla grafu (widoku macierzy, WidokCSROgolny albo GrafCSROgolny).
+template <typename Graf>
+using SumaWag = typename CechyWagi<typename Graf::Waga>::Suma;
+
+template <typename Graf>
+using OdlegloscWag = typename CechyWagi<typename Graf::Waga>::Odleglosc;
+
+// Wywołuje f z wartością typu, w którym przechowywane są wagi (używaną tylko jako znacznik typu).
+template <typename F>
+decltype(auto) zTypemWagi(SzerokoscWagi szerokosc, F &&f)
+{
+    switch (szerokosc)
+    {
+    case SzerokoscWagi::UInt16:
+        return f(uint16_t());
+    case SzerokoscWagi::UInt8:
+        return f(uint8_t());
+    default:
+        return f(int32_t());
+    }
+}
+
+// Widok na dane macierzy bez kopiowania. Algorytmy macierzowe są szablonami
+// na tym typie, więc odczyt wagi kompiluje się do jednego dostępu do pamięci.
+template <typename T, bool Trojkat>
+struct WidokMacierzy
+{
+    using Waga = T;
+
+    int V;
+    size_t krok;
+    const T *dane;
+
+    int pobierzV() const
+    {
+        return V;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        if constexpr (Trojkat)
+            return (size_t)V * (V + 1) / 2 * sizeof(T);
+        else
+            return (size_t)V * krok * sizeof(T);
+    }
+
+    int operator()(int u, int v) const
+    {
+        if constexpr (Trojkat)
+        {
+            if (u > v)
+                std::swap(u, v);
+            return dane[(size_t)u * (2 * (size_t)V - u + 1) / 2 + (v - u)];
+        }
+        else
+        {
+            return dane[(size_t)u * krok + v];
+        }
+    }
+};
+
+class GrafMacierz
+{
+    int V;
+    UkladMacierzy uklad;
+    SzerokoscWagi szerokosc;
+    size_t krok;
+    BuforWyrownany bufor;
+
+    size_t rozmiarElementu() const
+    {
+        return zTypemWagi(szerokosc, [](auto t)
+                          { return sizeof(t); });
+    }
+
+    size_t indeks(int u, int v) const
+    {
+        if (uklad == UkladMacierzy::Trojkat)
+        {
+            if (u > v)
+                std::swap(u, v);
+            return (size_t)u * (2 * (size_t)V - u + 1) / 2 + (v - u);
+        }
+        return (size_t)u * krok + v;
+    }
+
+    void zapisz(int u, int v, int w)
+    {
+        zTypemWagi(szerokosc, [&](auto t)
+                   {
+                       using T = decltype(t);
+                       if (w < CechyWagi<T>::MIN || w > CechyWagi<T>::MAKS)
+                       {
+                           std::cerr << "Waga " << w << " nie mieści się w " << 8 * sizeof(T) << "-bitowej macierzy" << std::endl;
+                           std::exit(1);
+                       }
+                       bufor.jako<T>()[indeks(u, v)] = (T)w; });
+    }
+
+public:
+    GrafMacierz(int V, UkladMacierzy uklad = UkladMacierzy::Pelna, SzerokoscWagi szerokosc = SzerokoscWagi::Int32)
+        : V(V), uklad(uklad), szerokosc(szerokosc)
+    {
+        size_t elementy;
+        if (uklad == UkladMacierzy::Pelna)
+        {
+            size_t naLinie = BuforWyrownany::WYROWNANIE / rozmiarElementu();
+            krok = ((size_t)V + naLinie - 1) / naLinie * naLinie;
+            elementy = (size_t)V * krok;
+        }
+        else
+        {
+            krok = 0;
+            elementy = (size_t)V * (V + 1) / 2;
+        }
+        bufor = BuforWyrownany(elementy * rozmiarElementu());
+    }
+
+    // Usuwa wszystkie krawędzie i ustawia V wierzchołków; przy niezmienionym V bufor jest
+    // tylko zerowany, bez ponownego przydziału.
+    void wyczysc(int noweV)
+    {
+        if (noweV == V)
+            bufor.wyzeruj();
+        else
+            *this = GrafMacierz(noweV, uklad, szerokosc);
+    }
+
+    void dodajKrawedz(int u, int v, int w)
+    {
+        zapisz(u, v, w);
+        if (uklad == UkladMacierzy::Pelna)
+            zapisz(v, u, w);
+    }
+
+    void usunKrawedz(int u, int v)
+    {
+        dodajKrawedz(u, v, 0);
+    }
+
+    int waga(int u, int v) const
+    {
+        return zTypemWagi(szerokosc, [&](auto t)
+                          { return (int)bufor.jako<decltype(t)>()[indeks(u, v)]; });
+    }
+
+    // Wywołuje f z widokiem odpowiadającym układowi i szerokości wag tej macierzy;
+    // każda para (układ, typ wagi) to osobna instancja algorytmu.
+    template <typename F>
+    void zWidokiem(F &&f) const
+    {
+        zTypemWagi(szerokosc, [&](auto t)
+                   {
+                       using T = decltype(t);
+                       if (uklad == UkladMacierzy::Pelna)
+                           f(WidokMacierzy<T, false>{V, krok, bufor.jako<T>()});
+                       else
+                           f(WidokMacierzy<T, true>{V, krok, bufor.jako<T>()}); });
+    }
+
+    int pobierzV() const
+    {
+        return V;
+    }
+
+    UkladMacierzy pobierzUklad() const
+    {
+        return uklad;
+    }
+
+    SzerokoscWagi pobierzSzerokosc() const
+    {
+        return szerokosc;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return bufor.pobierzRozmiar();
+    }
+
+    GrafMacierz wInnymFormacie(UkladMacierzy nowyUklad, SzerokoscWagi nowaSzerokosc) const
+    {
+        GrafMacierz wynik(V, nowyUklad, nowaSzerokosc);
+        for (int u = 0; u < V; u++)
+            for (int v = u; v < V; v++)
+                if (int w = waga(u, v))
+                    wynik.dodajKrawedz(u, v, w);
+        return wynik;
+    }
+
+    void wczytajZPliku(const std::string &nazwaPliku)
+    {
+        std::ifstream plik(nazwaPliku);
+        if (!plik)
+        {
+            std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        int E;
+        plik >> V >> E;
+        *this = GrafMacierz(V, uklad, szerokosc);
+        for (int i = 0; i < E; i++)
+        {
+            int u, v, w;
+            plik >> u >> v >> w;
+            dodajKrawedz(u, v, w);
+        }
+        plik.close();
+    }
+};
+
+class GrafLista
+{
+    int V;
+    std::vector<std::vector<std::pair<int, int>>> listaSasiedztwa;
+
+public:
+    GrafLista(int V) : V(V), listaSasiedztwa(V) {}
+
+    void dodajKrawedz(int u, int v, int w)
+    {
+        listaSasiedztwa[u].push_back({v, w});
+        listaSasiedztwa[v].push_back({u, w});
+    }
+
+    // Usuwa jedną krawędź u - v (z obu list); zwraca false, jeśli jej nie było.
+    bool usunKrawedz(int u, int v)
+    {
+        auto usunSasiada = [](std::vector<std::pair<int, int>> &lista, int x)
+        {
+            auto it = std::find_if(lista.begin(), lista.end(), [x](const std::pair<int, int> &p)
+                              { return p.first == x; });
+            if (it == lista.end())
+                return false;
+            lista.erase(it);
+            return true;
+        };
+        if (!usunSasiada(listaSasiedztwa[u], v))
+            return false;
+        if (u != v)
+            usunSasiada(listaSasiedztwa[v], u);
+        return true;
+    }
+
+    const std::vector<std::vector<std::pair<int, int>>> &pobierzListeSasiedztwa() const
+    {
+        return listaSasiedztwa;
+    }
+
+    int pobierzV() const
+    {
+        return V;
+    }
+
+    void wczytajZPliku(const std::string &nazwaPliku)
+    {
+        std::ifstream plik(nazwaPliku);
+        if (!plik)
+        {
+            std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        int E;
+        plik >> V >> E;
+        listaSasiedztwa = std::vector<std::vector<std::pair<int, int>>>(V);
+        for (int i = 0; i < E; i++)
+        {
+            int u, v, w;
+            plik >> u >> v >> w;
+            dodajKrawedz(u, v, w);
+        }
+        plik.close();
+    }
+};
+
+// Niewłaściciel danych grafu w formacie CSR - tani do przekazywania przez wartość.
+// Sąsiedzi wierzchołka u to sasiedzi[offsety[u]] .. sasiedzi[offsety[u + 1] - 1].
+// W to typ wagi, Id typ numeru wierzchołka (ze znakiem, bo -1 oznacza brak wierzchołka);
+// WidokCSR to wariant (int, int), na którym działa reszta biblioteki.
+template <typename W, typename Id>
+struct WidokCSROgolny
+{
+    static_assert(std::is_integral_v<Id> && std::is_signed_v<Id>, "numery wierzchołków muszą być liczbami ze znakiem");
+
+    using Waga = W;
+    using Wierzcholek = Id;
+    using Widok = WidokCSROgolny;
+
+    Id V = 0;
+    const int64_t *offsety = nullptr;
+    const Id *sasiedzi = nullptr;
+    const W *wagi = nullptr;
+    W minWaga = 0, maksWaga = 0; // zakres wag, potrzebny kolejkom kubełkowym
+
+    Id pobierzV() const
+    {
+        return V;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return (size_t)(V + 1) * sizeof(int64_t) + (size_t)offsety[V] * (sizeof(Id) + sizeof(W));
+    }
+};
+
+using WidokCSR = WidokCSROgolny<int, int>;
+
+// Plik odwzorowany w pamięci tylko do odczytu. Gdy się nie uda, dane() zwraca nullptr.
+class MapowaniePliku
+{
+    const char *dane = nullptr;
+    size_t rozmiar = 0;
+#ifdef _WIN32
+    HANDLE plik = INVALID_HANDLE_VALUE;
+    HANDLE mapa = nullptr;
+#endif
+
+public:
+    explicit MapowaniePliku(const std::string &nazwaPliku)
+    {
+#ifdef _WIN32
+        plik = CreateFileA(nazwaPliku.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (plik == INVALID_HANDLE_VALUE)
+            return;
+        LARGE_INTEGER wielkosc;
+        if (!GetFileSizeEx(plik, &wielkosc) || wielkosc.QuadPart == 0)
+            return;
+        mapa = CreateFileMappingA(plik, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapa)
+            return;
+        dane = static_cast<const char *>(MapViewOfFile(mapa, FILE_MAP_READ, 0, 0, 0));
+        if (dane)
+            rozmiar = (size_t)wielkosc.QuadPart;
+#else
+        int fd = open(nazwaPliku.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                dane = static_cast<const char *>(p);
+                rozmiar = st.st_size;
+                madvise(p, rozmiar, MADV_SEQUENTIAL);
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    MapowaniePliku(const MapowaniePliku &) = delete;
+    MapowaniePliku &operator=(const MapowaniePliku &) = delete;
+
+    ~MapowaniePliku()
+    {
+#ifdef _WIN32
+        if (dane)
+            UnmapViewOfFile(dane);
+        if (mapa)
+            CloseHandle(mapa);
+        if (plik != INVALID_HANDLE_VALUE)
+            CloseHandle(plik);
+#else
+        if (dane)
+            munmap(const_cast<char *>(dane), rozmiar);
+#endif
+    }
+
+    const char *pobierzDane() const
+    {
+        return dane;
+    }
+
+    size_t pobierzRozmiar() const
+    {
+        return rozmiar;
+    }
+};
+
+// Binarny format grafu: nagłówek, a za nim tablice CSR (offsety int64, sąsiedzi int32,
+// wagi int32), każda od granicy 64 bajtów. Liczby zapisane w kolejności bajtów maszyny
+// (little-endian na x86/ARM), więc plik można odwzorować w pamięci i używać bez kopiowania.
+struct NaglowekGrafuBinarnego
+{
+    char magia[8];
+    uint32_t wersja;
+    uint32_t V;
+    uint64_t liczbaKrawedzi;
+    uint64_t liczbaSasiadow;
+    uint64_t poczatekOffsetow;
+    uint64_t poczatekSasiadow;
+    uint64_t poczatekWag;
+    int32_t minWaga;
+    int32_t maksWaga;
+};
+
+const char MAGIA_GRAFU_BINARNEGO[8] = {'G', 'R', 'A', 'F', 'C', 'S', 'R', '1'};
+
+inline uint64_t wyrownajDo64(uint64_t x)
+{
+    return (x + 63) / 64 * 64;
+}
+
+// Graf w formacie CSR, właściciel tablic albo pliku binarnego odwzorowanego w pamięci.
+// Typy wagi i wierzchołka jak w WidokCSROgolny; format binarny obsługuje tylko GrafCSR (int, int).
+template <typename W, typename Id>
+class GrafCSROgolny
+{
+    Id V;
+    std::vector<int64_t> offsety;
+    std::vector<Id> sasiedzi;
+    std::vector<W> wagi;
+    W minWaga = 0, maksWaga = 0;
+    std::shared_ptr<const MapowaniePliku> mapowanie; // ustawione, gdy dane leżą w pliku binarnym
+    WidokCSROgolny<W, Id> zmapowany;
+
+    static constexpr bool BINARNY = std::is_same_v<W, int> && std::is_same_v<Id, int>;
+
+    void policzZakresWag()
+    {
+        if (wagi.empty())
+        {
+            minWaga = maksWaga = 0;
+            return;
+        }
+        auto zakres = std::minmax_element(wagi.begin(), wagi.end());
+        minWaga = *zakres.first;
+        maksWaga = *zakres.second;
+    }
+
+public:
+    using Waga = W;
+    using Wierzcholek = Id;
+    using Widok = WidokCSROgolny<W, Id>;
+
+    GrafCSROgolny(Id V = 0) : V(V), offsety(V + 1, 0) {}
+
+    explicit GrafCSROgolny(const GrafLista &gl)
+    {
+        const auto &lista = gl.pobierzListeSasiedztwa();
+        V = gl.pobierzV();
+        offsety.assign(V + 1, 0);
+        for (int u = 0; u < V; u++)
+        {
+            offsety[u + 1] = offsety[u] + lista[u].size();
+        }
+        sasiedzi.resize(offsety[V]);
+        wagi.resize(offsety[V]);
+        for (int u = 0; u < V; u++)
+        {
+            int64_t i = offsety[u];
+            for (const auto &p : lista[u])
+            {
+                sasiedzi[i] = p.first;
+                wagi[i] = p.second;
+                i++;
+            }
+        }
+        policzZakresWag();
+    }
+
+    // Buduje graf nieskierowany z listy krawędzi (sortowanie przez zliczanie po u i v).
+    // Kolejność sąsiadów jest taka sama, jak przy kolejnych wywołaniach GrafLista::dodajKrawedz.
+    // Ze skierowany każda krawędź daje tylko łuk u -> v; tak zbudowany graf przyjmują algorytmy
+    // odległości na liście (Dijkstra, Bellman-Ford, Johnson), ale nie algorytmy MST.
+    void zbudujZKrawedzi(Id liczbaWierzcholkow, const std::vector<KrawedzOgolna<W, Id>> &krawedzie, bool skierowany = false)
+    {
+        mapowanie.reset();
+        V = liczbaWierzcholkow;
+        offsety.assign(V + 1, 0);
+        for (const auto &k : krawedzie)
+        {
+            offsety[k.u + 1]++;
+            if (!skierowany)
+                offsety[k.v + 1]++;
+        }
+        for (Id u = 0; u < V; u++)
+        {
+            offsety[u + 1] += offsety[u];
+        }
+        sasiedzi.resize(offsety[V]);
+        wagi.resize(offsety[V]);
+        std::vector<int64_t> pozycja(offsety.begin(), offsety.end() - 1);
+        for (const auto &k : krawedzie)
+        {
+            int64_t i = pozycja[k.u]++;
+            sasiedzi[i] = k.v;
+            wagi[i] = k.waga;
+            if (skierowany)
+                continue;
+            i = pozycja[k.v]++;
+            sasiedzi[i] = k.u;
+            wagi[i] = k.waga;
+        }
+        policzZakresWag();
+    }
+
+    void wczytajZPliku(const std::string &nazwaPliku)
+    {
+        std::ifstream plik(nazwaPliku);
+        if (!plik)
+        {
+            std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        Id liczbaWierzcholkow;
+        int64_t E;
+        plik >> liczbaWierzcholkow >> E;
+        std::vector<KrawedzOgolna<W, Id>> krawedzie(E);
+        for (int64_t i = 0; i < E; i++)
+        {
+            int64_t waga = 0; // nie wprost do waga, bo uint8_t czytałby się jako znak
+            plik >> krawedzie[i].u >> krawedzie[i].v >> waga;
+            krawedzie[i].waga = (W)waga;
+        }
+        plik.close();
+        zbudujZKrawedzi(liczbaWierzcholkow, krawedzie);
+    }
+
+    Id pobierzV() const
+    {
+        return V;
+    }
+
+    int64_t pobierzLiczbeSasiadow() const
+    {
+        return widok().offsety[V];
+    }
+
+    Widok widok() const
+    {
+        if (mapowanie)
+            return zmapowany;
+        return {V, offsety.data(), sasiedzi.data(), wagi.data(), minWaga, maksWaga};
+    }
+
+    // Odwzorowuje plik w formacie binarnym; tablice nie są kopiowane. Algorytmy ufają offsetom
+    // i numerom sąsiadów bez sprawdzania, więc przed udostępnieniem widoku plik jest raz
+    // przeglądany w całości: tablice muszą być wyrównane i mieścić się w pliku, offsety rosnąć
+    // od 0 do liczbaSasiadow, a sąsiedzi leżeć w [0, V). Zakres wag jest liczony od nowa, a nie
+    // brany z nagłówka, bo kolejka kubełkowa i delta-stepping liczą z niego kubełki.
+    void wczytajBinarnie(const std::string &nazwaPliku)
+    {
+        static_assert(BINARNY, "format binarny przechowuje numery wierzchołków i wagi jako int32");
+        auto mapa = std::make_shared<const MapowaniePliku>(nazwaPliku);
+        const char *dane = mapa->pobierzDane();
+        size_t rozmiar = mapa->pobierzRozmiar();
+        NaglowekGrafuBinarnego n;
+        if (!dane || rozmiar < sizeof(n))
+        {
+            std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        std::memcpy(&n, dane, sizeof(n));
+        // Tablica liczba x bajty od pozycji poczatek mieści się w pliku; bez mnożenia, które mogłoby się przepełnić.
+        auto miesciSie = [&](uint64_t poczatek, uint64_t liczba, uint64_t bajty)
+        { return poczatek % bajty == 0 && poczatek <= rozmiar && liczba <= (rozmiar - poczatek) / bajty; };
+        bool poprawny = std::memcmp(n.magia, MAGIA_GRAFU_BINARNEGO, sizeof(n.magia)) == 0 && n.wersja == 1 &&
+                        n.V < INT_MAX && miesciSie(n.poczatekOffsetow, (uint64_t)n.V + 1, sizeof(int64_t)) &&
+                        miesciSie(n.poczatekSasiadow, n.liczbaSasiadow, sizeof(int)) &&
+                        miesciSie(n.poczatekWag, n.liczbaSasiadow, sizeof(int));
+
+        const int64_t *offsetyPliku = nullptr;
+        const int *sasiedziPliku = nullptr, *wagiPliku = nullptr;
+        if (poprawny)
+        {
+            offsetyPliku = reinterpret_cast<const int64_t *>(dane + n.poczatekOffsetow);
+            sasiedziPliku = reinterpret_cast<const int *>(dane + n.poczatekSasiadow);
+            wagiPliku = reinterpret_cast<const int *>(dane + n.poczatekWag);
+            poprawny = offsetyPliku[0] == 0 && (uint64_t)offsetyPliku[n.V] == n.liczbaSasiadow;
+            for (uint32_t u = 0; u < n.V && poprawny; u++)
+                poprawny = offsetyPliku[u] <= offsetyPliku[u + 1];
+            for (uint64_t j = 0; j < n.liczbaSasiadow && poprawny; j++)
+                poprawny = sasiedziPliku[j] >= 0 && (uint32_t)sasiedziPliku[j] < n.V;
+        }
+        if (!poprawny)
+        {
+            std::cerr << "Plik " << nazwaPliku << " nie jest poprawnym grafem binarnym" << std::endl;
+            std::exit(1);
+        }
+
+        int minWagaPliku = 0, maksWagaPliku = 0;
+        if (n.liczbaSasiadow > 0)
+        {
+            auto zakres = std::minmax_element(wagiPliku, wagiPliku + n.liczbaSasiadow);
+            minWagaPliku = *zakres.first;
+            maksWagaPliku = *zakres.second;
+        }
+        V = (int)n.V;
+        offsety.clear();
+        sasiedzi.clear();
+        wagi.clear();
+        zmapowany = {V, offsetyPliku, sasiedziPliku, wagiPliku, minWagaPliku, maksWagaPliku};
+        mapowanie = mapa;
+    }
+
+    void zapiszBinarnie(const std::string &nazwaPliku) const
+    {
+        static_assert(BINARNY, "format binarny przechowuje numery wierzchołków i wagi jako int32");
+        WidokCSR g = widok();
+        uint64_t liczbaSasiadow = g.offsety[V];
+        NaglowekGrafuBinarnego n = {};
+        std::memcpy(n.magia, MAGIA_GRAFU_BINARNEGO, sizeof(n.magia));
+        n.wersja = 1;
+        n.V = V;
+        n.liczbaKrawedzi = liczbaSasiadow / 2;
+        n.liczbaSasiadow = liczbaSasiadow;
+        n.poczatekOffsetow = wyrownajDo64(sizeof(n));
+        n.poczatekSasiadow = wyrownajDo64(n.poczatekOffsetow + (V + 1) * sizeof(int64_t));
+        n.poczatekWag = wyrownajDo64(n.poczatekSasiadow + liczbaSasiadow * sizeof(int));
+        n.minWaga = g.minWaga;
+        n.maksWaga = g.maksWaga;
+
+        std::ofstream plik(nazwaPliku, std::ios::binary);
+        if (!plik)
+        {
+            std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        const char zera[64] = {};
+        auto zapiszOd = [&](uint64_t pozycja, const void *dane, uint64_t bajty)
+        {
+            plik.write(zera, pozycja - (uint64_t)plik.tellp());
+            plik.write(static_cast<const char *>(dane), bajty);
+        };
+        zapiszOd(0, &n, sizeof(n));
+        zapiszOd(n.poczatekOffsetow, g.offsety, (V + 1) * sizeof(int64_t));
+        zapiszOd(n.poczatekSasiadow, g.sasiedzi, liczbaSasiadow * sizeof(int));
+        zapiszOd(n.poczatekWag, g.wagi, liczbaSasiadow * sizeof(int));
+        if (!plik)
+        {
+            std::cerr << "Błąd zapisu pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+    }
+
+    operator Widok() const
+    {
+        return widok();
+    }
+};
+
+using GrafCSR = GrafCSROgolny<int, int>;
+
+// Parser tekstowego formatu grafu ("V E", potem E trójek "u v waga") działający
+// bezpośrednio na odwzorowanym pliku, bez strumieni i bez kopiowania tekstu.
+class CzytnikLiczb
+{
+    const char *p, *koniec;
+
+public:
+    CzytnikLiczb(const char *poczatek, const char *koniec) : p(poczatek), koniec(koniec) {}
+
+    bool nastepna(long long &x)
+    {
+        while (p < koniec && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+            p++;
+        if (p == koniec)
+            return false;
+        bool ujemna = false;
+        if (*p == '-' || *p == '+')
+            ujemna = *p++ == '-';
+        if (p == koniec || *p < '0' || *p > '9')
+            return false;
+        long long wartosc = 0;
+        while (p < koniec && *p >= '0' && *p <= '9')
+            wartosc = wartosc * 10 + (*p++ - '0');
+        x = ujemna ? -wartosc : wartosc;
+        return true;
+    }
+
+    const char *pozycja() const
+    {
+        return p;
+    }
+};
+
+// Buforowany zapis tekstu i danych binarnych - odpowiednik CzytnikLiczb po stronie wyjścia.
+// Wszystko trafia do bufora, a strumień dostaje je dużymi blokami zamiast po każdym wierszu.
+// Bufor jest opróżniany w destruktorze, więc przed pisaniem do tego samego strumienia inną
+// drogą trzeba zamknąć zakres pisarza albo wywołać oproznij().
+class Pisarz
+{
+    std::ostream &wyjscie;
+    std::vector<char> bufor;
+    size_t zajete = 0;
+
+public:
+    explicit Pisarz(std::ostream &wyjscie, size_t rozmiarBufora = 1 << 16) : wyjscie(wyjscie), bufor(rozmiarBufora) {}
+    Pisarz(const Pisarz &) = delete;
+    Pisarz &operator=(const Pisarz &) = delete;
+
+    ~Pisarz()
+    {
+        oproznij();
+    }
+
+    void oproznij()
+    {
+        if (zajete > 0)
+            wyjscie.write(bufor.data(), zajete);
+        zajete = 0;
+    }
+
+    void binarnie(const void *dane, size_t bajty)
+    {
+        if (zajete + bajty > bufor.size())
+        {
+            oproznij();
+            if (bajty > bufor.size())
+            {
+                wyjscie.write(static_cast<const char *>(dane), bajty);
+                return;
+            }
+        }
+        std::memcpy(bufor.data() + zajete, dane, bajty);
+        zajete += bajty;
+    }
+
+    template <typename T>
+    void binarnie(const T &wartosc)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "zapis binarny wymaga typu kopiowalnego bajt po bajcie");
+        binarnie(&wartosc, sizeof(T));
+    }
+
+    Pisarz &operator<<(char znak)
+    {
+        if (zajete == bufor.size())
+            oproznij();
+        bufor[zajete++] = znak;
+        return *this;
+    }
+
+    Pisarz &operator<<(const char *tekst)
+    {
+        binarnie(tekst, std::strlen(tekst));
+        return *this;
+    }
+
+    Pisarz &operator<<(const std::string &tekst)
+    {
+        binarnie(tekst.data(), tekst.size());
+        return *this;
+    }
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    Pisarz &operator<<(T liczba)
+    {
+        char tekst[24];
+        char *koniec = std::to_chars(tekst, tekst + sizeof(tekst), liczba).ptr;
+        binarnie(tekst, koniec - tekst);
+        return *this;
+    }
+};
+
+// Macierz wag wiersz po wierszu (0 - brak krawędzi).
+inline void zapiszMacierz(Pisarz &p, const GrafMacierz &graf)
+{
+    graf.zWidokiem([&](const auto &macierz)
+                   {
+        int V = macierz.pobierzV();
+        for (int u = 0; u < V; u++)
+        {
+            for (int v = 0; v < V; v++)
+                p << macierz(u, v) << ' ';
+            p << '\n';
+        } });
+}
+
+// Lista sąsiedztwa: "u: (v, waga) (v, waga) ...".
+inline void zapiszListe(Pisarz &p, WidokCSR graf)
+{
+    for (int u = 0; u < graf.V; u++)
+    {
+        p << u << ": ";
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+            p << '(' << graf.sasiedzi[j] << ", " << graf.wagi[j] << ") ";
+        p << '\n';
+    }
+}
+
+inline bool czyGrafBinarny(const std::string &nazwaPliku)
+{
+    std::ifstream plik(nazwaPliku, std::ios::binary);
+    char magia[sizeof(MAGIA_GRAFU_BINARNEGO)] = {};
+    plik.read(magia, sizeof(magia));
+    return plik && std::memcmp(magia, MAGIA_GRAFU_BINARNEGO, sizeof(magia)) == 0;
+}
+
+// Macierz z listy w układzie i szerokości wag, które gm już ma; łuk u -> v trafia do niej raz, z u < v.
+inline void zbudujMacierzZCSR(WidokCSR g, GrafMacierz &gm)
+{
+    gm = GrafMacierz(g.V, gm.pobierzUklad(), gm.pobierzSzerokosc());
+    for (int u = 0; u < g.V; u++)
+        for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+            if (u < g.sasiedzi[j])
+                gm.dodajKrawedz(u, g.sasiedzi[j], g.wagi[j]);
+}
+
+// Krawędzie pliku tekstowego ("V E", potem E wierszy "u v waga"); zwraca V.
+inline int wczytajKrawedzie(const std::string &nazwaPliku, std::vector<Krawedz> &krawedzie)
+{
+    MapowaniePliku plik(nazwaPliku);
+    if (!plik.pobierzDane())
+    {
+        std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+        std::exit(1);
+    }
+    CzytnikLiczb czytnik(plik.pobierzDane(), plik.pobierzDane() + plik.pobierzRozmiar());
+    long long V, E;
+    if (!czytnik.nastepna(V) || !czytnik.nastepna(E) || V < 0 || V > INT_MAX || E < 0)
+    {
+        std::cerr << "Nieprawidłowy nagłówek pliku " << nazwaPliku << std::endl;
+        std::exit(1);
+    }
+    krawedzie.assign(E, Krawedz());
+    for (long long i = 0; i < E; i++)
+    {
+        long long u, v, w;
+        if (!czytnik.nastepna(u) || !czytnik.nastepna(v) || !czytnik.nastepna(w) ||
+            u < 0 || u >= V || v < 0 || v >= V || w < INT_MIN || w > INT_MAX)
+        {
+            std::cerr << "Nieprawidłowa krawędź nr " << i + 1 << " w pliku " << nazwaPliku << std::endl;
+            std::exit(1);
+        }
+        krawedzie[i] = {(int)u, (int)v, (int)w};
+    }
+    return (int)V;
+}
+
+// Wczytuje graf z pliku tekstowego albo binarnego (rozpoznawanego po nagłówku) i buduje
+// podane reprezentacje. Plik tekstowy jest parsowany raz, wspólnie dla obu reprezentacji;
+// plik binarny jest odwzorowywany w pamięci i używany przez GrafCSR bez kopiowania.
+// Ze skierowany krawędzie pliku tekstowego są łukami u -> v w GrafCSR (macierz jest zawsze
+// symetryczna); plik binarny przechowuje łuki, więc wczytuje się bez zmian.
+inline void wczytajGraf(const std::string &nazwaPliku, GrafMacierz *gm, GrafCSR *gc, bool skierowany = false)
+{
+    if (czyGrafBinarny(nazwaPliku))
+    {
+        GrafCSR zmapowany;
+        zmapowany.wczytajBinarnie(nazwaPliku);
+        if (gm)
+            zbudujMacierzZCSR(zmapowany.widok(), *gm);
+        if (gc)
+            *gc = std::move(zmapowany);
+        return;
+    }
+
+    std::vector<Krawedz> krawedzie;
+    int V = wczytajKrawedzie(nazwaPliku, krawedzie);
+    if (gm)
+    {
+        *gm = GrafMacierz(V, gm->pobierzUklad(), gm->pobierzSzerokosc());
+        for (const auto &k : krawedzie)
+            gm->dodajKrawedz(k.u, k.v, k.waga);
+    }
+    if (gc)
+        gc->zbudujZKrawedzi(V, krawedzie, skierowany);
+}
+
+// Uruchamia f(0) .. f(watki - 1) równolegle; f(0) wykonuje się w bieżącym wątku.
+template <typename F>
+void rownolegle(int watki, F &&f)
+{
+    std::vector<std::thread> pula;
+    for (int t = 1; t < watki; t++)
+        pula.emplace_back([&f, t]
+                          { f(t); });
+    f(0);
+    for (auto &w : pula)
+        w.join();
+}
+
+// Stała pula wątków do obliczeń typu fork-join: wykonaj(f) uruchamia f(0) .. f(n - 1),
+// f(0) w wątku wywołującym, i wraca, gdy wszystkie się skończą. Wątki czekają między
+// zadaniami, więc algorytmy z wieloma krótkimi fazami nie płacą za ich tworzenie.
+class PulaWatkow
+{
+    std::vector<std::thread> watki;
+    std::mutex m;
+    std::condition_variable start, koniec;
+    const std::function<void(int)> *zadanie = nullptr;
+    uint64_t pokolenie = 0;
+    int pracujace = 0;
+    bool zamykanie = false;
+
+    void petla(int t)
+    {
+        uint64_t widziane = 0;
+        while (true)
+        {
+            const std::function<void(int)> *f;
+            {
+                std::unique_lock<std::mutex> blokada(m);
+                start.wait(blokada, [&]
+                           { return zamykanie || pokolenie != widziane; });
+                if (zamykanie)
+                    return;
+                widziane = pokolenie;
+                f = zadanie;
+            }
+            (*f)(t);
+            std::lock_guard<std::mutex> blokada(m);
+            if (--pracujace == 0)
+                koniec.notify_one();
+        }
+    }
+
+public:
+    explicit PulaWatkow(int n)
+    {
+        for (int t = 1; t < n; t++)
+            watki.emplace_back(&PulaWatkow::petla, this, t);
+    }
+
+    PulaWatkow(const PulaWatkow &) = delete;
+    PulaWatkow &operator=(const PulaWatkow &) = delete;
+
+    ~PulaWatkow()
+    {
+        {
+            std::lock_guard<std::mutex> blokada(m);
+            zamykanie = true;
+        }
+        start.notify_all();
+        for (auto &w : watki)
+            w.join();
+    }
+
+    int rozmiar() const
+    {
+        return watki.size() + 1;
+    }
+
+    void wykonaj(const std::function<void(int)> &f)
+    {
+        if (watki.empty())
+        {
+            f(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> blokada(m);
+            zadanie = &f;
+            pracujace = watki.size();
+            pokolenie++;
+        }
+        start.notify_all();
+        f(0);
+        std::unique_lock<std::mutex> blokada(m);
+        koniec.wait(blokada, [&]
+                    { return pracujace == 0; });
+    }
+
+    // Dzieli [0, n) na rozmiar() ciągłych przedziałów i wywołuje f(t, od, do) dla każdego.
+    template <typename F>
+    void dlaPrzedzialow(int64_t n, F &&f)
+    {
+        int64_t p = rozmiar();
+        wykonaj([&](int t)
+                { f(t, n * t / p, n * (t + 1) / p); });
+    }
+
+    // Wywołuje f(t, i) dla każdego i z [0, n), n < 2^32. Każdy wątek dostaje ciągły przedział
+    // i bierze zadania z jego początku; gdy skończy, kradnie pojedyncze zadania z końców
+    // przedziałów pozostałych wątków. Przeznaczone dla zadań o bardzo różnym czasie trwania,
+    // dla których równy podział z dlaPrzedzialow zostawiłby część wątków bezczynną.
+    template <typename F>
+    void dlaZadanZKradzieza(int64_t n, F &&f)
+    {
+        // Przedział wątku to (początek << 32) | koniec - obie granice zmieniane jednym CAS-em.
+        struct alignas(64) Przedzial
+        {
+            std::atomic<uint64_t> stan;
+        };
+        int p = rozmiar();
+        std::vector<Przedzial> przedzialy(p);
+        for (int t = 0; t < p; t++)
+            przedzialy[t].stan.store((uint64_t)(n * t / p) << 32 | (uint64_t)(n * (t + 1) / p), std::memory_order_relaxed);
+        auto wez = [&](int w, bool zKonca, int64_t &i)
+        {
+            uint64_t stan = przedzialy[w].stan.load(std::memory_order_relaxed);
+            while (true)
+            {
+                uint64_t od = stan >> 32, doK = stan & UINT32_MAX;
+                if (od >= doK)
+                    return false;
+                uint64_t nowy = zKonca ? od << 32 | (doK - 1) : (od + 1) << 32 | doK;
+                if (przedzialy[w].stan.compare_exchange_weak(stan, nowy, std::memory_order_relaxed))
+                {
+                    i = zKonca ? doK - 1 : od;
+                    return true;
+                }
+            }
+        };
+        wykonaj([&](int t)
+                {
+                    int64_t i;
+                    while (wez(t, false, i))
+                        f(t, i);
+                    // przedziały tylko się kurczą, więc jedno okrążenie wystarcza
+                    for (int k = 1; k < p; k++)
+                        while (wez((t + k) % p, true, i))
+                            f(t, i); });
+    }
+};
+
+// Liczba losowa z przedziału otwartego (0, 1) - logarytmy w metodzie Vittera nie dopuszczają zera.
+inline double losowaOtwarta(std::mt19937_64 &gen)
+{
+    std::uniform_real_distribution<double> rozklad(0.0, 1.0);
+    double u;
+    do
+        u = rozklad(gen);
+    while (u <= 0.0);
+    return u;
+}
+
+// Losuje n różnych liczb z [0, N) i przekazuje je do emituj w kolejności rosnącej,
+// w oczekiwanym czasie O(n) (J. S. Vitter, "An Efficient Algorithm for Sequential
+// Random Sampling", 1987 - metoda D, z przejściem na metodę A gdy n jest blisko N).
+template <typename F>
+void losujPosortowane(uint64_t n, uint64_t N, std::mt19937_64 &gen, F &&emituj)
+{
+    if (n == 0)
+        return;
+    const double ALFA = 13.0;
+    int64_t biezacy = -1;
+    double nRzecz = (double)n, NRzecz = (double)N;
+    double nOdwr = 1.0 / nRzecz;
+    double Vprim = std::exp(std::log(losowaOtwarta(gen)) * nOdwr);
+    uint64_t qu1 = N - n + 1;
+    double qu1Rzecz = NRzecz - nRzecz + 1.0;
+    double prog = ALFA * n;
+
+    while (n > 1 && prog < N)
+    {
+        double nMniej1Odwr = 1.0 / (nRzecz - 1.0);
+        uint64_t S;
+        while (true)
+        {
+            double X;
+            while (true)
+            {
+                X = NRzecz * (1.0 - Vprim);
+                S = (uint64_t)X;
+                if (S < qu1)
+                    break;
+                Vprim = std::exp(std::log(losowaOtwarta(gen)) * nOdwr);
+            }
+            double U = losowaOtwarta(gen);
+            double minusS = -(double)S;
+            double y1 = std::exp(std::log(U * NRzecz / qu1Rzecz) * nMniej1Odwr);
+            Vprim = y1 * (1.0 - X / NRzecz) * (qu1Rzecz / (minusS + qu1Rzecz));
+            if (Vprim <= 1.0)
+                break;
+
+            double y2 = 1.0, gora = NRzecz - 1.0, dol;
+            uint64_t granica;
+            if (n - 1 > S)
+            {
+                dol = NRzecz - nRzecz;
+                granica = N - S;
+            }
+            else
+            {
+                dol = NRzecz + minusS - 1.0;
+                granica = qu1;
+            }
+            for (uint64_t t = N - 1; t >= granica; t--)
+            {
+                y2 = (y2 * gora) / dol;
+                gora -= 1.0;
+                dol -= 1.0;
+            }
+            if (NRzecz / (NRzecz - X) >= y1 * std::exp(std::log(y2) * nMniej1Odwr))
+            {
+                Vprim = std::exp(std::log(losowaOtwarta(gen)) * nMniej1Odwr);
+                break;
+            }
+            Vprim = std::exp(std::log(losowaOtwarta(gen)) * nOdwr);
+        }
+        biezacy += S + 1;
+        emituj((uint64_t)biezacy);
+        N = N - 1 - S;
+        NRzecz = (double)N;
+        n--;
+        nRzecz -= 1.0;
+        nOdwr = nMniej1Odwr;
+        qu1 -= S;
+        qu1Rzecz = (double)qu1;
+        prog -= ALFA;
+    }
+
+    if (n == 1)
+    {
+        biezacy += (uint64_t)(NRzecz * Vprim) + 1;
+        emituj((uint64_t)biezacy);
+        return;
+    }
+
+    // Metoda A: pomijanie kolejnych indeksów z prawdopodobieństwem liczonym iloczynem.
+    double gora = NRzecz - nRzecz;
+    while (n >= 2)
+    {
+        double V = losowaOtwarta(gen);
+        uint64_t S = 0;
+        double iloraz = gora / NRzecz;
+        while (iloraz > V)
+        {
+            S++;
+            gora -= 1.0;
+            NRzecz -= 1.0;
+            iloraz = iloraz * gora / NRzecz;
+        }
+        biezacy += S + 1;
+        emituj((uint64_t)biezacy);
+        NRzecz -= 1.0;
+        n--;
+    }
+    biezacy += (uint64_t)(NRzecz * losowaOtwarta(gen)) + 1;
+    emituj((uint64_t)biezacy);
+}
+
+// Generator grafów losowych o dokładnie zadanej liczbie krawędzi, bez powtórzeń, w czasie
+// O(V + E). Krawędź (u, v), u < v, ma indeks w wierszowo spakowanym górnym trójkącie;
+// losowana jest rosnąca próbka indeksów, więc krawędzie wychodzą posortowane po (u, v).
+// Przy watki > 1 przedział indeksów jest dzielony na równe segmenty, a każdy segment
+// dostaje proporcjonalną część krawędzi i własny strumień liczb losowych - wynik jest
+// powtarzalny dla pary (ziarno, watki).
+class GeneratorGrafow
+{
+    uint64_t ziarno;
+    int watki;
+    int minWaga, maksWaga;
+
+    static uint64_t poczatekWiersza(uint64_t V, uint64_t u)
+    {
+        return u * (2 * V - u - 1) / 2;
+    }
+
+    // Losuje ile krawędzi o indeksach z [poczatek, poczatek + dlugosc) do wyjscie[0 .. ile).
+    void generujSegment(uint64_t V, int t, uint64_t poczatek, uint64_t dlugosc, uint64_t ile, Krawedz *wyjscie) const
+    {
+        std::seed_seq ziarnoSegmentu{(uint32_t)ziarno, (uint32_t)(ziarno >> 32), (uint32_t)t};
+        std::mt19937_64 gen(ziarnoSegmentu);
+        std::uniform_int_distribution<int> waga(minWaga, maksWaga);
+        uint64_t u = 0;
+        bool pierwsza = true;
+        losujPosortowane(ile, dlugosc, gen, [&](uint64_t i)
+                         {
+            uint64_t indeks = poczatek + i;
+            if (pierwsza)
+            {
+                // wiersz pierwszej krawędzi szukamy binarnie, potem wiersz tylko rośnie
+                uint64_t lo = 0, hi = V - 1;
+                while (lo + 1 < hi)
+                {
+                    uint64_t srodek = (lo + hi) / 2;
+                    if (poczatekWiersza(V, srodek) <= indeks)
+                        lo = srodek;
+                    else
+                        hi = srodek;
+                }
+                u = lo;
+                pierwsza = false;
+            }
+            while (poczatekWiersza(V, u + 1) <= indeks)
+                u++;
+            int v = (int)(u + 1 + indeks - poczatekWiersza(V, u));
+            *wyjscie++ = {(int)u, v, waga(gen)}; });
+    }
+
+public:
+    GeneratorGrafow(uint64_t ziarno, int watki = 1, int minWaga = 1, int maksWaga = 1000)
+        : ziarno(ziarno), watki(std::max(watki, 1)), minWaga(minWaga), maksWaga(maksWaga) {}
+
+    static int64_t liczbaKrawedzi(int V, double gestosc)
+    {
+        int64_t wszystkie = (int64_t)V * (V - 1) / 2;
+        return std::min(wszystkie, (int64_t)(gestosc / 100.0 * V * (V - 1) / 2));
+    }
+
+    std::vector<Krawedz> generujKrawedzie(int V, int64_t E) const
+    {
+        uint64_t N = (uint64_t)V * (V - 1) / 2;
+        E = std::min<int64_t>(std::max<int64_t>(E, 0), N);
+        std::vector<Krawedz> krawedzie(E);
+        int segmenty = (int)std::min<int64_t>(watki, std::max<int64_t>(E, 1));
+
+        // Podział E na segmenty proporcjonalnie do ich długości (metoda największych reszt).
+        std::vector<uint64_t> poczatek(segmenty + 1), ile(segmenty);
+        for (int t = 0; t <= segmenty; t++)
+            poczatek[t] = N / segmenty * t + std::min<uint64_t>(t, N % segmenty);
+        std::vector<std::pair<double, int>> reszty;
+        int64_t przydzielone = 0;
+        for (int t = 0; t < segmenty; t++)
+        {
+            double udzial = (double)E * (poczatek[t + 1] - poczatek[t]) / N;
+            ile[t] = std::min<uint64_t>((uint64_t)udzial, poczatek[t + 1] - poczatek[t]);
+            przydzielone += ile[t];
+            reszty.push_back({udzial - ile[t], t});
+        }
+        std::sort(reszty.rbegin(), reszty.rend());
+        for (size_t i = 0; przydzielone < E; i = (i + 1) % reszty.size())
+        {
+            int t = reszty[i].second;
+            if (ile[t] < poczatek[t + 1] - poczatek[t])
+            {
+                ile[t]++;
+                przydzielone++;
+            }
+        }
+        std::vector<int64_t> przesuniecie(segmenty + 1, 0);
+        for (int t = 0; t < segmenty; t++)
+            przesuniecie[t + 1] = przesuniecie[t] + ile[t];
+
+        rownolegle(segmenty, [&](int t)
+                   { generujSegment(V, t, poczatek[t], poczatek[t + 1] - poczatek[t], ile[t],
+                                    krawedzie.data() + przesuniecie[t]); });
+        return krawedzie;
+    }
+
+    // Wypełnia tylko te reprezentacje, dla których podano wskaźnik.
+    void generuj(int V, double gestosc, GrafMacierz *gm, GrafLista *gl, GrafCSR *gc, std::vector<Krawedz> *lista = nullptr) const
+    {
+        std::vector<Krawedz> krawedzie = generujKrawedzie(V, liczbaKrawedzi(V, gestosc));
+        if (gm)
+        {
+            gm->wyczysc(V);
+            for (const auto &k : krawedzie)
+                gm->dodajKrawedz(k.u, k.v, k.waga);
+        }
+        if (gl)
+        {
+            *gl = GrafLista(V);
+            for (const auto &k : krawedzie)
+                gl->dodajKrawedz(k.u, k.v, k.waga);
+        }
+        if (gc)
+            gc->zbudujZKrawedzi(V, krawedzie);
+        if (lista)
+            *lista = std::move(krawedzie);
+    }
+};
+
+inline void generujLosowyGraf(int V, double gestosc, GrafMacierz &gm, GrafCSR &gc, uint64_t ziarno = std::random_device{}())
+{
+    GeneratorGrafow(ziarno).generuj(V, gestosc, &gm, nullptr, &gc);
+}
+
+// Kolejki priorytetowe indeksowane numerem wierzchołka 0 .. n-1. Wspólny interfejs:
+//   ustaw(v, klucz) - wstawia v albo zmniejsza jego klucz (wywoływane tylko ze ściśle mniejszym kluczem),
+//   zdejmijMin()    - zwraca parę (klucz, v) o najmniejszym kluczu i usuwa ją z kolejki,
+//   pusta()         - czy w kolejce nie ma już wierzchołków.
+// Konstruktor przyjmuje liczbę wierzchołków i zakres kluczy (maks - min) obecnych
+// jednocześnie w kolejce; korzysta z niego tylko kolejka kubełkowa. przygotuj(n, zakres)
+// opróżnia kolejkę do ponownego użycia bez zwalniania jej tablic.
+enum class RodzajKolejki
+{
+    Binarna,   // std::priority_queue z leniwym usuwaniem nieaktualnych wpisów
+    DArna,     // kopiec 4-arny z prawdziwym zmniejszaniem klucza
+    Parujaca,  // kopiec parujący
+    Kubelkowa  // kolejka kubełkowa Diala dla ograniczonych wag całkowitych
+};
+
+inline const char *nazwaKolejki(RodzajKolejki rodzaj)
+{
+    switch (rodzaj)
+    {
+    case RodzajKolejki::DArna:
+        return "4-arna";
+    case RodzajKolejki::Parujaca:
+        return "parujaca";
+    case RodzajKolejki::Kubelkowa:
+        return "kubelkowa";
+    default:
+        return "binarna";
+    }
+}
+
+// Kopiec binarny z biblioteki standardowej. Zmniejszenie klucza dokłada nowy wpis,
+// a stare wpisy są pomijane przy zdejmowaniu, więc kopiec może urosnąć do O(E). Ta i pozostałe
+// kolejki są szablonami na typie klucza i numeru wierzchołka (domyślnie int), żeby obsłużyć
+// odległości int64 i grafy z V >= 2^31.
+template <typename Klucz = int, typename Id = int>
+class KolejkaLeniwa
+{
+    std::vector<std::pair<Klucz, Id>> kopiec; // kopiec minimum jak w std::priority_queue
+    std::vector<Klucz> klucz;
+    std::vector<bool> wKolejce;
+    Id rozmiar = 0;
+
+public:
+    KolejkaLeniwa(int64_t n = 0, int64_t zakres = 0)
+    {
+        przygotuj(n, zakres);
+    }
+
+    void przygotuj(int64_t n, int64_t)
+    {
+        kopiec.clear();
+        klucz.resize(n);
+        wKolejce.assign(n, false);
+        rozmiar = 0;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return kopiec.capacity() * sizeof(std::pair<Klucz, Id>) + klucz.capacity() * sizeof(Klucz) + wKolejce.capacity() / 8;
+    }
+
+    bool pusta() const
+    {
+        return rozmiar == 0;
+    }
+
+    void ustaw(Id v, Klucz k)
+    {
+        LICZ(wstawienia, 1);
+        if (!wKolejce[v])
+        {
+            wKolejce[v] = true;
+            rozmiar++;
+        }
+        klucz[v] = k;
+        kopiec.push_back({k, v});
+        std::push_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<Klucz, Id>>());
+    }
+
+    std::pair<Klucz, Id> zdejmijMin()
+    {
+        LICZ(zdjecia, 1);
+        while (!wKolejce[kopiec.front().second] || kopiec.front().first != klucz[kopiec.front().second])
+        {
+            LICZ(nieaktualne, 1);
+            std::pop_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<Klucz, Id>>());
+            kopiec.pop_back();
+        }
+        auto wynik = kopiec.front();
+        std::pop_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<Klucz, Id>>());
+        kopiec.pop_back();
+        wKolejce[wynik.second] = false;
+        rozmiar--;
+        return wynik;
+    }
+};
+
+template <int D, typename Klucz = int, typename Id = int>
+class KopiecDArny
+{
+    std::vector<Id> kopiec;  // wierzchołki w porządku kopca
+    std::vector<Id> pozycja; // indeks wierzchołka w kopiec albo -1
+    std::vector<Klucz> klucz;
+
+    void zamien(Id i, Id j)
+    {
+        std::swap(kopiec[i], kopiec[j]);
+        pozycja[kopiec[i]] = i;
+        pozycja[kopiec[j]] = j;
+    }
+
+    void wGore(Id i)
+    {
+        while (i > 0)
+        {
+            Id ojciec = (i - 1) / D;
+            if (klucz[kopiec[ojciec]] <= klucz[kopiec[i]])
+                break;
+            zamien(i, ojciec);
+            i = ojciec;
+        }
+    }
+
+    void wDol(Id i)
+    {
+        Id n = kopiec.size();
+        while (true)
+        {
+            Id pierwsze = i * D + 1;
+            if (pierwsze >= n)
+                break;
+            Id najmniejsze = pierwsze;
+            for (Id c = pierwsze + 1; c < std::min(pierwsze + D, n); c++)
+                if (klucz[kopiec[c]] < klucz[kopiec[najmniejsze]])
+                    najmniejsze = c;
+            if (klucz[kopiec[najmniejsze]] >= klucz[kopiec[i]])
+                break;
+            zamien(i, najmniejsze);
+            i = najmniejsze;
+        }
+    }
+
+public:
+    KopiecDArny(int64_t n = 0, int64_t zakres = 0)
+    {
+        przygotuj(n, zakres);
+    }
+
+    void przygotuj(int64_t n, int64_t)
+    {
+        kopiec.clear();
+        kopiec.reserve(n);
+        pozycja.assign(n, -1);
+        klucz.resize(n);
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return (kopiec.capacity() + pozycja.capacity()) * sizeof(Id) + klucz.capacity() * sizeof(Klucz);
+    }
+
+    bool pusta() const
+    {
+        return kopiec.empty();
+    }
+
+    void ustaw(Id v, Klucz k)
+    {
+        LICZ(wstawienia, 1);
+        klucz[v] = k;
+        if (pozycja[v] < 0)
+        {
+            pozycja[v] = kopiec.size();
+            kopiec.push_back(v);
+        }
+        wGore(pozycja[v]);
+    }
+
+    std::pair<Klucz, Id> zdejmijMin()
+    {
+        LICZ(zdjecia, 1);
+        Id v = kopiec[0];
+        zamien(0, kopiec.size() - 1);
+        kopiec.pop_back();
+        pozycja[v] = -1;
+        if (!kopiec.empty())
+            wDol(0);
+        return {klucz[v], v};
+    }
+};
+
+// Kopiec parujący na tablicach: każdy wierzchołek ma pierwsze dziecko, następnego
+// brata i poprzednika (ojca, jeśli jest pierwszym dzieckiem, w przeciwnym razie brata).
+template <typename Klucz = int, typename Id = int>
+class KopiecParujacy
+{
+    std::vector<Id> dziecko, brat, poprzedni;
+    std::vector<Klucz> klucz;
+    std::vector<bool> wKolejce;
+    std::vector<Id> pary;
+    Id korzen = -1;
+
+    Id scal(Id a, Id b)
+    {
+        if (a < 0)
+            return b;
+        if (b < 0)
+            return a;
+        if (klucz[b] < klucz[a])
+            std::swap(a, b);
+        brat[b] = dziecko[a];
+        if (dziecko[a] >= 0)
+            poprzedni[dziecko[a]] = b;
+        poprzedni[b] = a;
+        dziecko[a] = b;
+        return a;
+    }
+
+public:
+    KopiecParujacy(int64_t n = 0, int64_t zakres = 0)
+    {
+        przygotuj(n, zakres);
+    }
+
+    void przygotuj(int64_t n, int64_t)
+    {
+        dziecko.assign(n, -1);
+        brat.assign(n, -1);
+        poprzedni.assign(n, -1);
+        klucz.resize(n);
+        wKolejce.assign(n, false);
+        pary.clear();
+        korzen = -1;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return (dziecko.capacity() + brat.capacity() + poprzedni.capacity() + pary.capacity()) * sizeof(Id) +
+               klucz.capacity() * sizeof(Klucz) +
+               wKolejce.capacity() / 8;
+    }
+
+    bool pusta() const
+    {
+        return korzen < 0;
+    }
+
+    void ustaw(Id v, Klucz k)
+    {
+        LICZ(wstawienia, 1);
+        klucz[v] = k;
+        if (!wKolejce[v])
+        {
+            wKolejce[v] = true;
+            dziecko[v] = brat[v] = poprzedni[v] = -1;
+            korzen = scal(korzen, v);
+            return;
+        }
+        if (v == korzen)
+            return;
+        // odcinamy poddrzewo v i scalamy je z korzeniem
+        Id p = poprzedni[v];
+        if (dziecko[p] == v)
+            dziecko[p] = brat[v];
+        else
+            brat[p] = brat[v];
+        if (brat[v] >= 0)
+            poprzedni[brat[v]] = p;
+        brat[v] = poprzedni[v] = -1;
+        korzen = scal(korzen, v);
+    }
+
+    std::pair<Klucz, Id> zdejmijMin()
+    {
+        LICZ(zdjecia, 1);
+        Id min = korzen;
+        wKolejce[min] = false;
+
+        // łączenie dwuprzebiegowe: najpierw pary od lewej, potem od prawej do lewej
+        pary.clear();
+        Id c = dziecko[min];
+        while (c >= 0)
+        {
+            Id a = c, b = brat[c];
+            c = b >= 0 ? brat[b] : -1;
+            brat[a] = poprzedni[a] = -1;
+            if (b >= 0)
+                brat[b] = poprzedni[b] = -1;
+            pary.push_back(scal(a, b));
+        }
+        korzen = -1;
+        for (Id i = (Id)pary.size() - 1; i >= 0; i--)
+            korzen = scal(korzen, pary[i]);
+        if (korzen >= 0)
+            poprzedni[korzen] = -1;
+        return {klucz[min], min};
+    }
+};
+
+// Kolejka kubełkowa (Dial). Klucze obecne w kolejce mieszczą się w oknie
+// [kursor, kursor + zakres], więc wystarczy zakres + 1 kubełków indeksowanych
+// kluczem modulo zakres + 1. Kubełki to listy dwukierunkowe na tablicach,
+// dzięki czemu zmniejszenie klucza jest O(1). Kubełki są indeksowane kluczem typu int, więc
+// klucze 64-bitowe (odległości przy wagach int64) są odrzucane już przy kompilacji.
+template <typename Klucz = int, typename Id = int>
+class KolejkaKubelkowa
+{
+    static_assert(std::is_same_v<Klucz, int>, "kolejka kubełkowa obsługuje tylko klucze int (wagi do 32 bitów)");
+
+    int liczbaKubelkow = 1;
+    std::vector<Id> glowa;
+    std::vector<Id> nastepny, poprzedni;
+    std::vector<int> klucz;
+    std::vector<bool> wKolejce;
+    int kursor = 0;
+    Id rozmiar = 0;
+
+    int kubelek(int k) const
+    {
+        int r = k % liczbaKubelkow;
+        return r < 0 ? r + liczbaKubelkow : r;
+    }
+
+    void odlacz(Id v)
+    {
+        if (poprzedni[v] >= 0)
+            nastepny[poprzedni[v]] = nastepny[v];
+        else
+            glowa[kubelek(klucz[v])] = nastepny[v];
+        if (nastepny[v] >= 0)
+            poprzedni[nastepny[v]] = poprzedni[v];
+    }
+
+public:
+    KolejkaKubelkowa(int64_t n = 0, int64_t zakres = 0)
+    {
+        przygotuj(n, zakres);
+    }
+
+    // Czy zakres kluczy jest dość wąski na tablicę kubełków dla n wierzchołków; szersze
+    // zakresy (duże albo przeważone wagi) obsługuje kopiec.
+    static bool obsluguje(int64_t zakres, int64_t n)
+    {
+        return zakres >= 0 && zakres <= std::max<int64_t>(n, 1 << 20);
+    }
+
+    void przygotuj(int64_t n, int64_t zakres)
+    {
+        liczbaKubelkow = (int)zakres + 1;
+        glowa.assign(zakres + 1, -1);
+        nastepny.resize(n);
+        poprzedni.resize(n);
+        klucz.resize(n);
+        wKolejce.assign(n, false);
+        kursor = 0;
+        rozmiar = 0;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return (glowa.capacity() + nastepny.capacity() + poprzedni.capacity()) * sizeof(Id) + klucz.capacity() * sizeof(int) +
+               wKolejce.capacity() / 8;
+    }
+
+    bool pusta() const
+    {
+        return rozmiar == 0;
+    }
+
+    void ustaw(Id v, int k)
+    {
+        LICZ(wstawienia, 1);
+        if (wKolejce[v])
+        {
+            odlacz(v);
+        }
+        else
+        {
+            wKolejce[v] = true;
+            if (rozmiar++ == 0)
+                kursor = k;
+        }
+        klucz[v] = k;
+        kursor = std::min(kursor, k);
+        int b = kubelek(k);
+        poprzedni[v] = -1;
+        nastepny[v] = glowa[b];
+        if (glowa[b] >= 0)
+            poprzedni[glowa[b]] = v;
+        glowa[b] = v;
+    }
+
+    std::pair<int, Id> zdejmijMin()
+    {
+        LICZ(zdjecia, 1);
+        while (glowa[kubelek(kursor)] < 0)
+            kursor++;
+        Id v = glowa[kubelek(kursor)];
+        odlacz(v);
+        wKolejce[v] = false;
+        rozmiar--;
+        return {klucz[v], v};
+    }
+};
+
+// Obszar roboczy algorytmów. Tablice pomocnicze (klucze, rodzice, znaczniki, listy krawędzi)
+// są przydzielane kolejno z jednego bloku, a resetuj() zwalnia wszystkie naraz bez oddawania
+// pamięci. Przydział, który nie mieści się w bloku, dostaje osobny blok dodatkowy; najbliższe
+// resetuj() zastępuje wtedy wszystko jednym blokiem na cały dotychczasowy szczyt, więc od
+// drugiego przebiegu na grafie tego samego kształtu nic nie jest już przydzielane. Kolejki
+// priorytetowe też żyją w obszarze i są tylko przygotowywane od nowa; kolejki dla grafów
+// z innymi typami wag lub wierzchołków są tworzone przy pierwszym użyciu i też zachowywane.
+class ObszarRoboczy
+{
+    BuforWyrownany blok;
+    size_t zajete = 0;
+    std::vector<BuforWyrownany> dodatkowe;
+    size_t zajeteDodatkowe = 0;
+    size_t szczyt = 0;
+    std::tuple<KolejkaLeniwa<>, KopiecDArny<4>, KopiecParujacy<>, KolejkaKubelkowa<>> kolejki;
+    static constexpr int INNA = std::tuple_size<decltype(kolejki)>::value;
+    int ostatniaKolejka = -1; // indeks w kolejki kolejki wydanej od ostatniego resetuj() albo INNA
+
+    // Kolejki typów, których nie ma w kolejki (inne typy klucza lub wierzchołka), tworzone
+    // przy pierwszym użyciu. Kopia obszaru dostaje własne, puste - to tylko pamięć robocza.
+    struct InneKolejki
+    {
+        std::unordered_map<std::type_index, std::shared_ptr<void>> kolejki;
+        const void *ostatnia = nullptr;
+        size_t (*bajtyOstatniej)(const void *) = nullptr;
+
+        InneKolejki() = default;
+        InneKolejki(const InneKolejki &) {}
+        InneKolejki &operator=(const InneKolejki &)
+        {
+            kolejki.clear();
+            ostatnia = nullptr;
+            return *this;
+        }
+    } inne;
+
+    template <typename Kolejka, size_t I = 0>
+    static constexpr int indeksKolejki()
+    {
+        if constexpr (I == INNA)
+            return INNA;
+        else if constexpr (std::is_same<Kolejka, typename std::tuple_element<I, decltype(kolejki)>::type>::value)
+            return I;
+        else
+            return indeksKolejki<Kolejka, I + 1>();
+    }
+
+    template <typename Kolejka>
+    static size_t bajtyKolejki(const void *k)
+    {
+        return static_cast<const Kolejka *>(k)->pobierzRozmiarBajtow();
+    }
+
+public:
+    template <typename T>
+    T *przydziel(size_t n)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "obszar roboczy nie wywołuje destruktorów");
+        size_t bajty = std::max<size_t>((n * sizeof(T) + BuforWyrownany::WYROWNANIE - 1) / BuforWyrownany::WYROWNANIE *
+                                       BuforWyrownany::WYROWNANIE,
+                                   BuforWyrownany::WYROWNANIE);
+        unsigned char *p;
+        if (zajete + bajty <= blok.pobierzRozmiar())
+        {
+            p = blok.jako<unsigned char>() + zajete;
+            zajete += bajty;
+        }
+        else
+        {
+            dodatkowe.emplace_back(bajty);
+            p = dodatkowe.back().jako<unsigned char>();
+            zajeteDodatkowe += bajty;
+        }
+        szczyt = std::max(szczyt, zajete + zajeteDodatkowe);
+        T *wynik = reinterpret_cast<T *>(p);
+        std::uninitialized_default_construct_n(wynik, n);
+        return wynik;
+    }
+
+    template <typename T>
+    T *przydziel(size_t n, const T &wartosc)
+    {
+        T *wynik = przydziel<T>(n);
+        std::fill_n(wynik, n, wartosc);
+        return wynik;
+    }
+
+    // Kolejka danego typu przygotowana dla n wierzchołków; zachowuje pojemność z poprzednich przebiegów.
+    template <typename Kolejka>
+    Kolejka &kolejka(int64_t n, int64_t zakres)
+    {
+        constexpr int i = indeksKolejki<Kolejka>();
+        ostatniaKolejka = i;
+        Kolejka *k;
+        if constexpr (i < INNA)
+        {
+            k = &std::get<i>(kolejki);
+        }
+        else
+        {
+            std::shared_ptr<void> &inna = inne.kolejki[std::type_index(typeid(Kolejka))];
+            if (!inna)
+                inna = std::make_shared<Kolejka>();
+            k = static_cast<Kolejka *>(inna.get());
+            inne.ostatnia = k;
+            inne.bajtyOstatniej = bajtyKolejki<Kolejka>;
+        }
+        k->przygotuj(n, zakres);
+        return *k;
+    }
+
+    void resetuj()
+    {
+        if (!dodatkowe.empty())
+        {
+            dodatkowe.clear();
+            blok = BuforWyrownany(szczyt);
+        }
+        zajete = zajeteDodatkowe = 0;
+        ostatniaKolejka = -1;
+    }
+
+    // Bajty tablic przydzielonych od ostatniego resetuj().
+    size_t pobierzZajete() const
+    {
+        return zajete + zajeteDodatkowe;
+    }
+
+    // Bajty kolejki wydanej od ostatniego resetuj() (0, jeśli algorytm nie używał kolejki).
+    size_t pobierzBajtyKolejki() const
+    {
+        switch (ostatniaKolejka)
+        {
+        case 0:
+            return std::get<0>(kolejki).pobierzRozmiarBajtow();
+        case 1:
+            return std::get<1>(kolejki).pobierzRozmiarBajtow();
+        case 2:
+            return std::get<2>(kolejki).pobierzRozmiarBajtow();
+        case 3:
+            return std::get<3>(kolejki).pobierzRozmiarBajtow();
+        case INNA:
+            return inne.ostatnia ? inne.bajtyOstatniej(inne.ostatnia) : 0;
+        default:
+            return 0;
+        }
+    }
+};
+
+// Szczytowy rozmiar zbioru roboczego procesu (RSS) w kilobajtach, -1 gdy nieznany.
+inline int64_t szczytowyRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS liczniki;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &liczniki, sizeof(liczniki)))
+        return -1;
+    return (int64_t)(liczniki.PeakWorkingSetSize / 1024);
+#else
+    rusage zuzycie;
+    if (getrusage(RUSAGE_SELF, &zuzycie) != 0)
+        return -1;
+#ifdef __APPLE__
+    return zuzycie.ru_maxrss / 1024; // macOS podaje bajty
+#else
+    return zuzycie.ru_maxrss;
+#endif
+#endif
+}
+
+template <typename Id>
+struct WynikMSTOgolny
+{
+    std::vector<std::pair<Id, Id>> krawedzie;
+    int64_t waga = 0;
+};
+
+// odleglosci[v] == numeric_limits<D>::max() (INT_MAX w wariancie domyślnym) oznacza wierzchołek
+// nieosiągalny. poprzednik[v] to wierzchołek przed v na najkrótszej ścieżce (-1 dla źródła
+// i nieosiągalnych); warianty równoległe zostawiają go pustym - uzupełnia go wtedy
+// uzupelnijPoprzednikow.
+template <typename D, typename Id>
+struct WynikOdleglosciOgolny
+{
+    using Wierzcholek = Id;
+
+    std::vector<D> odleglosci;
+    std::vector<Id> poprzednik;
+    Id zrodlo = -1;
+    bool ujemnyCykl = false;
+};
+
+using WynikMST = WynikMSTOgolny<int>;
+using WynikOdleglosci = WynikOdleglosciOgolny<int, int>;
+
+// Typy wyników algorytmów listowych dla grafu o danych typach wagi i wierzchołka.
+template <typename Graf>
+using WynikMSTDla = WynikMSTOgolny<typename Graf::Wierzcholek>;
+
+template <typename Graf>
+using WynikOdleglosciDla = WynikOdleglosciOgolny<OdlegloscWag<Graf>, typename Graf::Wierzcholek>;
+
+// Odtwarza poprzedników z samych odległości: przeszukanie wszerz od źródła po łukach
+// (u, v), dla których odleglosci[u] + waga == odleglosci[v]. Przeszukanie, a nie wybór
+// dowolnego takiego łuku, gwarantuje drzewo także przy krawędziach o wadze 0.
+inline void uzupelnijPoprzednikow(WidokCSR graf, WynikOdleglosci &wynik)
+{
+    if (!wynik.poprzednik.empty() || wynik.zrodlo < 0 || wynik.ujemnyCykl)
+        return;
+    int V = graf.pobierzV();
+    const std::vector<int> &odleglosci = wynik.odleglosci;
+    wynik.poprzednik.assign(V, -1);
+    std::vector<int> kolejka;
+    std::vector<bool> odwiedzony(V, false);
+    kolejka.reserve(V);
+    kolejka.push_back(wynik.zrodlo);
+    odwiedzony[wynik.zrodlo] = true;
+    for (size_t i = 0; i < kolejka.size(); i++)
+    {
+        int u = kolejka[i];
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            int v = graf.sasiedzi[j];
+            if (!odwiedzony[v] && odleglosci[v] != INT_MAX && (SumaWag<WidokCSR>)odleglosci[u] + graf.wagi[j] == odleglosci[v])
+            {
+                odwiedzony[v] = true;
+                wynik.poprzednik[v] = u;
+                kolejka.push_back(v);
+            }
+        }
+    }
+}
+
+// Ścieżka od źródła do cel (włącznie z końcami); pusta, gdy cel jest nieosiągalny
+// albo wynik nie ma poprzedników.
+template <typename D, typename Id>
+std::vector<Id> odtworzSciezke(const WynikOdleglosciOgolny<D, Id> &wynik, typename WynikOdleglosciOgolny<D, Id>::Wierzcholek cel)
+{
+    std::vector<Id> sciezka;
+    if (wynik.poprzednik.empty() || wynik.ujemnyCykl || wynik.odleglosci[cel] == std::numeric_limits<D>::max())
+        return sciezka;
+    for (Id v = cel; v >= 0 && sciezka.size() <= wynik.poprzednik.size(); v = wynik.poprzednik[v])
+        sciezka.push_back(v);
+    if (sciezka.back() != wynik.zrodlo)
+        return {};
+    std::reverse(sciezka.begin(), sciezka.end());
+    return sciezka;
+}
+
+template <typename D, typename Id>
+void zapiszOdleglosci(Pisarz &p, const WynikOdleglosciOgolny<D, Id> &wynik)
+{
+    p << "Odległości od źródła " << wynik.zrodlo << ":\n";
+    for (size_t i = 0; i < wynik.odleglosci.size(); i++)
+        p << "Do wierzchołka " << i << ": " << wynik.odleglosci[i] << '\n';
+}
+
+template <typename Id>
+void zapiszKrawedzieMST(Pisarz &p, const WynikMSTOgolny<Id> &wynik)
+{
+    for (const auto &k : wynik.krawedzie)
+        p << k.first << " - " << k.second << '\n';
+}
+
+// Macierz V x V z wagami krawędzi MST, wypisywana wiersz po wierszu prosto z listy
+// krawędzi - bez budowania pełnej macierzy w pamięci.
+template <typename Macierz>
+void zapiszMacierzMST(Pisarz &p, const WynikMST &wynik, const Macierz &macierz)
+{
+    int V = macierz.pobierzV();
+    std::vector<int> poczatek(V + 1, 0), sasiedzi(2 * wynik.krawedzie.size());
+    for (const auto &k : wynik.krawedzie)
+        poczatek[k.first + 1]++, poczatek[k.second + 1]++;
+    for (int u = 0; u < V; u++)
+        poczatek[u + 1] += poczatek[u];
+    std::vector<int> pozycja(poczatek.begin(), poczatek.end() - 1);
+    for (const auto &k : wynik.krawedzie)
+    {
+        sasiedzi[pozycja[k.first]++] = k.second;
+        sasiedzi[pozycja[k.second]++] = k.first;
+    }
+    for (int u = 0; u < V; u++)
+    {
+        std::sort(sasiedzi.begin() + poczatek[u], sasiedzi.begin() + poczatek[u + 1]);
+        int j = poczatek[u];
+        for (int v = 0; v < V; v++)
+        {
+            if (j < poczatek[u + 1] && sasiedzi[j] == v)
+            {
+                p << macierz(u, v) << ' ';
+                while (j < poczatek[u + 1] && sasiedzi[j] == v)
+                    j++;
+            }
+            else
+            {
+                p << "0 ";
+            }
+        }
+        p << '\n';
+    }
+}
+
+// Zapis binarny (little-endian jak w pamięci): int32 V, int32 źródło, int32 ujemnyCykl,
+// V x int32 odległości (INT_MAX - nieosiągalny), V x int32 poprzedników (-1 - brak).
+inline void zapiszBinarnie(Pisarz &p, const WynikOdleglosci &wynik)
+{
+    int32_t naglowek[3] = {(int32_t)wynik.odleglosci.size(), wynik.zrodlo, wynik.ujemnyCykl};
+    p.binarnie(naglowek, sizeof(naglowek));
+    p.binarnie(wynik.odleglosci.data(), wynik.odleglosci.size() * sizeof(int));
+    if (wynik.poprzednik.size() == wynik.odleglosci.size())
+    {
+        p.binarnie(wynik.poprzednik.data(), wynik.poprzednik.size() * sizeof(int));
+    }
+    else
+    {
+        for (size_t i = 0; i < wynik.odleglosci.size(); i++)
+            p.binarnie(int32_t(-1));
+    }
+}
+
+// Zapis binarny MST: int64 liczba krawędzi, int64 waga, potem pary int32 (u, v).
+inline void zapiszBinarnie(Pisarz &p, const WynikMST &wynik)
+{
+    p.binarnie((int64_t)wynik.krawedzie.size());
+    p.binarnie(wynik.waga);
+    for (const auto &k : wynik.krawedzie)
+    {
+        int32_t para[2] = {k.first, k.second};
+        p.binarnie(para, sizeof(para));
+    }
+}
+
+// Wywołuje oblicz(widok) dla widoku pasującego do formatu macierzy i zwraca jego wynik.
+template <typename Wynik, typename F>
+Wynik zWidokiemMacierzy(const GrafMacierz &graf, F &&oblicz)
+{
+    Wynik wynik;
+    graf.zWidokiem([&](const auto &macierz)
+                   { wynik = oblicz(macierz); });
+    return wynik;
+}
+
+template <typename Macierz>
+WynikMST obliczPrimMSTMacierz(const Macierz &macierz, ObszarRoboczy &obszar)
+{
+    int V = macierz.pobierzV();
+    int *klucz = obszar.przydziel<int>(V, INT_MAX);
+    int *rodzic = obszar.przydziel<int>(V, -1);
+    bool *wMST = obszar.przydziel<bool>(V, false);
+    WynikMST wynik;
+    wynik.krawedzie.reserve(std::max(V - 1, 0));
+
+    klucz[0] = 0;
+
+    for (int licznik = 0; licznik < V - 1; licznik++)
+    {
+        int min = INT_MAX, u = -1;
+        for (int v = 0; v < V; v++)
+            if (!wMST[v] && klucz[v] < min)
+                min = klucz[v], u = v;
+
+        // pozostałe wierzchołki leżą poza składową wierzchołka 0
+        if (u < 0)
+            break;
+        wMST[u] = true;
+        LICZ(komorki, V);
+        for (int v = 0; v < V; v++)
+            if (macierz(u, v) && !wMST[v] && macierz(u, v) < klucz[v])
+            {
+                LICZ(relaksacje, 1);
+                rodzic[v] = u, klucz[v] = macierz(u, v);
+            }
+    }
+
+    for (int i = 1; i < V; i++)
+    {
+        if (rodzic[i] < 0)
+            continue;
+        wynik.krawedzie.push_back({rodzic[i], i});
+        wynik.waga += macierz(rodzic[i], i);
+    }
+    return wynik;
+}
+
+inline WynikMST obliczPrimMSTMacierz(const GrafMacierz &graf, ObszarRoboczy &obszar)
+{
+    return zWidokiemMacierzy<WynikMST>(graf, [&](const auto &macierz)
+                                       { return obliczPrimMSTMacierz(macierz, obszar); });
+}
+
+// Zestaw instrukcji jąder macierzowych Prima i Dijkstry. Jądro wybierane jest w czasie
+// działania, więc jeden plik wykonywalny działa na każdym procesorze x86-64.
+enum class ZestawInstrukcji
+{
+    Skalarny,
+    AVX2,  // 8 wierzchołków na instrukcję
+    AVX512 // 16 wierzchołków na instrukcję (AVX-512F)
+};
+
+inline const char *nazwaZestawu(ZestawInstrukcji zestaw)
+{
+    switch (zestaw)
+    {
+    case ZestawInstrukcji::AVX2:
+        return "avx2";
+    case ZestawInstrukcji::AVX512:
+        return "avx512";
+    default:
+        return "skalarny";
+    }
+}
+
+inline bool czyObslugiwany(ZestawInstrukcji zestaw)
+{
+#if GRAFY_WEKTORY
+    switch (zestaw)
+    {
+    case ZestawInstrukcji::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case ZestawInstrukcji::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    default:
+        return true;
+    }
+#else
+    return zestaw == ZestawInstrukcji::Skalarny;
+#endif
+}
+
+inline ZestawInstrukcji najlepszyZestawInstrukcji()
+{
+    static const ZestawInstrukcji zestaw = czyObslugiwany(ZestawInstrukcji::AVX512) ? ZestawInstrukcji::AVX512
+                                           : czyObslugiwany(ZestawInstrukcji::AVX2) ? ZestawInstrukcji::AVX2
+                                                                                    : ZestawInstrukcji::Skalarny;
+    return zestaw;
+}
+
+// Progi przełączania: przy progWatkow > V cały wiersz przeczesuje wątek wywołujący. Podział
+// wiersza kosztuje dwa przejścia przez pulę na wierzchołek, więc opłaca się dopiero, gdy
+// jeden wiersz przestaje mieścić się w pamięci podręcznej rdzenia.
+struct OpcjeJaderMacierzy
+{
+    ZestawInstrukcji zestaw = najlepszyZestawInstrukcji();
+    PulaWatkow *pula = nullptr;
+    int progWatkow = 1 << 16;
+};
+
+// Stan jąder macierzowych w tablicach o długości zaokrąglonej do WEKTOR: klucze (waga krawędzi
+// do drzewa albo odległość), rodzice i maska aktywnych wierzchołków (-1 - nieustalony, 0 -
+// ustalony albo dopełnienie). Maska ma szerokość klucza, więc jądra ładują ją jako gotową maskę
+// bitową bez rozszerzania bajtów, a nieaktywne dopełnienie zwalnia je z pętli na resztę.
+struct StanJadraMacierzy
+{
+    static constexpr int WEKTOR = 16;
+
+    int *klucz;
+    int *rodzic;
+    int32_t *aktywne;
+
+    StanJadraMacierzy(int V, ObszarRoboczy &obszar)
+    {
+        size_t n = dlugosc(V);
+        klucz = obszar.przydziel<int>(n, INT_MAX);
+        rodzic = obszar.przydziel<int>(n, -1);
+        aktywne = obszar.przydziel<int32_t>(n, 0);
+        std::fill_n(aktywne, V, -1);
+    }
+
+    static int dlugosc(int V)
+    {
+        return (V + WEKTOR - 1) / WEKTOR * WEKTOR;
+    }
+};
+
+// Najmniejszy klucz aktywnego wierzchołka; indeks -1, gdy żaden nie ma skończonego klucza.
+// Przy równych kluczach wygrywa najmniejszy indeks albo, z Ostatni, największy - tak jak
+// w skalarnych pętlach z < i <=, dzięki czemu jądra dają te same drzewa co wersje podstawowe.
+struct MinimumWiersza
+{
+    int wartosc = INT_MAX;
+    int indeks = -1;
+
+    template <bool Ostatni>
+    void polacz(int w, int i)
+    {
+        if (w < wartosc || (w == wartosc && w != INT_MAX && (Ostatni ? i > indeks : i < indeks)))
+            wartosc = w, indeks = i;
+    }
+};
+
+// Jeden przebieg jądra po kolumnach [od, do) wiersza u: relaksacja kluczy aktywnych wierzchołków
+// (waga krawędzi dla Prima, du + waga dla Dijkstry) połączona z wyszukaniem minimum dla
+// następnej iteracji, więc każda iteracja czyta wiersz i stan tylko raz.
+template <typename T, bool Dijkstra, bool Ostatni>
+MinimumWiersza przeczesWierszSkalarnie(const T *wiersz, int u, int du, StanJadraMacierzy s, int od, int doK)
+{
+    MinimumWiersza minimum;
+    for (int v = od; v < doK; v++)
+    {
+        if (!s.aktywne[v])
+            continue;
+        int w = wiersz[v];
+        int64_t nowa = Dijkstra ? (int64_t)du + w : w;
+        if (w && nowa < s.klucz[v])
+        {
+            LICZ(relaksacje, 1);
+            s.klucz[v] = (int)nowa;
+            s.rodzic[v] = u;
+        }
+        minimum.polacz<Ostatni>(s.klucz[v], v);
+    }
+    return minimum;
+}
+
+#if GRAFY_WEKTORY
+template <typename T>
+__attribute__((target("avx2"))) inline __m256i wczytajWagiAVX2(const T *p)
+{
+    if constexpr (std::is_same_v<T, uint8_t>)
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+    else if constexpr (std::is_same_v<T, uint16_t>)
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+    else
+        return _mm256_loadu_si256((const __m256i *)p);
+}
+
+template <bool Ostatni>
+inline MinimumWiersza redukujMinimum(const int *wartosci, const int *indeksy, int n)
+{
+    MinimumWiersza minimum;
+    for (int i = 0; i < n; i++)
+        minimum.polacz<Ostatni>(wartosci[i], indeksy[i]);
+    return minimum;
+}
+
+// Każda linia wektora pamięta swoje minimum i jego indeks; redukcja między liniami na końcu.
+// Suma du + w liczona jest w 32 bitach - przepełnienie (tylko dla w > 0) wykrywa porównanie
+// z du i wyłącza relaksację, tak jak porównanie w akumulatorze 64-bitowym w wersji skalarnej.
+template <typename T, bool Dijkstra, bool Ostatni>
+__attribute__((target("avx2"))) MinimumWiersza przeczesWierszAVX2(const T *wiersz, int u, int du, StanJadraMacierzy s, int od, int doK)
+{
+    const __m256i zero = _mm256_setzero_si256(), maks = _mm256_set1_epi32(INT_MAX), jedynki = _mm256_set1_epi32(-1);
+    const __m256i wu = _mm256_set1_epi32(u), wdu = _mm256_set1_epi32(du), krok = _mm256_set1_epi32(8);
+    __m256i minW = maks, minI = jedynki;
+    __m256i indeks = _mm256_add_epi32(_mm256_set1_epi32(od), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    for (int v = od; v < doK; v += 8)
+    {
+        __m256i w = wczytajWagiAVX2(wiersz + v);
+        __m256i klucz = _mm256_load_si256((const __m256i *)(s.klucz + v));
+        __m256i aktywne = _mm256_load_si256((const __m256i *)(s.aktywne + v));
+        __m256i nowa = Dijkstra ? _mm256_add_epi32(wdu, w) : w;
+        __m256i m = _mm256_andnot_si256(_mm256_cmpeq_epi32(w, zero), _mm256_and_si256(aktywne, _mm256_cmpgt_epi32(klucz, nowa)));
+        if constexpr (Dijkstra)
+        {
+            __m256i przepelnienie = _mm256_cmpgt_epi32(wdu, nowa);
+            if constexpr (std::is_signed_v<T>)
+                przepelnienie = _mm256_and_si256(przepelnienie, _mm256_cmpgt_epi32(w, zero));
+            m = _mm256_andnot_si256(przepelnienie, m);
+        }
+        if (!_mm256_testz_si256(m, m))
+        {
+            LICZ(relaksacje, __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(m))));
+            klucz = _mm256_blendv_epi8(klucz, nowa, m);
+            _mm256_store_si256((__m256i *)(s.klucz + v), klucz);
+            _mm256_maskstore_epi32(s.rodzic + v, m, wu);
+        }
+        __m256i wartosc = _mm256_blendv_epi8(maks, klucz, aktywne);
+        __m256i lepsze = Ostatni ? _mm256_xor_si256(_mm256_cmpgt_epi32(wartosc, minW), jedynki) : _mm256_cmpgt_epi32(minW, wartosc);
+        minW = _mm256_blendv_epi8(minW, wartosc, lepsze);
+        minI = _mm256_blendv_epi8(minI, indeks, lepsze);
+        indeks = _mm256_add_epi32(indeks, krok);
+    }
+    alignas(32) int wartosci[8], indeksy[8];
+    _mm256_store_si256((__m256i *)wartosci, minW);
+    _mm256_store_si256((__m256i *)indeksy, minI);
+    return redukujMinimum<Ostatni>(wartosci, indeksy, 8);
+}
+
+template <typename T>
+__attribute__((target("avx512f"))) inline __m512i wczytajWagiAVX512(const T *p)
+{
+    // wersje maskz, bo niezamaskowane zaczynają od _mm512_undefined_epi32, na które GCC 12 ostrzega
+    if constexpr (std::is_same_v<T, uint8_t>)
+        return _mm512_maskz_cvtepu8_epi32(0xFFFF, _mm_loadu_si128((const __m128i *)p));
+    else if constexpr (std::is_same_v<T, uint16_t>)
+        return _mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256((const __m256i *)p));
+    else
+        return _mm512_loadu_si512(p);
+}
+
+// Jak przeczesWierszAVX2, ale z rejestrami masek zamiast masek w wektorach.
+template <typename T, bool Dijkstra, bool Ostatni>
+__attribute__((target("avx512f"))) MinimumWiersza przeczesWierszAVX512(const T *wiersz, int u, int du, StanJadraMacierzy s, int od, int doK)
+{
+    const __m512i zero = _mm512_setzero_si512(), maks = _mm512_set1_epi32(INT_MAX);
+    const __m512i wu = _mm512_set1_epi32(u), wdu = _mm512_set1_epi32(du), krok = _mm512_set1_epi32(16);
+    __m512i minW = maks, minI = _mm512_set1_epi32(-1);
+    __m512i indeks = _mm512_add_epi32(_mm512_set1_epi32(od), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    for (int v = od; v < doK; v += 16)
+    {
+        __m512i w = wczytajWagiAVX512(wiersz + v);
+        __m512i klucz = _mm512_load_si512(s.klucz + v);
+        __m512i aktywneW = _mm512_load_si512(s.aktywne + v);
+        __mmask16 aktywne = _mm512_test_epi32_mask(aktywneW, aktywneW);
+        __m512i nowa = Dijkstra ? _mm512_add_epi32(wdu, w) : w;
+        __mmask16 m = _mm512_mask_cmplt_epi32_mask(aktywne & _mm512_test_epi32_mask(w, w), nowa, klucz);
+        if constexpr (Dijkstra)
+        {
+            __mmask16 przepelnienie = _mm512_cmplt_epi32_mask(nowa, wdu);
+            if constexpr (std::is_signed_v<T>)
+                przepelnienie &= _mm512_cmpgt_epi32_mask(w, zero);
+            m &= ~przepelnienie;
+        }
+        if (m)
+        {
+            LICZ(relaksacje, __builtin_popcount(m));
+            klucz = _mm512_mask_mov_epi32(klucz, m, nowa);
+            _mm512_store_si512(s.klucz + v, klucz);
+            _mm512_mask_storeu_epi32(s.rodzic + v, m, wu);
+        }
+        __m512i wartosc = _mm512_mask_mov_epi32(maks, aktywne, klucz);
+        __mmask16 lepsze = Ostatni ? _mm512_cmple_epi32_mask(wartosc, minW) : _mm512_cmplt_epi32_mask(wartosc, minW);
+        minW = _mm512_mask_mov_epi32(minW, lepsze, wartosc);
+        minI = _mm512_mask_mov_epi32(minI, lepsze, indeks);
+        indeks = _mm512_add_epi32(indeks, krok);
+    }
+    alignas(64) int wartosci[16], indeksy[16];
+    _mm512_store_si512(wartosci, minW);
+    _mm512_store_si512(indeksy, minI);
+    return redukujMinimum<Ostatni>(wartosci, indeksy, 16);
+}
+#endif
+
+template <typename T, bool Dijkstra, bool Ostatni>
+MinimumWiersza przeczesWiersz(ZestawInstrukcji zestaw, const T *wiersz, int u, int du, StanJadraMacierzy s, int od, int doK)
+{
+#if GRAFY_WEKTORY
+    if (zestaw == ZestawInstrukcji::AVX512)
+        return przeczesWierszAVX512<T, Dijkstra, Ostatni>(wiersz, u, du, s, od, doK);
+    if (zestaw == ZestawInstrukcji::AVX2)
+        return przeczesWierszAVX2<T, Dijkstra, Ostatni>(wiersz, u, du, s, od, doK);
+#endif
+    return przeczesWierszSkalarnie<T, Dijkstra, Ostatni>(wiersz, u, du, s, od, doK);
+}
+
+// Cały wiersz u (V kolumn zaokrąglonych do WEKTOR); od progu z opcji podzielony na ciągłe
+// kawałki wyrównane do WEKTOR, przeczesywane przez wątki puli, a minima kawałków łączone
+// w wątku wywołującym.
+template <typename T, bool Dijkstra, bool Ostatni>
+MinimumWiersza przeczesWiersz(const WidokMacierzy<T, false> &macierz, int u, int du, StanJadraMacierzy s,
+                              const OpcjeJaderMacierzy &opcje, MinimumWiersza *czesciowe)
+{
+    const T *wiersz = macierz.dane + (size_t)u * macierz.krok;
+    int n = StanJadraMacierzy::dlugosc(macierz.pobierzV());
+    LICZ(komorki, macierz.pobierzV());
+    if (!opcje.pula || opcje.pula->rozmiar() == 1 || macierz.pobierzV() < opcje.progWatkow)
+        return przeczesWiersz<T, Dijkstra, Ostatni>(opcje.zestaw, wiersz, u, du, s, 0, n);
+
+    opcje.pula->dlaPrzedzialow(n / StanJadraMacierzy::WEKTOR, [&](int t, int64_t od, int64_t doK)
+                               { czesciowe[t] = przeczesWiersz<T, Dijkstra, Ostatni>(opcje.zestaw, wiersz, u, du, s,
+                                                                                    (int)od * StanJadraMacierzy::WEKTOR,
+                                                                                    (int)doK * StanJadraMacierzy::WEKTOR); });
+    MinimumWiersza minimum;
+    for (int t = 0; t < opcje.pula->rozmiar(); t++)
+        minimum.polacz<Ostatni>(czesciowe[t].wartosc, czesciowe[t].indeks);
+    return minimum;
+}
+
+// Prim na pełnej macierzy z jądrami wektorowymi; wynik identyczny z obliczPrimMSTMacierz.
+// Macierz trójkątna nie ma ciągłych wierszy, więc dla niej liczy wersja podstawowa.
+template <typename T>
+WynikMST obliczPrimMSTMacierzWektorowo(const WidokMacierzy<T, false> &macierz, ObszarRoboczy &obszar,
+                                      const OpcjeJaderMacierzy &opcje = {})
+{
+    int V = macierz.pobierzV();
+    WynikMST wynik;
+    if (V == 0)
+        return wynik;
+    StanJadraMacierzy s(V, obszar);
+    MinimumWiersza *czesciowe = obszar.przydziel<MinimumWiersza>(opcje.pula ? opcje.pula->rozmiar() : 1);
+    wynik.krawedzie.reserve(V - 1);
+
+    s.klucz[0] = 0;
+    int u = 0;
+    for (int licznik = 0; licznik < V - 1; licznik++)
+    {
+        s.aktywne[u] = 0;
+        u = przeczesWiersz<T, false, false>(macierz, u, 0, s, opcje, czesciowe).indeks;
+        // pozostałe wierzchołki leżą poza składową wierzchołka 0
+        if (u < 0)
+            break;
+    }
+
+    for (int i = 1; i < V; i++)
+    {
+        if (s.rodzic[i] < 0)
+            continue;
+        wynik.krawedzie.push_back({s.rodzic[i], i});
+        wynik.waga += macierz(s.rodzic[i], i);
+    }
+    return wynik;
+}
+
+template <typename T>
+WynikMST obliczPrimMSTMacierzWektorowo(const WidokMacierzy<T, true> &macierz, ObszarRoboczy &obszar,
+                                      const OpcjeJaderMacierzy & = {})
+{
+    return obliczPrimMSTMacierz(macierz, obszar);
+}
+
+inline WynikMST obliczPrimMSTMacierzWektorowo(const GrafMacierz &graf, ObszarRoboczy &obszar, const OpcjeJaderMacierzy &opcje = {})
+{
+    return zWidokiemMacierzy<WynikMST>(graf, [&](const auto &macierz)
+                                       { return obliczPrimMSTMacierzWektorowo(macierz, obszar, opcje); });
+}
+
+template <typename Kolejka, typename W, typename Id>
+WynikMSTOgolny<Id> obliczPrimMSTLista(WidokCSROgolny<W, Id> graf, ObszarRoboczy &obszar)
+{
+    using Klucz = typename CechyWagi<W>::Odleglosc;
+    Id V = graf.pobierzV();
+    WynikMSTOgolny<Id> wynik;
+    if (V == 0)
+        return wynik;
+    int64_t zakres = CechyWagi<W>::WASKIE ? std::min<int64_t>((int64_t)graf.maksWaga - graf.minWaga, INT_MAX) : 0;
+    Kolejka &kolejka = obszar.kolejka<Kolejka>(V, zakres);
+    Klucz *klucz = obszar.przydziel<Klucz>(V, CechyWagi<W>::NIESKONCZONOSC);
+    Id *rodzic = obszar.przydziel<Id>(V, -1);
+    bool *wMST = obszar.przydziel<bool>(V, false);
+    wynik.krawedzie.reserve(V - 1);
+
+    Id src = 0;
+    kolejka.ustaw(src, 0);
+    klucz[src] = 0;
+
+    while (!kolejka.pusta())
+    {
+        Id u = kolejka.zdejmijMin().second;
+        wMST[u] = true;
+
+        LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            Id v = graf.sasiedzi[j];
+            Klucz waga = graf.wagi[j];
+            if (!wMST[v] && klucz[v] > waga)
+            {
+                LICZ(relaksacje, 1);
+                klucz[v] = waga;
+                kolejka.ustaw(v, waga);
+                rodzic[v] = u;
+            }
+        }
+    }
+
+    // klucz[i] to waga krawędzi (rodzic[i], i); wierzchołki spoza składowej źródła pomijamy
+    for (Id i = 1; i < V; ++i)
+    {
+        if (rodzic[i] < 0)
+            continue;
+        wynik.krawedzie.push_back({rodzic[i], i});
+        wynik.waga += klucz[i];
+    }
+    return wynik;
+}
+
+// Przyjmuje WidokCSROgolny albo GrafCSROgolny dowolnych typów wagi i wierzchołka. Kolejka
+// kubełkowa nie obsługuje wag int64 ani zbyt szerokiego zakresu wag - wtedy pracuje kopiec 4-arny.
+template <typename Graf>
+WynikMSTDla<Graf> obliczPrimMSTLista(const Graf &graf, ObszarRoboczy &obszar, RodzajKolejki rodzaj = RodzajKolejki::Binarna)
+{
+    using W = typename Graf::Waga;
+    using Id = typename Graf::Wierzcholek;
+    using Klucz = OdlegloscWag<Graf>;
+    typename Graf::Widok g = graf;
+    if (rodzaj == RodzajKolejki::Kubelkowa &&
+        (!CechyWagi<W>::WASKIE || !KolejkaKubelkowa<>::obsluguje((int64_t)g.maksWaga - g.minWaga, g.pobierzV())))
+        rodzaj = RodzajKolejki::DArna;
+    switch (rodzaj)
+    {
+    case RodzajKolejki::Kubelkowa:
+        if constexpr (CechyWagi<W>::WASKIE)
+            return obliczPrimMSTLista<KolejkaKubelkowa<Klucz, Id>>(g, obszar);
+        [[fallthrough]];
+    case RodzajKolejki::DArna:
+        return obliczPrimMSTLista<KopiecDArny<4, Klucz, Id>>(g, obszar);
+    case RodzajKolejki::Parujaca:
+        return obliczPrimMSTLista<KopiecParujacy<Klucz, Id>>(g, obszar);
+    default:
+        return obliczPrimMSTLista<KolejkaLeniwa<Klucz, Id>>(g, obszar);
+    }
+}
+
+template <typename Id = int>
+class DSU
+{
+    std::vector<Id> rodzic;
+    std::vector<int> ranga;
+
+public:
+    DSU(Id n)
+    {
+        rodzic.resize(n);
+        ranga.resize(n);
+        for (Id i = 0; i < n; i++)
+        {
+            rodzic[i] = i;
+            ranga[i] = 0;
+        }
+    }
+
+    Id znajdz(Id u)
+    {
+        if (u != rodzic[u])
+            rodzic[u] = znajdz(rodzic[u]);
+        return rodzic[u];
+    }
+
+    void polacz(Id u, Id v)
+    {
+        u = znajdz(u);
+        v = znajdz(v);
+        if (u != v)
+        {
+            if (ranga[u] < ranga[v])
+            {
+                rodzic[u] = v;
+            }
+            else if (ranga[u] > ranga[v])
+            {
+                rodzic[v] = u;
+            }
+            else
+            {
+                rodzic[v] = u;
+                ranga[u]++;
+            }
+        }
+    }
+};
+
+// Zbiory rozłączne z łączeniem według rozmiaru i połowieniem ścieżek. Rodzic i rozmiar siedzą
+// w jednej tablicy: wartość ujemna oznacza korzeń i jest minus rozmiarem jego zbioru.
+// Znajdowanie jest iteracyjne, więc długie łańcuchy nie przepełniają stosu. Id to typ numeru
+// elementu (ze znakiem); ZbiorRozlaczny zbiory(V) wyprowadza go z typu V.
+template <typename Id = int>
+class ZbiorRozlaczny
+{
+    std::vector<Id> rodzic;
+
+public:
+    explicit ZbiorRozlaczny(Id n) : rodzic(n, -1)
+    {
+    }
+
+    Id znajdz(Id u)
+    {
+        LICZ(znajdz, 1);
+        while (rodzic[u] >= 0)
+        {
+            LICZ(krokiZnajdz, 1);
+            Id p = rodzic[u];
+            if (rodzic[p] >= 0)
+            {
+                rodzic[u] = rodzic[p];
+                p = rodzic[p];
+            }
+            u = p;
+        }
+        return u;
+    }
+
+    // Korzeń bez skracania ścieżek - nie zmienia struktury, więc może być wołany z wielu wątków naraz.
+    Id korzen(Id u) const
+    {
+        LICZ(znajdz, 1);
+        while (rodzic[u] >= 0)
+        {
+            LICZ(krokiZnajdz, 1);
+            u = rodzic[u];
+        }
+        return u;
+    }
+
+    // Łączy zbiory u i v; zwraca false, jeśli już były tym samym zbiorem.
+    bool polacz(Id u, Id v)
+    {
+        u = znajdz(u);
+        v = znajdz(v);
+        if (u == v)
+            return false;
+        if (rodzic[u] > rodzic[v]) // u jest mniejszy
+            std::swap(u, v);
+        rodzic[u] += rodzic[v];
+        rodzic[v] = u;
+        return true;
+    }
+
+    Id rozmiar(Id u)
+    {
+        return -rodzic[znajdz(u)];
+    }
+};
+
+// Wersja bez blokad dla wielu wątków: rodzic jest atomowy, połowienie ścieżek robi CAS, który
+// może się nie udać (ścieżka i tak pozostaje poprawna), a łączenie podczepia korzeń o mniejszym
+// numerze pod korzeń o większym jednym CAS-em - przy porażce ktoś inny zmienił ten korzeń
+// i próba jest powtarzana. Kolejność według numerów wyklucza cykle bez pamiętania rozmiarów.
+class ZbiorRozlacznyWspolbiezny
+{
+    std::vector<std::atomic<int>> rodzic;
+
+public:
+    explicit ZbiorRozlacznyWspolbiezny(int n) : rodzic(n)
+    {
+        for (int i = 0; i < n; i++)
+            rodzic[i].store(i, std::memory_order_relaxed);
+    }
+
+    int znajdz(int u)
+    {
+        LICZ(znajdz, 1);
+        while (true)
+        {
+            int p = rodzic[u].load(std::memory_order_relaxed);
+            if (p == u)
+                return u;
+            LICZ(krokiZnajdz, 1);
+            int pp = rodzic[p].load(std::memory_order_relaxed);
+            if (pp != p)
+                rodzic[u].compare_exchange_weak(p, pp, std::memory_order_relaxed);
+            u = pp;
+        }
+    }
+
+    bool polacz(int u, int v)
+    {
+        while (true)
+        {
+            u = znajdz(u);
+            v = znajdz(v);
+            if (u == v)
+                return false;
+            if (u > v)
+                std::swap(u, v);
+            int oczekiwany = u;
+            if (rodzic[u].compare_exchange_strong(oczekiwany, v, std::memory_order_acq_rel))
+                return true;
+        }
+    }
+
+    // Czy u i v są w jednym zbiorze. Powtarza, dopóki korzeń u nie jest nadal korzeniem po
+    // znalezieniu korzenia v - inaczej równoległe łączenie mogło zmienić odpowiedź w trakcie.
+    bool polaczone(int u, int v)
+    {
+        while (true)
+        {
+            u = znajdz(u);
+            v = znajdz(v);
+            if (u == v)
+                return true;
+            if (rodzic[u].load(std::memory_order_acquire) == u)
+                return false;
+        }
+    }
+};
+
+
+template <typename Macierz>
+WynikMST obliczKruskalMSTMacierz(const Macierz &macierz, ObszarRoboczy &obszar)
+{
+    int V = macierz.pobierzV();
+    WynikMST wynik;
+    wynik.krawedzie.reserve(std::max(V - 1, 0));
+
+    // najpierw liczymy krawędzie, żeby tablica z obszaru roboczego miała dokładny rozmiar
+    size_t E = 0;
+    LICZ(komorki, (int64_t)V * (V - 1));
+    for (int u = 0; u < V; u++)
+        for (int v = u + 1; v < V; v++)
+            E += macierz(u, v) != 0;
+    Krawedz *krawedzie = obszar.przydziel<Krawedz>(E);
+    size_t i = 0;
+    for (int u = 0; u < V; u++)
+    {
+        for (int v = u + 1; v < V; v++)
+        {
+            if (macierz(u, v))
+            {
+                krawedzie[i++] = {u, v, macierz(u, v)};
+            }
+        }
+    }
+
+    std::sort(krawedzie, krawedzie + E);
+
+    ZbiorRozlaczny zbiory(V);
+    for (size_t j = 0; j < E; j++)
+    {
+        const Krawedz &krawedz = krawedzie[j];
+        if (zbiory.polacz(krawedz.u, krawedz.v))
+        {
+            wynik.krawedzie.push_back({krawedz.u, krawedz.v});
+            wynik.waga += krawedz.waga;
+        }
+    }
+    return wynik;
+}
+
+inline WynikMST obliczKruskalMSTMacierz(const GrafMacierz &graf, ObszarRoboczy &obszar)
+{
+    return zWidokiemMacierzy<WynikMST>(graf, [&](const auto &macierz)
+                                       { return obliczKruskalMSTMacierz(macierz, obszar); });
+}
+
+// Przyjmuje WidokCSROgolny albo GrafCSROgolny dowolnych typów wagi i wierzchołka; krawędzie
+// sortuje std::sort, więc działa też dla wag int64.
+template <typename Graf>
+WynikMSTDla<Graf> obliczKruskalMSTLista(const Graf &graf, ObszarRoboczy &obszar)
+{
+    using Id = typename Graf::Wierzcholek;
+    using KrawedzGrafu = KrawedzOgolna<typename Graf::Waga, Id>;
+    typename Graf::Widok g = graf;
+    Id V = g.pobierzV();
+    WynikMSTDla<Graf> wynik;
+    wynik.krawedzie.reserve(std::max<Id>(V - 1, 0));
+
+    // każda krawędź u < v występuje w CSR dwa razy, więc połowa łuków to górne ograniczenie
+    KrawedzGrafu *krawedzie = obszar.przydziel<KrawedzGrafu>(g.offsety[V] / 2);
+    size_t E = 0;
+    LICZ(krawedzie, g.offsety[V]);
+    for (Id u = 0; u < V; u++)
+    {
+        for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+        {
+            Id v = g.sasiedzi[j];
+            if (u < v)
+            {
+                krawedzie[E++] = {u, v, g.wagi[j]};
+            }
+        }
+    }
+
+    std::sort(krawedzie, krawedzie + E);
+
+    ZbiorRozlaczny zbiory(V);
+    for (size_t j = 0; j < E; j++)
+    {
+        const KrawedzGrafu &krawedz = krawedzie[j];
+        if (zbiory.polacz(krawedz.u, krawedz.v))
+        {
+            wynik.krawedzie.push_back({krawedz.u, krawedz.v});
+            wynik.waga += krawedz.waga;
+        }
+    }
+    return wynik;
+}
+
+// Krawędzie grafu w jednej ciągłej tablicy wraz z zakresem wag (potrzebnym do sortowania pozycyjnego).
+struct ZbiorKrawedzi
+{
+    std::vector<Krawedz> krawedzie;
+    int minWaga = 0, maksWaga = 0;
+};
+
+// Dwa przejścia po wierszach: najpierw liczba krawędzi (u, v), u < v, w każdym wierszu, potem po
+// sumach prefiksowych każdy wiersz zapisuje swoje krawędzie od własnej pozycji. Wiersze są
+// rozdzielane między wątki na przemian, bo w trójkącie macierzy kolejne wiersze są coraz krótsze.
+// Kolejność krawędzi nie zależy od liczby wątków.
+template <typename F, typename G>
+ZbiorKrawedzi zbierzKrawedzie(int V, PulaWatkow &pula, F &&policzWiersz, G &&wypelnijWiersz)
+{
+    ZbiorKrawedzi zbior;
+    int p = pula.rozmiar();
+    std::vector<int64_t> pozycje(V + 1, 0);
+    pula.wykonaj([&](int t)
+                 {
+        for (int u = t; u < V; u += p)
+            pozycje[u + 1] = policzWiersz(u); });
+    for (int u = 0; u < V; u++)
+        pozycje[u + 1] += pozycje[u];
+    zbior.krawedzie.resize(pozycje[V]);
+
+    std::vector<int> minWatku(p, INT_MAX), maksWatku(p, INT_MIN);
+    pula.wykonaj([&](int t)
+                 {
+        for (int u = t; u < V; u += p)
+        {
+            Krawedz *cel = zbior.krawedzie.data() + pozycje[u];
+            int64_t ile = wypelnijWiersz(u, cel);
+            for (int64_t i = 0; i < ile; i++)
+            {
+                minWatku[t] = std::min(minWatku[t], cel[i].waga);
+                maksWatku[t] = std::max(maksWatku[t], cel[i].waga);
+            }
+        } });
+    if (!zbior.krawedzie.empty())
+    {
+        zbior.minWaga = *std::min_element(minWatku.begin(), minWatku.end());
+        zbior.maksWaga = *std::max_element(maksWatku.begin(), maksWatku.end());
+    }
+    return zbior;
+}
+
+template <typename Macierz>
+ZbiorKrawedzi wyodrebnijKrawedzie(const Macierz &macierz, PulaWatkow &pula)
+{
+    return zbierzKrawedzie(
+        macierz.pobierzV(), pula,
+        [&](int u)
+        {
+            int64_t ile = 0;
+            LICZ(komorki, macierz.pobierzV() - u - 1);
+            for (int v = u + 1; v < macierz.pobierzV(); v++)
+                ile += macierz(u, v) != 0;
+            return ile;
+        },
+        [&](int u, Krawedz *cel)
+        {
+            int64_t ile = 0;
+            for (int v = u + 1; v < macierz.pobierzV(); v++)
+                if (macierz(u, v))
+                    cel[ile++] = {u, v, macierz(u, v)};
+            return ile;
+        });
+}
+
+inline ZbiorKrawedzi wyodrebnijKrawedzie(WidokCSR graf, PulaWatkow &pula)
+{
+    return zbierzKrawedzie(
+        graf.pobierzV(), pula,
+        [&](int u)
+        {
+            int64_t ile = 0;
+            LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+            for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+                ile += u < graf.sasiedzi[j];
+            return ile;
+        },
+        [&](int u, Krawedz *cel)
+        {
+            int64_t ile = 0;
+            for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+                if (u < graf.sasiedzi[j])
+                    cel[ile++] = {u, graf.sasiedzi[j], graf.wagi[j]};
+            return ile;
+        });
+}
+
+// Stabilnie rozrzuca n krawędzi (dowolnego typu) ze zrodlo do cel według klasa(k) z [0, liczbaKlas): każdy wątek
+// liczy histogram swojego ciągłego fragmentu, a potem zapisuje go od pozycji wyznaczonej przez
+// sumy prefiksowe (klasa główna, wątek drugorzędny). Dla małych n działa w jednym wątku.
+// Zwraca liczności klas.
+template <typename T, typename F>
+std::vector<int64_t> rozrzucKrawedzie(const T *zrodlo, T *cel, int64_t n, int liczbaKlas, F &&klasa,
+                                 PulaWatkow &pula)
+{
+    const int64_t PROG_ROWNOLEGLY = 1 << 15;
+    int p = n >= PROG_ROWNOLEGLY ? pula.rozmiar() : 1;
+    std::vector<int64_t> liczniki((size_t)p * liczbaKlas, 0);
+    auto naWatkach = [&](auto &&f)
+    {
+        if (p == 1)
+            f(0, 0, n);
+        else
+            pula.dlaPrzedzialow(n, f);
+    };
+
+    naWatkach([&](int t, int64_t od, int64_t doK)
+              {
+        int64_t *h = &liczniki[(size_t)t * liczbaKlas];
+        for (int64_t i = od; i < doK; i++)
+            h[klasa(zrodlo[i])]++; });
+
+    std::vector<int64_t> licznosci(liczbaKlas, 0);
+    int64_t suma = 0;
+    for (int k = 0; k < liczbaKlas; k++)
+    {
+        for (int t = 0; t < p; t++)
+        {
+            int64_t c = liczniki[(size_t)t * liczbaKlas + k];
+            liczniki[(size_t)t * liczbaKlas + k] = suma;
+            suma += c;
+            licznosci[k] += c;
+        }
+    }
+
+    naWatkach([&](int t, int64_t od, int64_t doK)
+              {
+        int64_t *h = &liczniki[(size_t)t * liczbaKlas];
+        for (int64_t i = od; i < doK; i++)
+            cel[h[klasa(zrodlo[i])]++] = zrodlo[i]; });
+    return licznosci;
+}
+
+// Sortowanie pozycyjne LSD po wadze z cyframi 8-bitowymi. Liczba przebiegów zależy od zakresu
+// wag (wagi 1..255 to jedno sortowanie przez zliczanie), a nie od liczby krawędzi. Klucz sortowania
+// ma 32 bity, więc krawędzie z wagami int64 są odrzucane przy kompilacji (sortuje je std::sort).
+template <typename W, typename Id>
+void sortujPoWadze(KrawedzOgolna<W, Id> *krawedzie, KrawedzOgolna<W, Id> *bufor, int64_t n, W minWaga, W maksWaga,
+                   PulaWatkow &pula)
+{
+    static_assert(CechyWagi<W>::WASKIE, "sortowanie pozycyjne obsługuje tylko wagi do 32 bitów");
+    const int BITY = 8;
+    uint32_t zakres = (uint32_t)((int64_t)maksWaga - minWaga);
+    KrawedzOgolna<W, Id> *zrodlo = krawedzie, *cel = bufor;
+    for (int przesuniecie = 0; przesuniecie < 32 && (zakres >> przesuniecie) > 0; przesuniecie += BITY)
+    {
+        rozrzucKrawedzie(zrodlo, cel, n, 1 << BITY, [=](const KrawedzOgolna<W, Id> &k)
+                         { return (int)(((uint32_t)((int64_t)k.waga - minWaga) >> przesuniecie) & ((1 << BITY) - 1)); },
+                         pula);
+        std::swap(zrodlo, cel);
+    }
+    if (zrodlo != krawedzie)
+        std::copy(zrodlo, zrodlo + n, krawedzie);
+}
+
+enum class TrybKruskala
+{
+    Pozycyjny,  // sortowanie pozycyjne wszystkich krawędzi, potem jedno przejście po zbiorach rozłącznych
+    Filtrujacy  // filter-Kruskal: sortowane są tylko krawędzie, które mogą jeszcze wejść do MST
+};
+
+inline const char *nazwaTrybuKruskala(TrybKruskala tryb)
+{
+    return tryb == TrybKruskala::Filtrujacy ? "filtrujacy" : "pozycyjny";
+}
+
+struct StatystykiKruskala
+{
+    int64_t krawedzie = 0;   // wszystkie krawędzie grafu
+    int64_t posortowane = 0; // krawędzie, które przeszły przez sortowanie
+    int64_t odrzucone = 0;   // krawędzie odfiltrowane bez sortowania
+    double czasEkstrakcji = 0, czasSortowania = 0, czasFiltrowania = 0, czasLaczenia = 0; // milisekundy
+};
+
+inline std::string opiszStatystyki(const StatystykiKruskala &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(3) << "krawedzie=" << st.krawedzie << " posortowane=" << st.posortowane
+         << " odrzucone=" << st.odrzucone << " ekstrakcja_ms=" << st.czasEkstrakcji
+         << " sortowanie_ms=" << st.czasSortowania << " filtrowanie_ms=" << st.czasFiltrowania
+         << " laczenie_ms=" << st.czasLaczenia;
+    return opis.str();
+}
+
+// Filter-Kruskal (V. Osipov, P. Sanders, J. Singler, "The Filter-Kruskal Minimum Spanning
+// Tree Algorithm", 2009): krawędzie dzielone są względem wagi-piwota na lżejsze, równe
+// i cięższe; lżejsze przetwarzane są rekurencyjnie, a z cięższych przed rekurencją usuwane są
+// te, których końce są już połączone. Praca kończy się po znalezieniu V - 1 krawędzi, więc
+// w gęstych grafach większość ciężkich krawędzi nigdy nie jest sortowana.
+class SilnikKruskala
+{
+    int V;
+    Krawedz *krawedzie;
+    std::vector<Krawedz> bufor;
+    PulaWatkow &pula;
+    ZbiorRozlaczny<> zbiory;
+    StatystykiKruskala &st;
+
+    static double ms(std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration<double, std::milli>(d).count();
+    }
+
+    bool gotowe() const
+    {
+        return (int)wynik.krawedzie.size() >= V - 1;
+    }
+
+    void polaczPosortowane(int64_t od, int64_t doK)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int64_t i = od; i < doK && !gotowe(); i++)
+        {
+            const Krawedz &k = krawedzie[i];
+            if (zbiory.polacz(k.u, k.v))
+            {
+                wynik.krawedzie.push_back({k.u, k.v});
+                wynik.waga += k.waga;
+            }
+        }
+        st.czasLaczenia += ms(std::chrono::steady_clock::now() - t0);
+    }
+
+    void sortujIPolacz(int64_t od, int64_t doK, int minWaga, int maksWaga)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        sortujPoWadze(krawedzie + od, bufor.data() + od, doK - od, minWaga, maksWaga, pula);
+        st.posortowane += doK - od;
+        st.czasSortowania += ms(std::chrono::steady_clock::now() - t0);
+        polaczPosortowane(od, doK);
+    }
+
+    // Mediana próbki wag rozłożonej równomiernie po przedziale.
+    int wybierzPiwot(int64_t od, int64_t doK) const
+    {
+        const int PROBKA = 31;
+        int wagi[PROBKA];
+        for (int i = 0; i < PROBKA; i++)
+            wagi[i] = krawedzie[od + (doK - od) * i / PROBKA].waga;
+        std::nth_element(wagi, wagi + PROBKA / 2, wagi + PROBKA);
+        return wagi[PROBKA / 2];
+    }
+
+    // Zostawia na początku przedziału tylko krawędzie łączące różne składowe i zwraca ich liczbę.
+    // Znajdowanie korzeni bez skracania ścieżek nie modyfikuje zbiorów, więc wątki mogą je dzielić.
+    int64_t odfiltruj(int64_t od, int64_t doK)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<int64_t> licznosci = rozrzucKrawedzie(krawedzie + od, bufor.data() + od, doK - od, 2, [&](const Krawedz &k)
+                                                     { return zbiory.korzen(k.u) == zbiory.korzen(k.v) ? 1 : 0; },
+                                                     pula);
+        std::copy(bufor.data() + od, bufor.data() + od + licznosci[0], krawedzie + od);
+        st.odrzucone += licznosci[1];
+        st.czasFiltrowania += ms(std::chrono::steady_clock::now() - t0);
+        return licznosci[0];
+    }
+
+    void filtruj(int64_t od, int64_t doK, int minWaga, int maksWaga)
+    {
+        const int64_t PROG_SORTOWANIA = 1 << 12;
+        if (gotowe() || od >= doK)
+            return;
+        if (doK - od <= PROG_SORTOWANIA || minWaga == maksWaga)
+        {
+            sortujIPolacz(od, doK, minWaga, maksWaga);
+            return;
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        int piwot = wybierzPiwot(od, doK);
+        std::vector<int64_t> licznosci = rozrzucKrawedzie(krawedzie + od, bufor.data() + od, doK - od, 3, [=](const Krawedz &k)
+                                                     { return k.waga < piwot ? 0 : (k.waga == piwot ? 1 : 2); },
+                                                     pula);
+        std::copy(bufor.data() + od, bufor.data() + doK, krawedzie + od);
+        st.czasFiltrowania += ms(std::chrono::steady_clock::now() - t0);
+
+        int64_t lzejsze = od + licznosci[0], rowne = lzejsze + licznosci[1];
+        filtruj(od, lzejsze, minWaga, piwot - 1);
+        // Krawędzie o wadze równej piwotowi są już w porządku.
+        polaczPosortowane(lzejsze, rowne);
+        if (gotowe())
+        {
+            st.odrzucone += doK - rowne;
+            return;
+        }
+        int64_t pozostale = odfiltruj(rowne, doK);
+        filtruj(rowne, rowne + pozostale, piwot + 1, maksWaga);
+    }
+
+public:
+    WynikMST wynik;
+
+    SilnikKruskala(int V, ZbiorKrawedzi &zbior, PulaWatkow &pula, StatystykiKruskala &st)
+        : V(V), krawedzie(zbior.krawedzie.data()), bufor(zbior.krawedzie.size()), pula(pula), zbiory(V), st(st)
+    {
+    }
+
+    void uruchom(int64_t n, int minWaga, int maksWaga, TrybKruskala tryb)
+    {
+        if (tryb == TrybKruskala::Filtrujacy)
+            filtruj(0, n, minWaga, maksWaga);
+        else if (n > 0)
+            sortujIPolacz(0, n, minWaga, maksWaga);
+    }
+};
+
+inline WynikMST obliczKruskalMST(int V, ZbiorKrawedzi &zbior, TrybKruskala tryb, PulaWatkow &pula,
+                          StatystykiKruskala *statystyki = nullptr)
+{
+    StatystykiKruskala st;
+    if (statystyki)
+        st = *statystyki;
+    st.krawedzie = zbior.krawedzie.size();
+    SilnikKruskala silnik(V, zbior, pula, st);
+    silnik.uruchom(zbior.krawedzie.size(), zbior.minWaga, zbior.maksWaga, tryb);
+    if (statystyki)
+        *statystyki = st;
+    return std::move(silnik.wynik);
+}
+
+template <typename Macierz>
+WynikMST obliczKruskalMSTMacierz(const Macierz &macierz, TrybKruskala tryb, PulaWatkow &pula,
+                                 StatystykiKruskala *statystyki = nullptr)
+{
+    StatystykiKruskala st;
+    auto t0 = std::chrono::steady_clock::now();
+    ZbiorKrawedzi zbior = wyodrebnijKrawedzie(macierz, pula);
+    st.czasEkstrakcji = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    WynikMST wynik = obliczKruskalMST(macierz.pobierzV(), zbior, tryb, pula, &st);
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+inline WynikMST obliczKruskalMSTMacierz(const GrafMacierz &graf, TrybKruskala tryb, PulaWatkow &pula,
+                                 StatystykiKruskala *statystyki = nullptr)
+{
+    return zWidokiemMacierzy<WynikMST>(graf, [&](const auto &macierz)
+                                       { return obliczKruskalMSTMacierz(macierz, tryb, pula, statystyki); });
+}
+
+inline WynikMST obliczKruskalMSTLista(WidokCSR graf, TrybKruskala tryb, PulaWatkow &pula,
+                               StatystykiKruskala *statystyki = nullptr)
+{
+    StatystykiKruskala st;
+    auto t0 = std::chrono::steady_clock::now();
+    ZbiorKrawedzi zbior = wyodrebnijKrawedzie(graf, pula);
+    st.czasEkstrakcji = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    WynikMST wynik = obliczKruskalMST(graf.pobierzV(), zbior, tryb, pula, &st);
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+// Strumieniowy odczyt tekstowego formatu grafu przez bufor stałej wielkości - w pamięci jest
+// tylko bieżący fragment pliku, więc plik może być dowolnie duży. Liczby parsuje CzytnikLiczb,
+// a bufor jest dopełniany, gdy do jego końca zostaje mniej niż najdłuższa możliwa liczba.
+class CzytnikStrumieniowy
+{
+    std::ifstream plik;
+    std::vector<char> bufor;
+    size_t poczatek = 0, koniec = 0;
+    int64_t wczytane = 0;
+
+    void dopelnij()
+    {
+        const size_t ZAPAS = 32;
+        while (true)
+        {
+            while (poczatek < koniec && (bufor[poczatek] == ' ' || bufor[poczatek] == '\n' ||
+                                         bufor[poczatek] == '\r' || bufor[poczatek] == '\t'))
+                poczatek++;
+            if (koniec - poczatek >= ZAPAS || !plik)
+                return;
+            std::memmove(bufor.data(), bufor.data() + poczatek, koniec - poczatek);
+            koniec -= poczatek;
+            poczatek = 0;
+            plik.read(bufor.data() + koniec, bufor.size() - koniec);
+            size_t ile = (size_t)plik.gcount();
+            wczytane += ile;
+            koniec += ile;
+            if (ile == 0)
+                return;
+        }
+    }
+
+public:
+    explicit CzytnikStrumieniowy(const std::string &nazwaPliku, size_t rozmiarBufora = 1 << 20)
+        : plik(nazwaPliku, std::ios::binary), bufor(rozmiarBufora)
+    {
+    }
+
+    bool otwarty() const
+    {
+        return plik.is_open();
+    }
+
+    bool nastepna(long long &x)
+    {
+        dopelnij();
+        CzytnikLiczb czytnik(bufor.data() + poczatek, bufor.data() + koniec);
+        bool wynik = czytnik.nastepna(x);
+        poczatek = czytnik.pozycja() - bufor.data();
+        return wynik;
+    }
+
+    int64_t pobierzWczytaneBajty() const
+    {
+        return wczytane;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return bufor.size();
+    }
+};
+
+struct StatystykiZewnetrzne
+{
+    int64_t krawedzie = 0;      // krawędzie wczytane z pliku
+    int64_t krawedziWSerii = 0; // ile krawędzi mieści się w jednej serii przy danym budżecie
+    int64_t serie = 0;          // serie posortowane w pamięci (1 = wszystko zmieściło się w budżecie)
+    int64_t przebiegiScalania = 0;
+    int64_t bajtyWejscia = 0, bajtyZapisane = 0, bajtyOdczytane = 0; // plik grafu i pliki tymczasowe
+    double czasWczytywania = 0, czasScalania = 0; // milisekundy: tworzenie serii, scalanie z łączeniem
+};
+
+inline std::string opiszStatystyki(const StatystykiZewnetrzne &st)
+{
+    auto mbNaSekunde = [](int64_t bajty, double ms)
+    { return ms > 0 ? bajty / (ms * 1000.0) : 0.0; };
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(3) << "krawedzie=" << st.krawedzie << " krawedzi_w_serii=" << st.krawedziWSerii
+         << " serie=" << st.serie << " przebiegi_scalania=" << st.przebiegiScalania
+         << " wejscie_mb=" << st.bajtyWejscia / 1e6 << " zapisane_mb=" << st.bajtyZapisane / 1e6
+         << " odczytane_mb=" << st.bajtyOdczytane / 1e6 << " wczytywanie_ms=" << st.czasWczytywania
+         << " scalanie_ms=" << st.czasScalania
+         << " wejscie_mb_s=" << mbNaSekunde(st.bajtyWejscia, st.czasWczytywania)
+         << " pliki_tymczasowe_mb_s="
+         << mbNaSekunde(st.bajtyZapisane + st.bajtyOdczytane, st.czasWczytywania + st.czasScalania);
+    return opis.str();
+}
+
+// Posortowana seria krawędzi zapisana binarnie w pliku tymczasowym.
+struct SeriaNaDysku
+{
+    std::string sciezka;
+    int64_t dlugosc;
+};
+
+inline void zapiszKrawedzieDoPliku(std::ofstream &plik, const Krawedz *krawedzie, int64_t n, const std::string &sciezka,
+                                   StatystykiZewnetrzne &st)
+{
+    plik.write(reinterpret_cast<const char *>(krawedzie), n * (int64_t)sizeof(Krawedz));
+    if (!plik)
+    {
+        std::cerr << "Błąd zapisu pliku tymczasowego " << sciezka << std::endl;
+        std::exit(1);
+    }
+    st.bajtyZapisane += n * (int64_t)sizeof(Krawedz);
+}
+
+// Sekwencyjny odczyt serii przez przydzielony jej fragment wspólnego bufora.
+class CzytnikSerii
+{
+    std::ifstream plik;
+    Krawedz *bufor;
+    int64_t pojemnosc, pozycja = 0, wBuforze = 0, pozostalo;
+
+public:
+    CzytnikSerii(const SeriaNaDysku &seria, Krawedz *bufor, int64_t pojemnosc)
+        : plik(seria.sciezka, std::ios::binary), bufor(bufor), pojemnosc(pojemnosc), pozostalo(seria.dlugosc)
+    {
+        if (!plik)
+        {
+            std::cerr << "Nie można otworzyć pliku tymczasowego " << seria.sciezka << std::endl;
+            std::exit(1);
+        }
+    }
+
+    bool nastepna(Krawedz &k, StatystykiZewnetrzne &st)
+    {
+        if (pozycja == wBuforze)
+        {
+            if (pozostalo == 0)
+                return false;
+            wBuforze = std::min(pojemnosc, pozostalo);
+            plik.read(reinterpret_cast<char *>(bufor), wBuforze * (int64_t)sizeof(Krawedz));
+            if (plik.gcount() != wBuforze * (int64_t)sizeof(Krawedz))
+            {
+                std::cerr << "Błąd odczytu pliku tymczasowego" << std::endl;
+                std::exit(1);
+            }
+            st.bajtyOdczytane += wBuforze * (int64_t)sizeof(Krawedz);
+            pozostalo -= wBuforze;
+            pozycja = 0;
+        }
+        k = bufor[pozycja++];
+        return true;
+    }
+};
+
+// K-drożne scalanie posortowanych serii kopcem ich pierwszych krawędzi. Każda seria czyta przez
+// równy fragment bufora; odbierz(k) dostaje krawędzie w kolejności wag i przerywa scalanie,
+// zwracając false.
+template <typename F>
+void scalSerie(const std::vector<SeriaNaDysku> &serie, Krawedz *bufor, int64_t pojemnosc, StatystykiZewnetrzne &st,
+               F &&odbierz)
+{
+    int k = (int)serie.size();
+    int64_t fragment = pojemnosc / k;
+    std::vector<CzytnikSerii> czytniki;
+    czytniki.reserve(k);
+    std::vector<std::pair<Krawedz, int>> kopiec;
+    kopiec.reserve(k);
+    auto ciezszy = [](const std::pair<Krawedz, int> &a, const std::pair<Krawedz, int> &b)
+    { return a.first.waga != b.first.waga ? a.first.waga > b.first.waga : a.second > b.second; };
+    for (int i = 0; i < k; i++)
+    {
+        czytniki.emplace_back(serie[i], bufor + i * fragment, fragment);
+        Krawedz krawedz;
+        if (czytniki[i].nastepna(krawedz, st))
+            kopiec.push_back({krawedz, i});
+    }
+    std::make_heap(kopiec.begin(), kopiec.end(), ciezszy);
+    while (!kopiec.empty())
+    {
+        std::pop_heap(kopiec.begin(), kopiec.end(), ciezszy);
+        auto [krawedz, i] = kopiec.back();
+        kopiec.pop_back();
+        if (!odbierz(krawedz))
+            return;
+        if (czytniki[i].nastepna(kopiec.emplace_back().first, st))
+        {
+            kopiec.back().second = i;
+            std::push_heap(kopiec.begin(), kopiec.end(), ciezszy);
+        }
+        else
+            kopiec.pop_back();
+    }
+}
+
+// Kruskal dla list krawędzi większych niż pamięć: plik tekstowy jest czytany strumieniowo,
+// krawędzie trafiają do serii mieszczących się w budżecie, każda seria jest sortowana pozycyjnie
+// i zapisywana do pliku tymczasowego w katalogu roboczym, a posortowane serie są scalane
+// (w razie potrzeby w kilku przebiegach) prosto do zbiorów rozłącznych. W pamięci stale są tylko
+// zbiory rozłączne i wynik - O(V) - oraz bufor serii, którego wielkość wynika z budżetu.
+// Gdy wszystkie krawędzie mieszczą się w jednej serii, pliki tymczasowe nie powstają.
+inline WynikMST obliczKruskalZewnetrzny(const std::string &nazwaPliku, size_t budzetBajtow, const std::string &katalog,
+                                        PulaWatkow &pula, StatystykiZewnetrzne *statystyki = nullptr)
+{
+    StatystykiZewnetrzne st;
+    auto t0 = std::chrono::steady_clock::now();
+    CzytnikStrumieniowy czytnik(nazwaPliku);
+    if (!czytnik.otwarty())
+    {
+        std::cerr << "Nie można otworzyć pliku " << nazwaPliku << std::endl;
+        std::exit(1);
+    }
+    long long V, E;
+    if (!czytnik.nastepna(V) || !czytnik.nastepna(E) || V < 0 || V > INT_MAX || E < 0)
+    {
+        std::cerr << "Nieprawidłowy nagłówek pliku " << nazwaPliku << std::endl;
+        std::exit(1);
+    }
+
+    // Stała część: zbiory rozłączne, krawędzie wyniku i bufor czytnika; resztę dzielą seria
+    // i drugi bufor sortowania pozycyjnego, a przy scalaniu - bufory odczytu i zapisu serii.
+    const int64_t MIN_SERIA = 1024;
+    int64_t stale = V * (int64_t)sizeof(int) + std::max(V - 1, 0LL) * (int64_t)sizeof(std::pair<int, int>) +
+                    (int64_t)czytnik.pobierzRozmiarBajtow();
+    int64_t pojemnosc = ((int64_t)budzetBajtow - stale) / (2 * (int64_t)sizeof(Krawedz));
+    if (pojemnosc < MIN_SERIA)
+    {
+        std::cerr << "Budżet pamięci za mały: potrzeba co najmniej "
+             << (stale + 2 * MIN_SERIA * (int64_t)sizeof(Krawedz) + (1 << 20) - 1) / (1 << 20) << " MB" << std::endl;
+        std::exit(1);
+    }
+    pojemnosc = std::min<int64_t>(pojemnosc, std::max(E, 1LL));
+    st.krawedziWSerii = pojemnosc;
+    std::vector<Krawedz> pamiec(2 * pojemnosc);
+    Krawedz *seria = pamiec.data(), *buforSortowania = pamiec.data() + pojemnosc;
+
+    WynikMST wynik;
+    wynik.krawedzie.reserve(std::max(V - 1, 0LL));
+    ZbiorRozlaczny zbiory((int)V);
+    auto dolacz = [&](const Krawedz &k)
+    {
+        if (zbiory.polacz(k.u, k.v))
+        {
+            wynik.krawedzie.push_back({k.u, k.v});
+            wynik.waga += k.waga;
+        }
+        return (int64_t)wynik.krawedzie.size() < V - 1;
+    };
+
+    static std::atomic<int> licznikWywolan{0};
+#ifdef _WIN32
+    long long proces = GetCurrentProcessId();
+#else
+    long long proces = getpid();
+#endif
+    std::string przedrostek = katalog + "/grafy_seria_" + std::to_string(proces) + "_" + std::to_string(licznikWywolan++) + "_";
+    int numerPliku = 0;
+    std::vector<SeriaNaDysku> serie;
+    auto nowaSeria = [&](std::ofstream &plik)
+    {
+        SeriaNaDysku s{przedrostek + std::to_string(numerPliku++) + ".bin", 0};
+        plik.open(s.sciezka, std::ios::binary | std::ios::trunc);
+        if (!plik)
+        {
+            std::cerr << "Nie można utworzyć pliku tymczasowego " << s.sciezka << std::endl;
+            std::exit(1);
+        }
+        return s;
+    };
+
+    // Tworzenie serii.
+    for (long long i = 0; i < E;)
+    {
+        int64_t n = 0;
+        int minWaga = INT_MAX, maksWaga = INT_MIN;
+        for (; n < pojemnosc && i < E; n++, i++)
+        {
+            long long u, v, w;
+            if (!czytnik.nastepna(u) || !czytnik.nastepna(v) || !czytnik.nastepna(w) ||
+                u < 0 || u >= V || v < 0 || v >= V || w < INT_MIN || w > INT_MAX)
+            {
+                std::cerr << "Nieprawidłowa krawędź nr " << i + 1 << " w pliku " << nazwaPliku << std::endl;
+                std::exit(1);
+            }
+            seria[n] = {(int)u, (int)v, (int)w};
+            minWaga = std::min(minWaga, (int)w);
+            maksWaga = std::max(maksWaga, (int)w);
+        }
+        sortujPoWadze(seria, buforSortowania, n, minWaga, maksWaga, pula);
+        st.serie++;
+        if (i == E && serie.empty())
+        {
+            // Wszystko zmieściło się w jednej serii - bez plików tymczasowych.
+            st.czasWczytywania = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            auto t1 = std::chrono::steady_clock::now();
+            for (int64_t j = 0; j < n; j++)
+                if (!dolacz(seria[j]))
+                    break;
+            st.czasScalania = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+            break;
+        }
+        std::ofstream plik;
+        serie.push_back(nowaSeria(plik));
+        serie.back().dlugosc = n;
+        zapiszKrawedzieDoPliku(plik, seria, n, serie.back().sciezka, st);
+    }
+    st.krawedzie = E;
+    st.bajtyWejscia = czytnik.pobierzWczytaneBajty();
+
+    if (!serie.empty())
+    {
+        st.czasWczytywania = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        auto t1 = std::chrono::steady_clock::now();
+        // Scalanie czyta przez cały obszar serii; jeden fragment na serię powinien mieć co
+        // najmniej kilka tysięcy krawędzi, inaczej odczyt rozpada się na drobne wywołania.
+        const int64_t MIN_FRAGMENT = 8192;
+        int64_t obszar = 2 * pojemnosc;
+        int maksWejsc = (int)std::max<int64_t>(2, obszar / MIN_FRAGMENT - 1);
+        while ((int)serie.size() > maksWejsc)
+        {
+            st.przebiegiScalania++;
+            std::vector<SeriaNaDysku> nastepne;
+            for (size_t od = 0; od < serie.size(); od += maksWejsc)
+            {
+                std::vector<SeriaNaDysku> grupa(serie.begin() + od, serie.begin() + std::min(serie.size(), od + maksWejsc));
+                if (grupa.size() == 1)
+                {
+                    nastepne.push_back(grupa[0]);
+                    continue;
+                }
+                // Ostatni fragment bufora służy do zapisu scalonej serii.
+                int64_t fragment = obszar / ((int64_t)grupa.size() + 1);
+                Krawedz *wyjscie = pamiec.data() + fragment * (int64_t)grupa.size();
+                int64_t wBuforze = 0;
+                std::ofstream plik;
+                SeriaNaDysku scalona = nowaSeria(plik);
+                scalSerie(grupa, pamiec.data(), fragment * (int64_t)grupa.size(), st, [&](const Krawedz &k)
+                          {
+                              wyjscie[wBuforze++] = k;
+                              if (wBuforze == fragment)
+                              {
+                                  zapiszKrawedzieDoPliku(plik, wyjscie, wBuforze, scalona.sciezka, st);
+                                  wBuforze = 0;
+                              }
+                              scalona.dlugosc++;
+                              return true; });
+                zapiszKrawedzieDoPliku(plik, wyjscie, wBuforze, scalona.sciezka, st);
+                plik.close();
+                for (const auto &s : grupa)
+                    std::remove(s.sciezka.c_str());
+                nastepne.push_back(scalona);
+            }
+            serie = std::move(nastepne);
+        }
+        st.przebiegiScalania++;
+        if (V > 1)
+            scalSerie(serie, pamiec.data(), obszar, st, dolacz);
+        for (const auto &s : serie)
+            std::remove(s.sciezka.c_str());
+        st.czasScalania = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+    }
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+// Krawędź grafu ściąganego w algorytmie Borůvki: końce to numery składowych, waga jest przesunięta
+// o minWaga (żeby zmieściła się bez znaku w 32 bitach klucza), a id wskazuje krawędź grafu wejściowego.
+struct KrawedzBoruvki
+{
+    int u, v;
+    uint32_t waga;
+    uint32_t id;
+};
+
+struct RundaBoruvki
+{
+    int64_t skladowe = 0;  // składowe na początku rundy
+    int64_t krawedzie = 0; // krawędzie między różnymi składowymi na początku rundy
+    double czas = 0;       // milisekundy
+};
+
+struct StatystykiBoruvki
+{
+    int watki = 1;
+    std::vector<RundaBoruvki> rundy;
+};
+
+inline std::string opiszStatystyki(const StatystykiBoruvki &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(3) << "watki=" << st.watki << " rundy=" << st.rundy.size();
+    for (size_t i = 0; i < st.rundy.size(); i++)
+    {
+        opis << " [" << i + 1 << ": skladowe=" << st.rundy[i].skladowe << " krawedzie=" << st.rundy[i].krawedzie
+             << " ms=" << st.rundy[i].czas << "]";
+    }
+    return opis.str();
+}
+
+// Borůvka ze ściąganiem grafu. W każdej rundzie:
+//  1. każda składowa wybiera najlżejszą wychodzącą krawędź - atomowe minimum 64-bitowego klucza
+//     (waga, pozycja krawędzi), więc remisy wag rozstrzygane są jednoznacznie i wybór nie tworzy cyklu,
+//  2. składowe są łączone wzdłuż wybranych krawędzi równolegle, przez bezblokadowe zbiory
+//     rozłączne (wybrane krawędzie tworzą las, więc każde łączenie się udaje),
+//  3. każda składowa znajduje swój korzeń,
+//  4. korzenie dostają kolejne numery, a krawędzie są przenumerowane i ściśnięte bez pętli.
+// Liczba składowych co najmniej się połowi, więc rund jest O(log V). Zakłada mniej niż 2^32 krawędzi.
+inline WynikMST obliczBoruvkaMSTLista(WidokCSR graf, PulaWatkow &pula, StatystykiBoruvki *statystyki = nullptr)
+{
+    const uint64_t BRAK = UINT64_MAX;
+    int V = graf.pobierzV();
+    WynikMST wynik;
+    StatystykiBoruvki st;
+    st.watki = pula.rozmiar();
+
+    ZbiorKrawedzi zbior = wyodrebnijKrawedzie(graf, pula);
+    const std::vector<Krawedz> &wejscie = zbior.krawedzie;
+    int64_t m = wejscie.size();
+    std::vector<KrawedzBoruvki> krawedzie(m), bufor(m);
+    pula.dlaPrzedzialow(m, [&](int, int64_t od, int64_t doK)
+                        {
+        for (int64_t i = od; i < doK; i++)
+            krawedzie[i] = {wejscie[i].u, wejscie[i].v, (uint32_t)((int64_t)wejscie[i].waga - zbior.minWaga), (uint32_t)i}; });
+
+    std::vector<std::atomic<uint64_t>> najtanszy(V);
+    std::vector<int> rodzic(V), numer(V);
+    std::vector<char> dodana(V);
+    int n = V;
+
+    while (n > 1 && m > 0)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        RundaBoruvki runda;
+        runda.skladowe = n;
+        runda.krawedzie = m;
+        LICZ(krawedzie, m);
+
+        pula.dlaPrzedzialow(n, [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t c = od; c < doK; c++)
+                najtanszy[c].store(BRAK, std::memory_order_relaxed); });
+
+        pula.dlaPrzedzialow(m, [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t i = od; i < doK; i++)
+            {
+                const KrawedzBoruvki &k = krawedzie[i];
+                uint64_t klucz = (uint64_t)k.waga << 32 | (uint64_t)i;
+                for (int c : {k.u, k.v})
+                {
+                    uint64_t stary = najtanszy[c].load(std::memory_order_relaxed);
+                    while (klucz < stary && !najtanszy[c].compare_exchange_weak(stary, klucz, std::memory_order_relaxed))
+                    {
+                    }
+                }
+            } });
+
+        // Łączenie wzdłuż wybranych krawędzi we wspólnych zbiorach rozłącznych. Krawędź wybraną
+        // przez obie składowe łączy tylko ta o większym numerze, więc każda trafia do MST raz.
+        ZbiorRozlacznyWspolbiezny zbiory(n);
+        pula.dlaPrzedzialow(n, [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t c = od; c < doK; c++)
+            {
+                uint64_t klucz = najtanszy[c].load(std::memory_order_relaxed);
+                dodana[c] = 0;
+                if (klucz == BRAK)
+                    continue;
+                const KrawedzBoruvki &k = krawedzie[klucz & 0xffffffffu];
+                int d = k.u == c ? k.v : k.u;
+                if (najtanszy[d].load(std::memory_order_relaxed) == klucz && c < d)
+                    continue;
+                dodana[c] = zbiory.polacz((int)c, d);
+            } });
+        for (int c = 0; c < n; c++)
+        {
+            if (dodana[c])
+            {
+                const Krawedz &k = wejscie[krawedzie[najtanszy[c].load(std::memory_order_relaxed) & 0xffffffffu].id];
+                wynik.krawedzie.push_back({k.u, k.v});
+                wynik.waga += k.waga;
+            }
+        }
+        pula.dlaPrzedzialow(n, [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t c = od; c < doK; c++)
+                rodzic[c] = zbiory.znajdz((int)c); });
+
+        int nowe = 0;
+        for (int c = 0; c < n; c++)
+        {
+            if (rodzic[c] == c)
+                numer[c] = nowe++;
+        }
+
+        pula.dlaPrzedzialow(m, [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t i = od; i < doK; i++)
+            {
+                krawedzie[i].u = numer[rodzic[krawedzie[i].u]];
+                krawedzie[i].v = numer[rodzic[krawedzie[i].v]];
+            } });
+        std::vector<int64_t> licznosci = rozrzucKrawedzie(krawedzie.data(), bufor.data(), m, 2, [](const KrawedzBoruvki &k)
+                                                     { return k.u == k.v ? 1 : 0; },
+                                                     pula);
+        std::swap(krawedzie, bufor);
+        m = licznosci[0];
+        n = nowe;
+
+        runda.czas = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        st.rundy.push_back(runda);
+    }
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+// Drzewo link-cut (D. Sleator, R. Tarjan, "A Data Structure for Dynamic Trees", 1983) na
+// drzewach splay, z maksimum wartości na ścieżce. Węzły są numerowane od 0; wartość węzła
+// ustawia ustawWartosc, a maksimumNaSciezce zwraca węzeł o największej wartości na ścieżce u-v.
+// Wszystkie operacje działają w zamortyzowanym czasie O(log n).
+class DrzewoLinkCut
+{
+    struct Wezel
+    {
+        int dzieci[2] = {-1, -1};
+        int rodzic = -1;
+        bool odwroc = false;
+        int64_t wartosc = INT64_MIN;
+        int maks = -1; // węzeł o największej wartości w poddrzewie splay
+    };
+    std::vector<Wezel> w;
+
+    bool korzenSplay(int x) const
+    {
+        int p = w[x].rodzic;
+        return p < 0 || (w[p].dzieci[0] != x && w[p].dzieci[1] != x);
+    }
+
+    void przelicz(int x)
+    {
+        w[x].maks = x;
+        for (int d : w[x].dzieci)
+            if (d >= 0 && w[w[d].maks].wartosc > w[w[x].maks].wartosc)
+                w[x].maks = w[d].maks;
+    }
+
+    void zepchnij(int x)
+    {
+        if (!w[x].odwroc)
+            return;
+        std::swap(w[x].dzieci[0], w[x].dzieci[1]);
+        for (int d : w[x].dzieci)
+            if (d >= 0)
+                w[d].odwroc = !w[d].odwroc;
+        w[x].odwroc = false;
+    }
+
+    void obroc(int x)
+    {
+        int p = w[x].rodzic, g = w[p].rodzic;
+        int strona = w[p].dzieci[1] == x;
+        if (!korzenSplay(p))
+            w[g].dzieci[w[g].dzieci[1] == p] = x;
+        w[x].rodzic = g;
+        w[p].dzieci[strona] = w[x].dzieci[!strona];
+        if (w[x].dzieci[!strona] >= 0)
+            w[w[x].dzieci[!strona]].rodzic = p;
+        w[x].dzieci[!strona] = p;
+        w[p].rodzic = x;
+        przelicz(p);
+        przelicz(x);
+    }
+
+    void splay(int x)
+    {
+        // Leniwe odwrócenia trzeba zepchnąć od korzenia splay w dół, zanim zaczną się obroty.
+        stos.clear();
+        for (int y = x;; y = w[y].rodzic)
+        {
+            stos.push_back(y);
+            if (korzenSplay(y))
+                break;
+        }
+        for (int i = (int)stos.size() - 1; i >= 0; i--)
+            zepchnij(stos[i]);
+
+        while (!korzenSplay(x))
+        {
+            int p = w[x].rodzic;
+            if (!korzenSplay(p))
+                obroc((w[p].dzieci[1] == x) == (w[w[p].rodzic].dzieci[1] == p) ? p : x);
+            obroc(x);
+        }
+    }
+
+    void dostep(int x)
+    {
+        for (int ostatni = -1, y = x; y >= 0; ostatni = y, y = w[y].rodzic)
+        {
+            splay(y);
+            w[y].dzieci[1] = ostatni;
+            przelicz(y);
+        }
+        splay(x);
+    }
+
+    void ukorzen(int x)
+    {
+        dostep(x);
+        w[x].odwroc = !w[x].odwroc;
+    }
+
+    std::vector<int> stos;
+
+public:
+    explicit DrzewoLinkCut(int n = 0)
+    {
+        zmienRozmiar(n);
+    }
+
+    void zmienRozmiar(int n)
+    {
+        int stary = w.size();
+        w.resize(n);
+        for (int x = stary; x < n; x++)
+            w[x].maks = x;
+    }
+
+    // Tylko dla węzła, który nie jest połączony z żadnym innym.
+    void ustawWartosc(int x, int64_t wartosc)
+    {
+        w[x] = Wezel();
+        w[x].wartosc = wartosc;
+        w[x].maks = x;
+    }
+
+    int64_t wartosc(int x) const
+    {
+        return w[x].wartosc;
+    }
+
+    // Po dostep(x) węzeł x jest korzeniem swojego drzewa splay, więc wystarczy przeliczyć jego maksimum.
+    void zmienWartosc(int x, int64_t wartosc)
+    {
+        dostep(x);
+        w[x].wartosc = wartosc;
+        przelicz(x);
+    }
+
+    int korzen(int x)
+    {
+        dostep(x);
+        while (true)
+        {
+            zepchnij(x);
+            if (w[x].dzieci[0] < 0)
+                break;
+            x = w[x].dzieci[0];
+        }
+        splay(x);
+        return x;
+    }
+
+    bool polaczone(int u, int v)
+    {
+        return u == v || korzen(u) == korzen(v);
+    }
+
+    // u i v muszą być w różnych drzewach.
+    void polacz(int u, int v)
+    {
+        ukorzen(u);
+        w[u].rodzic = v;
+    }
+
+    // u i v muszą być sąsiadami w drzewie.
+    void rozetnij(int u, int v)
+    {
+        ukorzen(u);
+        dostep(v);
+        w[v].dzieci[0] = -1;
+        w[u].rodzic = -1;
+        przelicz(v);
+    }
+
+    int maksimumNaSciezce(int u, int v)
+    {
+        ukorzen(u);
+        dostep(v);
+        return w[v].maks;
+    }
+};
+
+// Minimalny las rozpinający jednego podgrafu - węzeł drzewa sparsyfikacji w DynamiczneMST.
+// Krawędzie mają numery nadane z zewnątrz i są porządkowane po (waga, numer), więc las jest
+// jednoznaczny. Każda krawędź lasu jest osobnym węzłem drzewa link-cut (z tym porządkiem jako
+// wartością) wstawionym między swoje końce, więc najcięższa krawędź na ścieżce u-v to maksimum
+// na ścieżce. Każde dołączenie i odłączenie krawędzi lasu trafia do dziennika zmian.
+//  - dodanie krawędzi: jeśli końce są w różnych drzewach, krawędź wchodzi do lasu; w przeciwnym
+//    razie zastępuje najcięższą krawędź cyklu, o ile jest od niej lżejsza - O(log V),
+//  - usunięcie krawędzi spoza lasu, zmniejszenie wagi dowolnej krawędzi i zwiększenie wagi
+//    krawędzi spoza lasu - O(log V),
+//  - usunięcie krawędzi lasu i zwiększenie jej wagi: po rozcięciu dwa przeszukiwania wszerz po krawędziach lasu,
+//    prowadzone na zmianę z obu końców, zatrzymują się, gdy mniejszy kawałek jest cały
+//    odwiedzony; zastępstwem jest najlżejsza krawędź wychodząca z tego kawałka. Koszt to suma
+//    stopni w mniejszym kawałku, najwyżej liczba krawędzi podgrafu.
+// Tablice wierzchołków powstają dopiero przy pierwszej krawędzi, więc pusty las nic nie kosztuje.
+class LasDynamiczny
+{
+public:
+    struct Zmiana
+    {
+        int numer;
+        bool dodana; // false: krawędź wyszła z lasu
+    };
+
+private:
+    struct KrawedzLasu
+    {
+        int numer, u, v, waga;
+        bool wLesie;
+        int pozU, pozV; // pozycje w incydentne[u] i incydentne[v]
+    };
+
+    int V;
+    std::vector<KrawedzLasu> krawedzie;
+    std::vector<int> wolne;               // pozycje usuniętych krawędzi do ponownego użycia
+    std::unordered_map<int, int> pozycje; // numer krawędzi -> pozycja w krawedzie
+    std::vector<std::vector<int>> incydentne;  // pozycje krawędzi przy każdym wierzchołku (bez pętli własnych)
+    DrzewoLinkCut drzewo;
+    int64_t waga = 0;
+    int64_t krawedzieLasu = 0;
+    std::vector<Zmiana> dziennik;
+
+    // Bufory przeszukiwania przy usuwaniu krawędzi lasu; znacznik == epoka oznacza odwiedzony.
+    std::vector<int> znacznik, strona;
+    std::vector<int> kawalki[2];
+    int epoka = 0;
+
+    // (waga, numer) jako jedna liczba: waga * 2^32 + numer mieści się w int64_t.
+    static int64_t porzadek(const KrawedzLasu &k)
+    {
+        return (int64_t)k.waga * ((int64_t)1 << 32) + k.numer;
+    }
+
+    int wezel(int e) const
+    {
+        return V + e;
+    }
+
+    void przydziel()
+    {
+        if (!incydentne.empty())
+            return;
+        incydentne.resize(V);
+        drzewo.zmienRozmiar(V + (int)krawedzie.size());
+        znacznik.assign(V, 0);
+        strona.assign(V, 0);
+    }
+
+    void dodajIncydentna(int e)
+    {
+        KrawedzLasu &k = krawedzie[e];
+        if (k.u == k.v)
+            return;
+        k.pozU = incydentne[k.u].size();
+        incydentne[k.u].push_back(e);
+        k.pozV = incydentne[k.v].size();
+        incydentne[k.v].push_back(e);
+    }
+
+    void usunZListy(int x, int poz)
+    {
+        std::vector<int> &lista = incydentne[x];
+        int ostatnia = lista.back();
+        lista[poz] = ostatnia;
+        lista.pop_back();
+        if (poz < (int)lista.size())
+        {
+            KrawedzLasu &k = krawedzie[ostatnia];
+            (k.u == x ? k.pozU : k.pozV) = poz;
+        }
+    }
+
+    void usunIncydentna(int e)
+    {
+        const KrawedzLasu &k = krawedzie[e];
+        if (k.u == k.v)
+            return;
+        usunZListy(k.u, k.pozU);
+        usunZListy(k.v, krawedzie[e].pozV);
+    }
+
+    int nowaPozycja(int numer, const Krawedz &k)
+    {
+        int e;
+        if (!wolne.empty())
+        {
+            e = wolne.back();
+            wolne.pop_back();
+        }
+        else
+        {
+            e = krawedzie.size();
+            krawedzie.emplace_back();
+            drzewo.zmienRozmiar(V + (int)krawedzie.size());
+        }
+        krawedzie[e] = {numer, k.u, k.v, k.waga, false, 0, 0};
+        pozycje[numer] = e;
+        dodajIncydentna(e);
+        return e;
+    }
+
+    void dolaczDoLasu(int e)
+    {
+        KrawedzLasu &k = krawedzie[e];
+        drzewo.ustawWartosc(wezel(e), porzadek(k));
+        drzewo.polacz(k.u, wezel(e));
+        drzewo.polacz(wezel(e), k.v);
+        k.wLesie = true;
+        waga += k.waga;
+        krawedzieLasu++;
+        dziennik.push_back({k.numer, true});
+    }
+
+    void odlaczZLasu(int e)
+    {
+        KrawedzLasu &k = krawedzie[e];
+        drzewo.rozetnij(k.u, wezel(e));
+        drzewo.rozetnij(wezel(e), k.v);
+        k.wLesie = false;
+        waga -= k.waga;
+        krawedzieLasu--;
+        dziennik.push_back({k.numer, false});
+    }
+
+    // Krawędź e jest już na listach incydencji, ale jeszcze nie w lesie.
+    void wstaw(int e)
+    {
+        const KrawedzLasu &k = krawedzie[e];
+        if (k.u == k.v)
+            return;
+        if (!drzewo.polaczone(k.u, k.v))
+        {
+            dolaczDoLasu(e);
+            return;
+        }
+        int najciezsza = drzewo.maksimumNaSciezce(k.u, k.v);
+        if (drzewo.wartosc(najciezsza) > porzadek(k))
+        {
+            odlaczZLasu(najciezsza - V);
+            dolaczDoLasu(e);
+        }
+    }
+
+    // Najlżejsza krawędź spoza lasu (inna niż pomin) łącząca kawałki z a i z b, albo -1.
+    int znajdzZastepstwo(int a, int b, int pomin)
+    {
+        epoka++;
+        int poczatki[2] = {a, b};
+        size_t nastepny[2] = {0, 0};
+        for (int s = 0; s < 2; s++)
+        {
+            kawalki[s].clear();
+            kawalki[s].push_back(poczatki[s]);
+            znacznik[poczatki[s]] = epoka;
+            strona[poczatki[s]] = s;
+        }
+
+        int mniejszy = -1;
+        while (mniejszy < 0)
+        {
+            for (int s = 0; s < 2 && mniejszy < 0; s++)
+            {
+                if (nastepny[s] == kawalki[s].size())
+                {
+                    mniejszy = s;
+                    break;
+                }
+                int x = kawalki[s][nastepny[s]++];
+                for (int f : incydentne[x])
+                {
+                    if (!krawedzie[f].wLesie)
+                        continue;
+                    int y = krawedzie[f].u == x ? krawedzie[f].v : krawedzie[f].u;
+                    if (znacznik[y] != epoka)
+                    {
+                        znacznik[y] = epoka;
+                        strona[y] = s;
+                        kawalki[s].push_back(y);
+                    }
+                }
+            }
+        }
+
+        int najlepsza = -1;
+        for (int x : kawalki[mniejszy])
+        {
+            for (int f : incydentne[x])
+            {
+                const KrawedzLasu &k = krawedzie[f];
+                int y = k.u == x ? k.v : k.u;
+                if (f == pomin || k.wLesie || (znacznik[y] == epoka && strona[y] == mniejszy))
+                    continue;
+                if (najlepsza < 0 || porzadek(k) < porzadek(krawedzie[najlepsza]))
+                    najlepsza = f;
+            }
+        }
+        return najlepsza;
+    }
+
+    // Wyjmuje e z lasu (jeśli tam była) i dołącza zastępstwo.
+    void wyjmijZLasu(int e)
+    {
+        if (!krawedzie[e].wLesie)
+            return;
+        odlaczZLasu(e);
+        int zastepstwo = znajdzZastepstwo(krawedzie[e].u, krawedzie[e].v, e);
+        if (zastepstwo >= 0)
+            dolaczDoLasu(zastepstwo);
+    }
+
+public:
+    explicit LasDynamiczny(int V = 0) : V(V)
+    {
+    }
+
+    // Buduje las od zera (Kruskal) z krawędzi wszystkie[numer] dla podanych numerów; dziennik
+    // zostaje pusty.
+    void zbuduj(const std::vector<Krawedz> &wszystkie, std::vector<int> numery)
+    {
+        *this = LasDynamiczny(V);
+        std::sort(numery.begin(), numery.end(), [&](int a, int b)
+             { return std::make_pair(wszystkie[a].waga, a) < std::make_pair(wszystkie[b].waga, b); });
+        krawedzie.reserve(numery.size());
+        pozycje.reserve(numery.size());
+        przydziel();
+        ZbiorRozlaczny zbiory(V);
+        for (int numer : numery)
+        {
+            const Krawedz &k = wszystkie[numer];
+            int e = nowaPozycja(numer, k);
+            if (k.u != k.v && zbiory.polacz(k.u, k.v))
+                dolaczDoLasu(e);
+        }
+        dziennik.clear();
+    }
+
+    void dodaj(int numer, const Krawedz &k)
+    {
+        przydziel();
+        wstaw(nowaPozycja(numer, k));
+    }
+
+    // Zmienia wagę krawędzi podgrafu. Krawędź lasu po zmniejszeniu wagi i krawędź spoza lasu po
+    // zwiększeniu zostają tam, gdzie były; lżejsza krawędź spoza lasu wchodzi najwyżej w miejsce
+    // najcięższej krawędzi swojego cyklu. Tylko cięższa krawędź lasu szuka zastępstwa, które
+    // wchodzi do lasu, jeśli jest od niej lżejsze.
+    void zmienWage(int numer, int w)
+    {
+        int e = pozycje.find(numer)->second;
+        KrawedzLasu &k = krawedzie[e];
+        if (k.wLesie && w <= k.waga)
+        {
+            waga += w - k.waga;
+            k.waga = w;
+            drzewo.zmienWartosc(wezel(e), porzadek(k));
+        }
+        else if (!k.wLesie)
+        {
+            bool lzejsza = w < k.waga;
+            k.waga = w;
+            if (lzejsza)
+                wstaw(e);
+        }
+        else
+        {
+            odlaczZLasu(e);
+            k.waga = w;
+            int zastepstwo = znajdzZastepstwo(k.u, k.v, e);
+            dolaczDoLasu(zastepstwo >= 0 && porzadek(krawedzie[zastepstwo]) < porzadek(k) ? zastepstwo : e);
+        }
+    }
+
+    bool zawiera(int numer) const
+    {
+        return pozycje.count(numer) > 0;
+    }
+
+    // Krawędź o tym numerze musi być w podgrafie.
+    void usun(int numer)
+    {
+        auto it = pozycje.find(numer);
+        int e = it->second;
+        pozycje.erase(it);
+        wyjmijZLasu(e);
+        usunIncydentna(e);
+        wolne.push_back(e);
+    }
+
+    const std::vector<Zmiana> &zmiany() const
+    {
+        return dziennik;
+    }
+
+    void wyczyscZmiany()
+    {
+        dziennik.clear();
+    }
+
+    // Dopisuje numery krawędzi lasu.
+    void dopiszLas(std::vector<int> &numery) const
+    {
+        for (const KrawedzLasu &k : krawedzie)
+            if (k.wLesie)
+                numery.push_back(k.numer);
+    }
+
+    int64_t calkowitaWaga() const
+    {
+        return waga;
+    }
+
+    int64_t liczbaKrawedziLasu() const
+    {
+        return krawedzieLasu;
+    }
+};
+
+// Minimalny las rozpinający utrzymywany pod dodawaniem, usuwaniem i zmianą wag krawędzi, ze
+// sparsyfikacją (D. Eppstein, Z. Galil, G. F. Italiano, A. Nissenzweig, "Sparsification - A
+// Technique for Speeding Up Dynamic Graph Algorithms", 1997). Krawędzie są podzielone na grupy
+// po co najwyżej 8V w liściach pełnego drzewa binarnego. Każdy węzeł utrzymuje LasDynamiczny
+// swojej grupy (liść) albo sumy lasów swoich dzieci (najwyżej 2V krawędzi), więc żaden podgraf
+// nie ma więcej niż O(V) krawędzi, a las korzenia to MST całego grafu. Zmiana jednej krawędzi
+// zmienia las każdego węzła najwyżej o jedną krawędź wchodzącą i jedną wychodzącą, więc w górę
+// idzie tylko ta zmiana netto (i nowa waga, jeśli rodzic ma tę krawędź), a przenoszenie kończy
+// się na pierwszym węźle, którego las się nie zmienił. Koszt operacji, gdzie "las liścia" to las
+// grupy, w której leży krawędź:
+//  - usunięcie i zwiększenie wagi krawędzi spoza lasu liścia - O(log V), zmienia się tylko liść,
+//  - dodanie krawędzi i zmniejszenie wagi dowolnej krawędzi - O(log V) w każdym węzle na ścieżce
+//    do korzenia, razem O(log V log(E/V)): krawędź wypchnięta z lasu dziecka jest w rodzicu
+//    najcięższa na cyklu z nową krawędzią, więc po jej dodaniu wypada z lasu rodzica i jej
+//    usunięcie nie szuka zastępstwa,
+//  - usunięcie i zwiększenie wagi krawędzi lasu liścia - w każdym węźle, którego las ją zawiera,
+//    szukanie zastępstwa ograniczone rozmiarem podgrafu, razem najwyżej O(V log(E/V)) zamiast O(E).
+// Gdy wszystkie liście są pełne, ich liczba się podwaja i drzewo jest budowane od nowa
+// (zamortyzowane O(log E) na dodanie). Krawędzie są nieskierowane i jednoznaczne dla pary
+// końców: dodajKrawedz dla istniejącej pary zmienia jej wagę.
+class DynamiczneMST
+{
+    int V;
+    int pojemnosc;               // najwięcej krawędzi w jednym liściu
+    int liscie = 1;              // potęga dwójki; węzeł k ma dzieci 2k i 2k + 1, korzeń to 1
+    std::vector<LasDynamiczny> wezly; // liście to wezly[liscie..2 * liscie - 1]
+    std::vector<Krawedz> krawedzie;   // numer krawędzi -> końce i waga
+    std::vector<int> lisc;            // numer krawędzi -> węzeł liścia, -1 dla wolnego numeru
+    std::vector<int> wolne;           // wolne numery krawędzi
+    std::vector<int> zajete;          // krawędzi w każdym liściu
+    std::vector<int> miejsca;         // niepełne liście
+    std::unordered_map<uint64_t, int> numery;
+    std::vector<LasDynamiczny::Zmiana> netto;
+
+    static uint64_t klucz(int u, int v)
+    {
+        if (u > v)
+            std::swap(u, v);
+        return (uint64_t)(uint32_t)u << 32 | (uint32_t)v;
+    }
+
+    // Większe liście to mniej poziomów, a las liścia obejmuje mniejszą część jego krawędzi, więc
+    // rzadziej zmienia się przy zmianie krawędzi; 8V wypada najlepiej na E od 5V do ~1000V.
+    static int pojemnoscLiscia(int V)
+    {
+        return (int)std::clamp<int64_t>(8 * (int64_t)V, 1, INT_MAX);
+    }
+
+    // Rozkłada krawędzie po kolei na nowe liście i buduje wszystkie węzły od dołu.
+    void przebuduj(int noweLiscie)
+    {
+        liscie = noweLiscie;
+        wezly.assign(2 * liscie, LasDynamiczny(V));
+        zajete.assign(liscie, 0);
+        std::vector<std::vector<int>> grupy(liscie);
+        int i = 0;
+        for (int numer = 0; numer < (int)krawedzie.size(); numer++)
+        {
+            if (lisc[numer] < 0)
+                continue;
+            if ((int)grupy[i].size() == pojemnosc)
+                i++;
+            grupy[i].push_back(numer);
+            lisc[numer] = liscie + i;
+        }
+        for (i = 0; i < liscie; i++)
+        {
+            zajete[i] = grupy[i].size();
+            if (!grupy[i].empty())
+                wezly[liscie + i].zbuduj(krawedzie, std::move(grupy[i]));
+        }
+        std::vector<int> las;
+        for (int k = liscie - 1; k >= 1; k--)
+        {
+            las.clear();
+            wezly[2 * k].dopiszLas(las);
+            wezly[2 * k + 1].dopiszLas(las);
+            if (!las.empty())
+                wezly[k].zbuduj(krawedzie, las);
+        }
+        miejsca.clear();
+        for (i = liscie - 1; i >= 0; i--)
+            if (zajete[i] < pojemnosc)
+                miejsca.push_back(i);
+    }
+
+    // Przenosi zmiany lasu węzła k do kolejnych przodków aż po korzeń. Zdarzenia jednej
+    // krawędzi w dzienniku na przemian dołączają ją i odłączają, więc parzysta liczba się znosi.
+    // zmieniona to krawędź, której waga się zmieniła (albo -1); rodzic ma ją w podgrafie, jeśli
+    // przed zmianą była w lesie dziecka. Krawędzie dołączane są przed usuwanymi, żeby krawędź
+    // wypchnięta z lasu dziecka wypadła też z lasu rodzica, zanim zostanie z niego usunięta.
+    void wGore(int k, int zmieniona = -1)
+    {
+        for (; k > 1; k /= 2)
+        {
+            netto.clear();
+            for (const LasDynamiczny::Zmiana &z : wezly[k].zmiany())
+            {
+                auto it = std::find_if(netto.begin(), netto.end(), [&](const LasDynamiczny::Zmiana &n)
+                                  { return n.numer == z.numer; });
+                if (it == netto.end())
+                    netto.push_back(z);
+                else
+                    netto.erase(it);
+            }
+            wezly[k].wyczyscZmiany();
+            LasDynamiczny &rodzic = wezly[k / 2];
+            bool zmienWage = zmieniona >= 0 && rodzic.zawiera(zmieniona) &&
+                             std::none_of(netto.begin(), netto.end(), [&](const LasDynamiczny::Zmiana &z)
+                                     { return z.numer == zmieniona; });
+            if (netto.empty() && !zmienWage)
+                break;
+            if (zmienWage)
+                rodzic.zmienWage(zmieniona, krawedzie[zmieniona].waga);
+            for (const LasDynamiczny::Zmiana &z : netto)
+                if (z.dodana)
+                    rodzic.dodaj(z.numer, krawedzie[z.numer]);
+            for (const LasDynamiczny::Zmiana &z : netto)
+                if (!z.dodana)
+                    rodzic.usun(z.numer);
+        }
+        wezly[1].wyczyscZmiany();
+    }
+
+public:
+    explicit DynamiczneMST(int V) : V(V), pojemnosc(pojemnoscLiscia(V))
+    {
+        przebuduj(1);
+    }
+
+    // Buduje drzewo sparsyfikacji z grafu. Z krawędzi równoległych zostaje najlżejsza.
+    explicit DynamiczneMST(WidokCSR graf) : V(graf.pobierzV()), pojemnosc(pojemnoscLiscia(V))
+    {
+        std::vector<Krawedz> lista;
+        for (int u = 0; u < V; u++)
+            for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+                if (u < graf.sasiedzi[j])
+                    lista.push_back({u, graf.sasiedzi[j], graf.wagi[j]});
+        std::sort(lista.begin(), lista.end());
+
+        krawedzie.reserve(lista.size());
+        numery.reserve(lista.size());
+        for (const Krawedz &k : lista)
+            if (numery.emplace(klucz(k.u, k.v), (int)krawedzie.size()).second)
+                krawedzie.push_back(k);
+        lisc.assign(krawedzie.size(), 0);
+        int potrzebne = 1;
+        while ((int64_t)potrzebne * pojemnosc < (int64_t)krawedzie.size())
+            potrzebne *= 2;
+        przebuduj(potrzebne);
+    }
+
+    int pobierzV() const
+    {
+        return V;
+    }
+
+    // Dodaje krawędź albo zmienia wagę istniejącej.
+    void dodajKrawedz(int u, int v, int w)
+    {
+        auto it = numery.find(klucz(u, v));
+        if (it != numery.end())
+        {
+            int numer = it->second;
+            krawedzie[numer].waga = w;
+            wezly[lisc[numer]].zmienWage(numer, w);
+            wGore(lisc[numer], numer);
+            return;
+        }
+        if (miejsca.empty())
+            przebuduj(2 * liscie);
+
+        int i = miejsca.back();
+        int numer;
+        if (!wolne.empty())
+        {
+            numer = wolne.back();
+            wolne.pop_back();
+        }
+        else
+        {
+            numer = krawedzie.size();
+            krawedzie.emplace_back();
+            lisc.push_back(-1);
+        }
+        krawedzie[numer] = {u, v, w};
+        lisc[numer] = liscie + i;
+        numery[klucz(u, v)] = numer;
+        if (++zajete[i] == pojemnosc)
+            miejsca.pop_back();
+        wezly[liscie + i].dodaj(numer, krawedzie[numer]);
+        wGore(liscie + i);
+    }
+
+    // Zwraca false, jeśli takiej krawędzi nie było.
+    bool usunKrawedz(int u, int v)
+    {
+        auto it = numery.find(klucz(u, v));
+        if (it == numery.end())
+            return false;
+        int numer = it->second;
+        numery.erase(it);
+        int k = lisc[numer];
+        if (zajete[k - liscie]-- == pojemnosc)
+            miejsca.push_back(k - liscie);
+        lisc[numer] = -1;
+        wolne.push_back(numer);
+        wezly[k].usun(numer);
+        wGore(k);
+        return true;
+    }
+
+    int64_t calkowitaWaga() const
+    {
+        return wezly[1].calkowitaWaga();
+    }
+
+    int64_t liczbaKrawedziLasu() const
+    {
+        return wezly[1].liczbaKrawedziLasu();
+    }
+
+    int64_t liczbaKrawedzi() const
+    {
+        return numery.size();
+    }
+
+    WynikMST drzewoRozpinajace() const
+    {
+        WynikMST wynik;
+        std::vector<int> las;
+        wezly[1].dopiszLas(las);
+        for (int numer : las)
+        {
+            const Krawedz &k = krawedzie[numer];
+            wynik.krawedzie.push_back({k.u, k.v});
+            wynik.waga += k.waga;
+        }
+        return wynik;
+    }
+};
+
+// Losowe zmiany do pomiarów: na przemian usunięcie i ponowne dodanie (z nową wagą z zakresu
+// wag grafu) krawędzi wskazanej przez losowy łuk grafu wejściowego.
+inline void losoweZmianyMST(DynamiczneMST &mst, WidokCSR graf, int liczba, std::mt19937_64 &gen)
+{
+    int64_t luki = graf.offsety[graf.pobierzV()];
+    if (luki == 0)
+        return;
+    std::uniform_int_distribution<int64_t> luk(0, luki - 1);
+    std::uniform_int_distribution<int> waga(graf.minWaga, graf.maksWaga);
+    for (int i = 0; i < liczba; i++)
+    {
+        int64_t j = luk(gen);
+        int u = int(std::upper_bound(graf.offsety, graf.offsety + graf.pobierzV() + 1, j) - graf.offsety) - 1;
+        int v = graf.sasiedzi[j];
+        if (gen() & 1)
+            mst.usunKrawedz(u, v);
+        else
+            mst.dodajKrawedz(u, v, waga(gen));
+    }
+}
+
+// Z cel >= 0 kończy pracę po ustaleniu odległości celu; wtedy tylko ustalone odległości są ostateczne.
+template <typename Macierz>
+WynikOdleglosci obliczDijkstraMacierz(const Macierz &macierz, int zrodlo, ObszarRoboczy &obszar, int cel = -1,
+                                      int64_t *ustalone = nullptr)
+{
+    int V = macierz.pobierzV();
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<int> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, INT_MAX);
+    std::vector<int> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    bool *odwiedzone = obszar.przydziel<bool>(V, false);
+    odleglosci[zrodlo] = 0;
+
+    int64_t ustalonych = 0;
+    for (int i = 0; i < V - 1; i++)
+    {
+        int min = INT_MAX, u = -1;
+        for (int v = 0; v < V; v++)
+        {
+            if (!odwiedzone[v] && odleglosci[v] <= min)
+            {
+                min = odleglosci[v];
+                u = v;
+            }
+        }
+
+        if (u < 0)
+            break; // wszystkie wierzchołki już ustalone
+        if (cel >= 0 && min == INT_MAX)
+            break; // pozostałe wierzchołki, w tym cel, są nieosiągalne
+        odwiedzone[u] = true;
+        ustalonych++;
+        if (u == cel)
+            break;
+
+        LICZ(komorki, V);
+        for (int v = 0; v < V; v++)
+        {
+            SumaWag<Macierz> nowa = (SumaWag<Macierz>)odleglosci[u] + macierz(u, v);
+            if (!odwiedzone[v] && macierz(u, v) && odleglosci[u] != INT_MAX && nowa < odleglosci[v])
+            {
+                LICZ(relaksacje, 1);
+                odleglosci[v] = (int)nowa;
+                poprzednik[v] = u;
+            }
+        }
+    }
+    if (ustalone)
+        *ustalone = ustalonych;
+    return wynik;
+}
+
+inline WynikOdleglosci obliczDijkstraMacierz(const GrafMacierz &graf, int zrodlo, ObszarRoboczy &obszar)
+{
+    return zWidokiemMacierzy<WynikOdleglosci>(graf, [&](const auto &macierz)
+                                              { return obliczDijkstraMacierz(macierz, zrodlo, obszar); });
+}
+
+// Dijkstra na pełnej macierzy z jądrami wektorowymi (zob. obliczPrimMSTMacierzWektorowo);
+// remisy rozstrzyga jak wersja podstawowa, więc także poprzednicy są identyczni.
+template <typename T>
+WynikOdleglosci obliczDijkstraMacierzWektorowo(const WidokMacierzy<T, false> &macierz, int zrodlo, ObszarRoboczy &obszar,
+                                               const OpcjeJaderMacierzy &opcje = {})
+{
+    int V = macierz.pobierzV();
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    StanJadraMacierzy s(V, obszar);
+    MinimumWiersza *czesciowe = obszar.przydziel<MinimumWiersza>(opcje.pula ? opcje.pula->rozmiar() : 1);
+
+    s.klucz[zrodlo] = 0;
+    int u = zrodlo;
+    for (int i = 0; i < V - 1; i++)
+    {
+        s.aktywne[u] = 0;
+        u = przeczesWiersz<T, true, true>(macierz, u, s.klucz[u], s, opcje, czesciowe).indeks;
+        if (u < 0)
+            break; // pozostałe wierzchołki są nieosiągalne
+    }
+    wynik.odleglosci.assign(s.klucz, s.klucz + V);
+    wynik.poprzednik.assign(s.rodzic, s.rodzic + V);
+    return wynik;
+}
+
+template <typename T>
+WynikOdleglosci obliczDijkstraMacierzWektorowo(const WidokMacierzy<T, true> &macierz, int zrodlo, ObszarRoboczy &obszar,
+                                               const OpcjeJaderMacierzy & = {})
+{
+    return obliczDijkstraMacierz(macierz, zrodlo, obszar);
+}
+
+inline WynikOdleglosci obliczDijkstraMacierzWektorowo(const GrafMacierz &graf, int zrodlo, ObszarRoboczy &obszar,
+                                                      const OpcjeJaderMacierzy &opcje = {})
+{
+    return zWidokiemMacierzy<WynikOdleglosci>(graf, [&](const auto &macierz)
+                                              { return obliczDijkstraMacierzWektorowo(macierz, zrodlo, obszar, opcje); });
+}
+
+// Odległości między wszystkimi parami w płaskiej macierzy. Wiersze mają długość dopełnioną do
+// wielokrotności kafelka i zaczynają się na granicy linii pamięci podręcznej; dopełnienie
+// odpowiada izolowanym wierzchołkom (odległość NIESKONCZONOSC) i nie wpływa na wynik.
+class MacierzOdleglosci
+{
+    int V = 0;
+    size_t krok = 0;
+    BuforWyrownany bufor;
+
+public:
+    // Połowa INT_MAX, żeby suma dwóch odległości nie przepełniła int.
+    static constexpr int NIESKONCZONOSC = INT_MAX / 2;
+    bool ujemnyCykl = false;
+
+    MacierzOdleglosci() = default;
+
+    MacierzOdleglosci(int V, size_t krok) : V(V), krok(krok), bufor((size_t)krok * krok * sizeof(int))
+    {
+    }
+
+    int pobierzV() const
+    {
+        return V;
+    }
+
+    size_t pobierzKrok() const
+    {
+        return krok;
+    }
+
+    int *dane()
+    {
+        return bufor.jako<int>();
+    }
+
+    const int *wiersz(int u) const
+    {
+        return bufor.jako<int>() + (size_t)u * krok;
+    }
+
+    // Odległość z u do v albo INT_MAX, gdy v jest nieosiągalny - jak w WynikOdleglosci.
+    int odleglosc(int u, int v) const
+    {
+        int d = wiersz(u)[v];
+        return d >= NIESKONCZONOSC ? INT_MAX : d;
+    }
+
+    // Zapis tekstowy: V w pierwszym wierszu, potem V wierszy odległości ("INF" dla nieosiągalnych).
+    void zapisz(std::ostream &wyjscie) const
+    {
+        Pisarz p(wyjscie);
+        p << V << '\n';
+        for (int u = 0; u < V; u++)
+        {
+            for (int v = 0; v < V; v++)
+            {
+                int d = odleglosc(u, v);
+                if (v > 0)
+                    p << ' ';
+                if (d == INT_MAX)
+                    p << "INF";
+                else
+                    p << d;
+            }
+            p << '\n';
+        }
+    }
+};
+
+// Zapis binarny: int32 V, int32 ujemnyCykl, potem V wierszy po V x int32 (INT_MAX - nieosiągalny).
+inline void zapiszBinarnie(Pisarz &p, const MacierzOdleglosci &wynik)
+{
+    int V = wynik.pobierzV();
+    int32_t naglowek[2] = {V, wynik.ujemnyCykl};
+    p.binarnie(naglowek, sizeof(naglowek));
+    for (int u = 0; u < V; u++)
+        for (int v = 0; v < V; v++)
+            p.binarnie(int32_t(wynik.odleglosc(u, v)));
+}
+
+// Jeden krok Floyda-Warshalla na kafelku: C[i][j] = min(C[i][j], A[i][k] + B[k][j]) dla kolejnych k.
+// A lub B mogą być tym samym kafelkiem co C (faza 1 i 2), więc k musi być pętlą zewnętrzną.
+inline void kafelekFWZalezny(int *C, const int *A, const int *B, size_t krok, int rozmiar)
+{
+    LICZ(komorki, (int64_t)rozmiar * rozmiar * rozmiar);
+    for (int k = 0; k < rozmiar; k++)
+    {
+        const int *Bk = B + (size_t)k * krok;
+        for (int i = 0; i < rozmiar; i++)
+        {
+            int aik = A[(size_t)i * krok + k];
+            int *Ci = C + (size_t)i * krok;
+            for (int j = 0; j < rozmiar; j++)
+                Ci[j] = std::min(Ci[j], aik + Bk[j]);
+        }
+    }
+}
+
+// Faza 3: A i B to kafelki z wiersza i kolumny bieżącego bloku, rozłączne z C, więc można
+// iterować i-k-j (wiersz C zostaje w rejestrach/L1), a pętla po j jest czystym min-plus,
+// który kompilator wektoryzuje.
+inline void kafelekFWNiezalezny(int *__restrict C, const int *__restrict A, const int *__restrict B, size_t krok,
+                                int rozmiar)
+{
+    LICZ(komorki, (int64_t)rozmiar * rozmiar * rozmiar);
+    for (int i = 0; i < rozmiar; i++)
+    {
+        int *__restrict Ci = C + (size_t)i * krok;
+        for (int k = 0; k < rozmiar; k++)
+        {
+            int aik = A[(size_t)i * krok + k];
+            const int *__restrict Bk = B + (size_t)k * krok;
+            for (int j = 0; j < rozmiar; j++)
+                Ci[j] = std::min(Ci[j], aik + Bk[j]);
+        }
+    }
+}
+
+// Kafelkowy Floyd-Warshall (G. Venkataraman, S. Sahni, S. Mukhopadhyaya, "A Blocked All-Pairs
+// Shortest-Paths Algorithm", 2003). Dla każdego bloku k: faza 1 liczy kafelek przekątny, faza 2
+// kafelki z jego wiersza i kolumny, faza 3 całą resztę; kafelki w fazach 2 i 3 są niezależne
+// i dzielone między wątki. Domyślny kafelek 64x64 int to 16 KB, więc trzy kafelki fazy 3
+// mieszczą się w L1/L2.
+// Macierz w tym programie jest symetryczna, więc każda ujemna krawędź daje cykl u-v-u
+// o ujemnej wadze - wtedy wynik ma tylko ujemnyCykl, bez liczenia odległości.
+template <typename Macierz>
+MacierzOdleglosci obliczFloydWarshallMacierz(const Macierz &macierz, PulaWatkow &pula, int kafelek = 64)
+{
+    const int INF = MacierzOdleglosci::NIESKONCZONOSC;
+    int V = macierz.pobierzV();
+    kafelek = std::max(16, kafelek / 16 * 16); // wielokrotność linii pamięci podręcznej
+    int bloki = (V + kafelek - 1) / kafelek;
+    size_t krok = (size_t)bloki * kafelek;
+    MacierzOdleglosci wynik(V, krok);
+    int *d = wynik.dane();
+
+    std::atomic<bool> ujemna{false};
+    pula.dlaPrzedzialow(krok, [&](int, int64_t od, int64_t doK)
+                        {
+        for (int64_t u = od; u < doK; u++)
+        {
+            int *wiersz = d + u * krok;
+            for (size_t v = 0; v < krok; v++)
+            {
+                int w = (u < V && (int64_t)v < V) ? macierz(u, v) : 0;
+                if (w < 0)
+                    ujemna.store(true, std::memory_order_relaxed);
+                wiersz[v] = (int64_t)v == u ? 0 : (w ? w : INF);
+            }
+        } });
+    if (ujemna.load())
+    {
+        wynik.ujemnyCykl = true;
+        return wynik;
+    }
+
+    auto kafel = [&](int bi, int bj)
+    { return d + (size_t)bi * kafelek * krok + (size_t)bj * kafelek; };
+
+    for (int b = 0; b < bloki; b++)
+    {
+        int *przekatny = kafel(b, b);
+        kafelekFWZalezny(przekatny, przekatny, przekatny, krok, kafelek);
+
+        // Faza 2: indeksy 0 .. bloki-2 to kafelki wiersza b, kolejne - kafelki kolumny b.
+        pula.dlaPrzedzialow(2 * (bloki - 1), [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t t = od; t < doK; t++)
+            {
+                int inny = (int)(t % (bloki - 1));
+                inny += inny >= b;
+                if (t < bloki - 1)
+                    kafelekFWZalezny(kafel(b, inny), przekatny, kafel(b, inny), krok, kafelek);
+                else
+                    kafelekFWZalezny(kafel(inny, b), kafel(inny, b), przekatny, krok, kafelek);
+            } });
+
+        pula.dlaPrzedzialow((int64_t)(bloki - 1) * (bloki - 1), [&](int, int64_t od, int64_t doK)
+                            {
+            for (int64_t t = od; t < doK; t++)
+            {
+                int bi = (int)(t / (bloki - 1)), bj = (int)(t % (bloki - 1));
+                bi += bi >= b;
+                bj += bj >= b;
+                kafelekFWNiezalezny(kafel(bi, bj), kafel(bi, b), kafel(b, bj), krok, kafelek);
+            } });
+    }
+    return wynik;
+}
+
+inline MacierzOdleglosci obliczFloydWarshallMacierz(const GrafMacierz &graf, PulaWatkow &pula, int kafelek = 64)
+{
+    return zWidokiemMacierzy<MacierzOdleglosci>(graf, [&](const auto &macierz)
+                                                { return obliczFloydWarshallMacierz(macierz, pula, kafelek); });
+}
+
+template <typename Kolejka, typename W, typename Id>
+WynikOdleglosciOgolny<typename CechyWagi<W>::Odleglosc, Id> obliczDijkstraLista(WidokCSROgolny<W, Id> graf, Id zrodlo,
+                                                                              ObszarRoboczy &obszar)
+{
+    using Odleglosc = typename CechyWagi<W>::Odleglosc;
+    constexpr Odleglosc NIESKONCZONOSC = CechyWagi<W>::NIESKONCZONOSC;
+    Id V = graf.pobierzV();
+    WynikOdleglosciOgolny<Odleglosc, Id> wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<Odleglosc> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, NIESKONCZONOSC);
+    std::vector<Id> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    Kolejka &kolejka = obszar.kolejka<Kolejka>(V, CechyWagi<W>::WASKIE ? (int64_t)graf.maksWaga : 0);
+    odleglosci[zrodlo] = 0;
+    kolejka.ustaw(zrodlo, 0);
+
+    while (!kolejka.pusta())
+    {
+        Id u = kolejka.zdejmijMin().second;
+
+        LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            Id v = graf.sasiedzi[j];
+            SumaWag<WidokCSROgolny<W, Id>> nowa = (SumaWag<WidokCSROgolny<W, Id>>)odleglosci[u] + graf.wagi[j];
+            if (nowa < odleglosci[v])
+            {
+                LICZ(relaksacje, 1);
+                odleglosci[v] = (Odleglosc)nowa;
+                poprzednik[v] = u;
+                kolejka.ustaw(v, odleglosci[v]);
+            }
+        }
+    }
+    return wynik;
+}
+
+// Przyjmuje WidokCSROgolny albo GrafCSROgolny dowolnych typów wagi i wierzchołka.
+template <typename Graf>
+WynikOdleglosciDla<Graf> obliczDijkstraLista(const Graf &graf, typename Graf::Wierzcholek zrodlo, ObszarRoboczy &obszar,
+                                             RodzajKolejki rodzaj = RodzajKolejki::Binarna)
+{
+    using W = typename Graf::Waga;
+    using Id = typename Graf::Wierzcholek;
+    using Klucz = OdlegloscWag<Graf>;
+    typename Graf::Widok g = graf;
+    // okno kluczy kolejki kubełkowej wymaga wag nieujemnych, do 32 bitów i niezbyt szerokiego zakresu
+    if (rodzaj == RodzajKolejki::Kubelkowa &&
+        (!CechyWagi<W>::WASKIE || g.minWaga < 0 || !KolejkaKubelkowa<>::obsluguje(g.maksWaga, g.pobierzV())))
+        rodzaj = RodzajKolejki::DArna;
+    switch (rodzaj)
+    {
+    case RodzajKolejki::Kubelkowa:
+        if constexpr (CechyWagi<W>::WASKIE)
+            return obliczDijkstraLista<KolejkaKubelkowa<Klucz, Id>>(g, zrodlo, obszar);
+        [[fallthrough]];
+    case RodzajKolejki::DArna:
+        return obliczDijkstraLista<KopiecDArny<4, Klucz, Id>>(g, zrodlo, obszar);
+    case RodzajKolejki::Parujaca:
+        return obliczDijkstraLista<KopiecParujacy<Klucz, Id>>(g, zrodlo, obszar);
+    default:
+        return obliczDijkstraLista<KolejkaLeniwa<Klucz, Id>>(g, zrodlo, obszar);
+    }
+}
+
+struct StatystykiPartii
+{
+    int64_t zapytania = 0;
+    int watki = 1;
+    double czas = 0;                                        // milisekundy całej partii
+    int64_t opoznienieMin = 0, p50 = 0, p90 = 0, p99 = 0, opoznienieMaks = 0; // nanosekundy na zapytanie
+};
+
+inline std::string opiszStatystyki(const StatystykiPartii &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(1) << "zapytania=" << st.zapytania << " watki=" << st.watki
+         << " czas_ms=" << st.czas << " zapytan_na_s=" << (st.czas > 0 ? st.zapytania * 1000.0 / st.czas : 0.0)
+         << " opoznienie_min_ns=" << st.opoznienieMin << " p50_ns=" << st.p50 << " p90_ns=" << st.p90
+         << " p99_ns=" << st.p99 << " maks_ns=" << st.opoznienieMaks;
+    return opis.str();
+}
+
+// Zapytania Dijkstry z wielu źródeł na jednym grafie. Źródła rozdzielane są między wątki puli
+// z kradzieżą pracy, a każdy wątek ma własny obszar roboczy, zachowywany między partiami.
+// Gotowy wynik od razu trafia do odbiorcy; wywołania odbierz są szeregowane blokadą, więc
+// odbiorca może pisać do wspólnego strumienia, a wyniki przychodzą w kolejności kończenia zapytań.
+class PartiaZapytan
+{
+    PulaWatkow &pula;
+    std::vector<ObszarRoboczy> obszary;
+    std::vector<int64_t> opoznienia;
+    std::mutex blokada;
+
+public:
+    explicit PartiaZapytan(PulaWatkow &pula) : pula(pula), obszary(pula.rozmiar()) {}
+
+    // odbierz(i, wynik, czasNs): i to indeks źródła w zrodla, czasNs - czas samego obliczenia.
+    template <typename F>
+    StatystykiPartii wykonaj(WidokCSR graf, const std::vector<int> &zrodla, RodzajKolejki rodzaj, F &&odbierz)
+    {
+        opoznienia.clear();
+        opoznienia.reserve(zrodla.size());
+        auto start = std::chrono::steady_clock::now();
+        pula.dlaZadanZKradzieza((int64_t)zrodla.size(), [&](int t, int64_t i)
+                                {
+                                    obszary[t].resetuj();
+                                    auto poczatek = std::chrono::steady_clock::now();
+                                    WynikOdleglosci wynik = obliczDijkstraLista(graf, zrodla[i], obszary[t], rodzaj);
+                                    int64_t czas = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - poczatek).count();
+                                    std::lock_guard<std::mutex> b(blokada);
+                                    opoznienia.push_back(czas);
+                                    odbierz(i, wynik, czas); });
+
+        StatystykiPartii st;
+        st.czas = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        st.zapytania = (int64_t)opoznienia.size();
+        st.watki = pula.rozmiar();
+        if (!opoznienia.empty())
+        {
+            std::sort(opoznienia.begin(), opoznienia.end());
+            auto percentyl = [&](double q)
+            { return opoznienia[(size_t)std::ceil(q * opoznienia.size()) - 1]; };
+            st.opoznienieMin = opoznienia.front();
+            st.p50 = percentyl(0.5);
+            st.p90 = percentyl(0.9);
+            st.p99 = percentyl(0.99);
+            st.opoznienieMaks = opoznienia.back();
+        }
+        return st;
+    }
+
+    // Bajty obszarów roboczych wszystkich wątków w ostatniej partii.
+    size_t pobierzRozmiarBajtow() const
+    {
+        size_t bajty = 0;
+        for (const auto &obszar : obszary)
+            bajty += obszar.pobierzZajete() + obszar.pobierzBajtyKolejki();
+        return bajty;
+    }
+};
+
+// Rdzenie, na których proces może działać (maska z sched_getaffinity na Linuksie, więc
+// uwzględnia taskset i cgroups); gdzie indziej 0 .. hardware_concurrency() - 1.
+inline std::vector<int> dostepneRdzenie()
+{
+    std::vector<int> rdzenie;
+#ifdef __linux__
+    cpu_set_t zbior;
+    CPU_ZERO(&zbior);
+    if (sched_getaffinity(0, sizeof(zbior), &zbior) == 0)
+        for (int i = 0; i < CPU_SETSIZE; i++)
+            if (CPU_ISSET(i, &zbior))
+                rdzenie.push_back(i);
+#endif
+    if (rdzenie.empty())
+        for (int i = 0; i < (int)std::max(1u, std::thread::hardware_concurrency()); i++)
+            rdzenie.push_back(i);
+    return rdzenie;
+}
+
+// Ogranicza bieżący wątek do podanych rdzeni; false, gdy system na to nie pozwala.
+inline bool przypnijWatek(const std::vector<int> &rdzenie)
+{
+    if (rdzenie.empty())
+        return false;
+#ifdef __linux__
+    cpu_set_t zbior;
+    CPU_ZERO(&zbior);
+    for (int r : rdzenie)
+        CPU_SET(r, &zbior);
+    return pthread_setaffinity_np(pthread_self(), sizeof(zbior), &zbior) == 0;
+#elif defined(_WIN32)
+    DWORD_PTR maska = 0;
+    for (int r : rdzenie)
+        if (r < (int)(8 * sizeof(DWORD_PTR)))
+            maska |= (DWORD_PTR)1 << r;
+    return maska && SetThreadAffinityMask(GetCurrentThread(), maska) != 0;
+#else
+    return false;
+#endif
+}
+
+struct KonfiguracjaProb
+{
+    int proby = 1;
+    int rownolegle = 1;     // próby liczone jednocześnie, każda w wątku przypiętym do własnego rdzenia
+    int generatory = 1;     // wątki przygotowujące w tle grafy kolejnych prób; 0 - bez potoku
+    int wyprzedzenie = 2;   // grafy przygotowane na zapas ponad liczone właśnie próby
+    bool izolowany = false; // jeden wątek pomiarowy na rdzeniu, na który nie wchodzą generatory
+};
+
+struct StatystykiProb
+{
+    int64_t proby = 0;
+    int watkiPomiarowe = 0;
+    int generatory = 0;
+    double czas = 0;        // milisekundy całego harmonogramu
+    double oczekiwanie = 0; // milisekundy, łącznie dla wątków pomiarowych czekających na graf
+    std::vector<int> rdzenie;    // rdzenie wątków pomiarowych
+    bool przypiete = true;  // czy wszystkie wątki pomiarowe udało się przypiąć
+};
+
+inline std::string opiszStatystyki(const StatystykiProb &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(1) << "proby=" << st.proby << " watki_pomiarowe=" << st.watkiPomiarowe
+         << " generatory=" << st.generatory << " czas_ms=" << st.czas << " oczekiwanie_ms=" << st.oczekiwanie
+         << " rdzenie=";
+    for (size_t i = 0; i < st.rdzenie.size(); i++)
+        opis << (i ? "," : "") << st.rdzenie[i];
+    opis << (st.przypiete ? "" : " (bez przypięcia)");
+    return opis.str();
+}
+
+// Harmonogram powtarzanych prób: przygotuj(i, graf) buduje dane próby i, a zmierz(i, graf,
+// obszar, wyjscie) ją liczy i opisuje. Generatory przygotowują w tle grafy kolejnych prób do
+// pierścienia rownolegle + wyprzedzenie miejsc (Graf jest tworzony raz na miejsce i używany
+// ponownie), więc wątek pomiarowy zwykle nie czeka na generator. Wątki pomiarowe są przypięte
+// każdy do innego rdzenia i mają własne obszary robocze. W trybie izolowanym jest jeden wątek
+// pomiarowy, a generatory działają tylko na pozostałych rdzeniach; gdy innych rdzeni nie ma,
+// graf powstaje w wątku pomiarowym między próbami. Wyjście każdej próby jest buforowane
+// i trafia do wyjscie w kolejności numerów prób, jak przy liczeniu szeregowym.
+template <typename Graf>
+class HarmonogramProb
+{
+    KonfiguracjaProb k;
+    std::vector<Graf> miejsca;
+    std::vector<ObszarRoboczy> obszary;
+
+public:
+    explicit HarmonogramProb(const KonfiguracjaProb &konfiguracja) : k(konfiguracja) {}
+
+    template <typename Przygotuj, typename Zmierz>
+    StatystykiProb wykonaj(Przygotuj &&przygotuj, Zmierz &&zmierz, std::ostream &wyjscie)
+    {
+        int P = std::max(k.proby, 0);
+        std::vector<int> rdzenie = dostepneRdzenie();
+        // więcej wątków pomiarowych niż rdzeni dzieliłoby rdzeń i psuło pomiary czasu
+        int pomiarowe = k.izolowany ? 1 : std::max(1, std::min({k.rownolegle, std::max(P, 1), (int)rdzenie.size()}));
+        int generatory = std::max(k.generatory, 0);
+        std::vector<int> rdzenieGeneratorow; // puste - generatory nieprzypięte
+        if (k.izolowany)
+        {
+            rdzenieGeneratorow.assign(rdzenie.begin() + 1, rdzenie.end());
+            if (rdzenieGeneratorow.empty())
+                generatory = 0;
+        }
+        int liczbaMiejsc = generatory > 0 ? pomiarowe + std::max(k.wyprzedzenie, 1) : pomiarowe;
+        miejsca.resize(liczbaMiejsc);
+        obszary.resize(pomiarowe);
+
+        StatystykiProb st;
+        st.proby = P;
+        st.watkiPomiarowe = pomiarowe;
+        st.generatory = generatory;
+        for (int t = 0; t < pomiarowe; t++)
+            st.rdzenie.push_back(rdzenie[t % rdzenie.size()]);
+
+        std::mutex m;
+        std::condition_variable zmiana;
+        std::deque<int> wolne, gotowe; // numery miejsc; gotowe - w kolejności przygotowania
+        std::vector<int> probaMiejsca(liczbaMiejsc, -1);
+        for (int i = 0; i < liczbaMiejsc; i++)
+            wolne.push_back(i);
+        int przygotowywane = 0, pobrane = 0, doWypisania = 0;
+        std::vector<std::string> opisy(P);
+        std::vector<char> zakonczone(P, 0);
+        std::vector<int64_t> oczekiwanie(pomiarowe, 0);
+        std::atomic<bool> przypiete{true};
+
+        auto generator = [&]
+        {
+            if (!rdzenieGeneratorow.empty())
+                przypnijWatek(rdzenieGeneratorow);
+            while (true)
+            {
+                std::unique_lock<std::mutex> blokada(m);
+                zmiana.wait(blokada, [&]
+                            { return przygotowywane >= P || !wolne.empty(); });
+                if (przygotowywane >= P)
+                    return;
+                int proba = przygotowywane++, miejsce = wolne.front();
+                wolne.pop_front();
+                blokada.unlock();
+                przygotuj(proba, miejsca[miejsce]);
+                blokada.lock();
+                probaMiejsca[miejsce] = proba;
+                gotowe.push_back(miejsce);
+                zmiana.notify_all();
+            }
+        };
+
+        auto pomiar = [&](int t)
+        {
+            if (!przypnijWatek({st.rdzenie[t]}))
+                przypiete = false;
+            std::ostringstream opis;
+            while (true)
+            {
+                int proba, miejsce;
+                if (generatory == 0)
+                {
+                    {
+                        std::lock_guard<std::mutex> blokada(m);
+                        if (pobrane >= P)
+                            return;
+                        proba = pobrane++;
+                    }
+                    miejsce = t;
+                    przygotuj(proba, miejsca[miejsce]);
+                }
+                else
+                {
+                    auto poczatek = std::chrono::steady_clock::now();
+                    std::unique_lock<std::mutex> blokada(m);
+                    zmiana.wait(blokada, [&]
+                                { return pobrane >= P || !gotowe.empty(); });
+                    oczekiwanie[t] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - poczatek).count();
+                    if (gotowe.empty())
+                        return;
+                    miejsce = gotowe.front();
+                    gotowe.pop_front();
+                    proba = probaMiejsca[miejsce];
+                    pobrane++;
+                }
+
+                opis.str("");
+                const Graf &graf = miejsca[miejsce];
+                zmierz(proba, graf, obszary[t], opis);
+
+                std::lock_guard<std::mutex> blokada(m);
+                if (generatory > 0)
+                    wolne.push_back(miejsce);
+                opisy[proba] = opis.str();
+                zakonczone[proba] = 1;
+                for (; doWypisania < P && zakonczone[doWypisania]; doWypisania++)
+                {
+                    wyjscie << opisy[doWypisania];
+                    std::string().swap(opisy[doWypisania]);
+                }
+                zmiana.notify_all();
+            }
+        };
+
+        // Wszystkie wątki są nowe, żeby przypięcie nie zostało na wątku wywołującym.
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> watki;
+        for (int g = 0; g < generatory; g++)
+            watki.emplace_back(generator);
+        for (int t = 0; t < pomiarowe; t++)
+            watki.emplace_back(pomiar, t);
+        for (auto &w : watki)
+            w.join();
+        wyjscie.flush();
+        st.czas = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (int64_t o : oczekiwanie)
+            st.oczekiwanie += o / 1e6;
+        st.przypiete = przypiete.load();
+        return st;
+    }
+};
+
+// Wynik zapytania o najkrótszą ścieżkę między jedną parą wierzchołków.
+struct WynikZapytania
+{
+    int zrodlo = -1, cel = -1;
+    int odleglosc = INT_MAX; // INT_MAX - cel nieosiągalny ze źródła
+    std::vector<int> sciezka;     // zrodlo, ..., cel; pusta, gdy cel jest nieosiągalny
+    int64_t ustalone = 0;    // wierzchołki, których odległość została ustalona (zdjęte z kolejki)
+};
+
+inline void zapiszSciezke(Pisarz &p, const WynikZapytania &wynik)
+{
+    if (wynik.odleglosc == INT_MAX)
+    {
+        p << "Wierzchołek " << wynik.cel << " jest nieosiągalny z " << wynik.zrodlo << '\n';
+        return;
+    }
+    p << "Ścieżka z " << wynik.zrodlo << " do " << wynik.cel << " (długość " << wynik.odleglosc << "): ";
+    for (size_t i = 0; i < wynik.sciezka.size(); i++)
+        p << (i ? " -> " : "") << wynik.sciezka[i];
+    p << '\n';
+}
+
+// Heurystyka A* równa zeru - A* z nią to zwykły Dijkstra kończony po ustaleniu celu.
+struct HeurystykaZerowa
+{
+    int operator()(int) const
+    {
+        return 0;
+    }
+};
+
+// Przeszukiwanie Dijkstry/A* od jednego źródła, rozwijane krok po kroku przez wywołującego.
+// Tablice są znakowane numerem zapytania zamiast czyszczenia, więc kolejne zapytania na tym
+// samym grafie kosztują tyle, ile przeszukany fragment grafu, a nie O(V). Kolejka to leniwy
+// kopiec binarny z kluczem odległość + heurystyka; wpisy już ustalonych wierzchołków są
+// pomijane przy zdejmowaniu. Wymaga wag nieujemnych i heurystyki spójnej (h(u) <= w(u, v) + h(v)).
+class PrzeszukiwanieDoCelu
+{
+    std::vector<int> odl, poprzednik;
+    std::vector<uint32_t> znacznik; // numer zapytania, w którym wierzchołek dostał odległość
+    std::vector<uint32_t> ustalony; // numer zapytania, w którym jego odległość została ustalona
+    std::vector<std::pair<int64_t, int>> kopiec;
+    uint32_t numer = 0;
+    int64_t ustalonych = 0;
+
+    template <typename Heurystyka>
+    void ustaw(int v, int d, int p, const Heurystyka &h)
+    {
+        LICZ(wstawienia, 1);
+        odl[v] = d;
+        poprzednik[v] = p;
+        znacznik[v] = numer;
+        kopiec.push_back({(int64_t)d + h(v), v});
+        std::push_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<int64_t, int>>());
+    }
+
+    void pominUstalone()
+    {
+        while (!kopiec.empty() && ustalony[kopiec.front().second] == numer)
+        {
+            LICZ(nieaktualne, 1);
+            std::pop_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<int64_t, int>>());
+            kopiec.pop_back();
+        }
+    }
+
+public:
+    template <typename Heurystyka>
+    void rozpocznij(int V, int zrodlo, const Heurystyka &h)
+    {
+        if ((int)znacznik.size() != V)
+        {
+            odl.resize(V);
+            poprzednik.resize(V);
+            znacznik.assign(V, 0);
+            ustalony.assign(V, 0);
+            numer = 0;
+        }
+        if (++numer == 0)
+        {
+            // licznik zapytań się przekręcił - jedyny moment, w którym tablice są czyszczone
+            std::fill(znacznik.begin(), znacznik.end(), 0);
+            std::fill(ustalony.begin(), ustalony.end(), 0);
+            numer = 1;
+        }
+        kopiec.clear();
+        ustalonych = 0;
+        ustaw(zrodlo, 0, -1, h);
+    }
+
+    int odleglosc(int v) const
+    {
+        return znacznik[v] == numer ? odl[v] : INT_MAX;
+    }
+
+    bool czyUstalony(int v) const
+    {
+        return ustalony[v] == numer;
+    }
+
+    int64_t pobierzUstalone() const
+    {
+        return ustalonych;
+    }
+
+    // Najmniejszy klucz w kolejce albo INT64_MAX, gdy kolejka jest pusta.
+    int64_t minKlucz()
+    {
+        pominUstalone();
+        return kopiec.empty() ? INT64_MAX : kopiec.front().first;
+    }
+
+    // Ustala następny wierzchołek i relaksuje jego krawędzie. Dla każdej krawędzi (u, v) woła
+    // dlaKrawedzi(u, v, odleglosc(u) + waga). Zwraca ustalony wierzchołek albo -1, gdy kolejka jest pusta.
+    template <typename Heurystyka, typename F>
+    int krok(WidokCSR graf, const Heurystyka &h, F &&dlaKrawedzi)
+    {
+        pominUstalone();
+        if (kopiec.empty())
+            return -1;
+        LICZ(zdjecia, 1);
+        std::pop_heap(kopiec.begin(), kopiec.end(), std::greater<std::pair<int64_t, int>>());
+        int u = kopiec.back().second;
+        kopiec.pop_back();
+        ustalony[u] = numer;
+        ustalonych++;
+
+        int du = odl[u];
+        LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            int v = graf.sasiedzi[j];
+            SumaWag<WidokCSR> nowa = (SumaWag<WidokCSR>)du + graf.wagi[j];
+            dlaKrawedzi(u, v, nowa);
+            if (ustalony[v] != numer && nowa < odleglosc(v))
+            {
+                LICZ(relaksacje, 1);
+                ustaw(v, (int)nowa, u, h);
+            }
+        }
+        return u;
+    }
+
+    // Ścieżka od źródła do v po poprzednikach; v musi mieć odległość w bieżącym zapytaniu.
+    std::vector<int> sciezkaDo(int v) const
+    {
+        std::vector<int> sciezka;
+        for (; v >= 0; v = poprzednik[v])
+            sciezka.push_back(v);
+        std::reverse(sciezka.begin(), sciezka.end());
+        return sciezka;
+    }
+};
+
+// A* od zrodlo do cel z heurystyką h(v) - dolnym ograniczeniem odległości v od celu.
+// Z HeurystykaZerowa to Dijkstra zatrzymywany w chwili ustalenia celu.
+template <typename Heurystyka>
+WynikZapytania obliczAGwiazdka(WidokCSR graf, int zrodlo, int cel, PrzeszukiwanieDoCelu &stan, const Heurystyka &h)
+{
+    WynikZapytania wynik;
+    wynik.zrodlo = zrodlo;
+    wynik.cel = cel;
+    stan.rozpocznij(graf.pobierzV(), zrodlo, h);
+    while (true)
+    {
+        int u = stan.krok(graf, h, [](int, int, SumaWag<WidokCSR>) {});
+        if (u < 0)
+            break;
+        if (u == cel)
+        {
+            wynik.odleglosc = stan.odleglosc(cel);
+            wynik.sciezka = stan.sciezkaDo(cel);
+            break;
+        }
+    }
+    wynik.ustalone = stan.pobierzUstalone();
+    return wynik;
+}
+
+inline WynikZapytania obliczDijkstraDoCelu(WidokCSR graf, int zrodlo, int cel, PrzeszukiwanieDoCelu &stan)
+{
+    return obliczAGwiazdka(graf, zrodlo, cel, stan, HeurystykaZerowa());
+}
+
+// Dwukierunkowy Dijkstra: przeszukiwania od źródła i od celu (graf jest nieskierowany, więc
+// przeszukiwanie wsteczne to zwykłe przeszukiwanie od celu), w każdym kroku rozwijane jest to
+// z mniejszym kluczem. mi to długość najkrótszej dotąd ścieżki przez krawędź między obydwoma
+// przeszukaniami; gdy suma najmniejszych kluczy obu kolejek osiąga mi, żadna krótsza już nie istnieje.
+inline WynikZapytania obliczDijkstraDwukierunkowy(WidokCSR graf, int zrodlo, int cel, PrzeszukiwanieDoCelu &przod,
+                                                  PrzeszukiwanieDoCelu &tyl)
+{
+    WynikZapytania wynik;
+    wynik.zrodlo = zrodlo;
+    wynik.cel = cel;
+    HeurystykaZerowa h;
+    przod.rozpocznij(graf.pobierzV(), zrodlo, h);
+    tyl.rozpocznij(graf.pobierzV(), cel, h);
+    SumaWag<WidokCSR> mi = zrodlo == cel ? 0 : INT64_MAX;
+    int koniecPrzod = zrodlo, koniecTyl = cel; // krawędź łącząca oba przeszukania na najlepszej ścieżce
+    while (true)
+    {
+        int64_t kluczPrzod = przod.minKlucz(), kluczTyl = tyl.minKlucz();
+        if (kluczPrzod == INT64_MAX || kluczTyl == INT64_MAX || kluczPrzod + kluczTyl >= mi)
+            break;
+        bool doPrzodu = kluczPrzod <= kluczTyl;
+        PrzeszukiwanieDoCelu &ten = doPrzodu ? przod : tyl;
+        const PrzeszukiwanieDoCelu &drugi = doPrzodu ? tyl : przod;
+        ten.krok(graf, h, [&](int u, int v, SumaWag<WidokCSR> nowa)
+                 {
+                     int dv = drugi.odleglosc(v);
+                     if (dv != INT_MAX && nowa + dv < mi)
+                     {
+                         mi = nowa + dv;
+                         koniecPrzod = doPrzodu ? u : v;
+                         koniecTyl = doPrzodu ? v : u;
+                     } });
+    }
+    wynik.ustalone = przod.pobierzUstalone() + tyl.pobierzUstalone();
+    if (mi < INT_MAX)
+    {
+        wynik.odleglosc = (int)mi;
+        wynik.sciezka = przod.sciezkaDo(koniecPrzod);
+        std::vector<int> doCelu = tyl.sciezkaDo(koniecTyl);
+        wynik.sciezka.insert(wynik.sciezka.end(), doCelu.rbegin() + (koniecPrzod == koniecTyl), doCelu.rend());
+    }
+    return wynik;
+}
+
+// Punkty orientacyjne dla A* (ALT: A. Goldberg, C. Harrelson, "Computing the Shortest Path:
+// A* Search Meets Graph Theory", 2005). W grafie nieskierowanym o wagach nieujemnych
+// |d(L, t) - d(L, v)| <= d(v, t) dla każdego punktu L, więc maksimum po punktach jest
+// dopuszczalną i spójną heurystyką. Punkty wybierane są zachłannie: każdy kolejny to wierzchołek
+// najdalszy od już wybranych (pierwszy - najdalszy od wierzchołka start).
+class PunktyOrientacyjne
+{
+    int liczba = 0;
+    std::vector<int> punkty;
+    std::vector<int> odleglosci; // V * liczba: odległości wierzchołka od wszystkich punktów leżą obok siebie
+
+public:
+    class Heurystyka
+    {
+        const int *odleglosci, *celu;
+        int liczba;
+
+    public:
+        Heurystyka(const int *odleglosci, const int *celu, int liczba) : odleglosci(odleglosci), celu(celu), liczba(liczba) {}
+
+        int operator()(int v) const
+        {
+            const int *dv = odleglosci + (size_t)v * liczba;
+            int h = 0;
+            for (int l = 0; l < liczba; l++)
+                if (dv[l] != INT_MAX && celu[l] != INT_MAX)
+                    h = std::max(h, std::abs(celu[l] - dv[l]));
+            return h;
+        }
+    };
+
+    PunktyOrientacyjne() = default;
+
+    PunktyOrientacyjne(WidokCSR graf, int ile, int start = 0)
+    {
+        int V = graf.pobierzV();
+        liczba = V > 0 ? std::min(std::max(ile, 0), V) : 0;
+        odleglosci.assign((size_t)V * liczba, INT_MAX);
+        if (liczba == 0)
+            return;
+        ObszarRoboczy obszar;
+        std::vector<int> najblizszy = obliczDijkstraLista(graf, start, obszar).odleglosci; // do najbliższego punktu
+        for (int l = 0; l < liczba; l++)
+        {
+            int punkt = start;
+            for (int v = 0; v < V; v++)
+                if (najblizszy[v] != INT_MAX && najblizszy[v] > najblizszy[punkt])
+                    punkt = v;
+            punkty.push_back(punkt);
+            obszar.resetuj();
+            WynikOdleglosci d = obliczDijkstraLista(graf, punkt, obszar);
+            for (int v = 0; v < V; v++)
+            {
+                odleglosci[(size_t)v * liczba + l] = d.odleglosci[v];
+                if (l == 0)
+                    najblizszy[v] = d.odleglosci[v];
+                else
+                    najblizszy[v] = std::min(najblizszy[v], d.odleglosci[v]);
+            }
+        }
+    }
+
+    Heurystyka dlaCelu(int cel) const
+    {
+        return Heurystyka(odleglosci.data(), odleglosci.data() + (size_t)cel * liczba, liczba);
+    }
+
+    const std::vector<int> &pobierzPunkty() const
+    {
+        return punkty;
+    }
+
+    size_t pobierzRozmiarBajtow() const
+    {
+        return odleglosci.size() * sizeof(int);
+    }
+};
+
+inline WynikZapytania obliczALT(WidokCSR graf, int zrodlo, int cel, const PunktyOrientacyjne &punkty,
+                                PrzeszukiwanieDoCelu &stan)
+{
+    return obliczAGwiazdka(graf, zrodlo, cel, stan, punkty.dlaCelu(cel));
+}
+
+// Dijkstra macierzowy kończony po ustaleniu celu.
+inline WynikZapytania obliczDijkstraMacierzDoCelu(const GrafMacierz &graf, int zrodlo, int cel, ObszarRoboczy &obszar)
+{
+    WynikZapytania wynik;
+    wynik.zrodlo = zrodlo;
+    wynik.cel = cel;
+    WynikOdleglosci w = zWidokiemMacierzy<WynikOdleglosci>(graf, [&](const auto &macierz)
+                                                           { return obliczDijkstraMacierz(macierz, zrodlo, obszar, cel, &wynik.ustalone); });
+    wynik.odleglosc = w.odleglosci[cel];
+    if (wynik.odleglosc != INT_MAX)
+        wynik.sciezka = odtworzSciezke(w, cel);
+    return wynik;
+}
+
+struct StatystykiDeltaStepping
+{
+    int delta = 0;
+    int watki = 1;
+    int64_t kubelki = 0;    // przetworzone niepuste kubełki
+    int64_t fazyLekkie = 0; // rundy relaksacji lekkich krawędzi
+    int64_t relaksacje = 0; // udane zmniejszenia odległości
+    double czasLekkie = 0, czasCiezkie = 0, czasKubelki = 0; // milisekundy
+};
+
+// Szerokość kubełka rzędu (maksymalna waga / średni stopień) - typowy kompromis między
+// liczbą kubełków a liczbą ponownych relaksacji.
+inline int domyslnaDelta(WidokCSR graf)
+{
+    int64_t sasiedzi = std::max<int64_t>(graf.offsety[graf.V], 1);
+    return (int)std::max<int64_t>(1, (int64_t)graf.maksWaga * graf.V / sasiedzi);
+}
+
+// Równoległy delta-stepping (Meyer, Sanders) dla wag nieujemnych. Wierzchołek o odległości d
+// czeka w kubełku d / delta; kubełki są przetwarzane po kolei, w każdym najpierw do skutku
+// relaksowane są lekkie krawędzie (waga <= delta), a na końcu raz ciężkie. Relaksacje w obrębie
+// fazy wykonują wątki puli, zmniejszając odległości atomowo; kolejki kubełków uzupełnia
+// wątek główny między fazami. Pamiętanych jest tylko maksWaga / delta + 2 kubełków
+// (bufor cykliczny), bo wszystkie oczekujące odległości mieszczą się w oknie maksWaga.
+inline WynikOdleglosci obliczDeltaStepping(WidokCSR graf, int zrodlo, PulaWatkow &pula, int delta = 0,
+                                    StatystykiDeltaStepping *statystyki = nullptr)
+{
+    const int PROG_ROWNOLEGLOSCI = 4096; // mniej krawędzi w fazie - relaksujemy w jednym wątku
+    if (graf.minWaga < 0)
+    {
+        ObszarRoboczy obszar;
+        return obliczDijkstraLista(graf, zrodlo, obszar, RodzajKolejki::DArna); // kubełki wymagają wag nieujemnych
+    }
+    int V = graf.pobierzV();
+    int W = pula.rozmiar();
+    if (delta <= 0)
+        delta = domyslnaDelta(graf);
+    StatystykiDeltaStepping st;
+    st.delta = delta;
+    st.watki = W;
+
+    std::vector<std::atomic<int>> odl(V);
+    for (auto &d : odl)
+        d.store(INT_MAX, std::memory_order_relaxed);
+    int64_t liczbaKubelkow = std::max(graf.maksWaga, 0) / delta + 2;
+    std::vector<std::vector<int>> kubelki(liczbaKubelkow);
+    std::vector<int64_t> kubelekWierzcholka(V, -1); // kubełek, w którym v czeka (-1 - nie czeka)
+    std::vector<int64_t> rozliczony(V, -1);         // ostatni kubełek, w którym v trafił do zbioru R
+    std::vector<std::vector<int>> zmienione(W);
+    std::vector<int64_t> relaksacje(W, 0);
+    std::vector<int> aktywne, R;
+
+    auto relaksuj = [&](int t, int v, bool lekkie)
+    {
+        int dv = odl[v].load(std::memory_order_relaxed);
+        LICZ(krawedzie, graf.offsety[v + 1] - graf.offsety[v]);
+        for (int64_t j = graf.offsety[v]; j < graf.offsety[v + 1]; j++)
+        {
+            int waga = graf.wagi[j];
+            if ((waga <= delta) != lekkie)
+                continue;
+            int u = graf.sasiedzi[j];
+            int nowa = (int)std::min<SumaWag<WidokCSR>>((SumaWag<WidokCSR>)dv + waga, INT_MAX);
+            int stara = odl[u].load(std::memory_order_relaxed);
+            while (nowa < stara && !odl[u].compare_exchange_weak(stara, nowa, std::memory_order_relaxed))
+            {
+            }
+            if (nowa < stara)
+            {
+                zmienione[t].push_back(u);
+                relaksacje[t]++;
+            }
+        }
+    };
+
+    // relaksuje krawędzie wszystkich wierzchołków z listy, równolegle jeśli jest ich dość dużo
+    auto faza = [&](const std::vector<int> &lista, bool lekkie)
+    {
+        int64_t praca = 0;
+        for (int v : lista)
+            praca += graf.offsety[v + 1] - graf.offsety[v];
+        if (W == 1 || praca < PROG_ROWNOLEGLOSCI)
+        {
+            for (int v : lista)
+                relaksuj(0, v, lekkie);
+            return;
+        }
+        pula.dlaPrzedzialow(lista.size(), [&](int t, int64_t od, int64_t doIndeksu)
+                            {
+            for (int64_t k = od; k < doIndeksu; k++)
+                relaksuj(t, lista[k], lekkie); });
+    };
+
+    auto rozloz = [&]()
+    {
+        for (auto &lista : zmienione)
+        {
+            for (int u : lista)
+            {
+                int64_t b = odl[u].load(std::memory_order_relaxed) / delta;
+                if (kubelekWierzcholka[u] != b)
+                {
+                    kubelekWierzcholka[u] = b;
+                    kubelki[b % liczbaKubelkow].push_back(u);
+                }
+            }
+            lista.clear();
+        }
+    };
+
+    auto teraz = [] { return std::chrono::steady_clock::now(); };
+    auto ms = [](std::chrono::steady_clock::duration d) { return std::chrono::duration<double, std::milli>(d).count(); };
+
+    odl[zrodlo].store(0, std::memory_order_relaxed);
+    kubelekWierzcholka[zrodlo] = 0;
+    kubelki[0].push_back(zrodlo);
+    int64_t i = 0;
+    while (true)
+    {
+        auto t0 = teraz();
+        int64_t pominiete = 0;
+        while (kubelki[i % liczbaKubelkow].empty() && pominiete < liczbaKubelkow)
+        {
+            i++;
+            pominiete++;
+        }
+        if (pominiete == liczbaKubelkow)
+            break;
+        st.kubelki++;
+        R.clear();
+        st.czasKubelki += ms(teraz() - t0);
+
+        while (!kubelki[i % liczbaKubelkow].empty())
+        {
+            auto t1 = teraz();
+            aktywne.clear();
+            for (int v : kubelki[i % liczbaKubelkow])
+            {
+                if (kubelekWierzcholka[v] != i)
+                {
+                    LICZ(nieaktualne, 1); // wpis nieaktualny - v przeniesiono do innego kubełka
+                    continue;
+                }
+                kubelekWierzcholka[v] = -1;
+                aktywne.push_back(v);
+                if (rozliczony[v] != i)
+                {
+                    rozliczony[v] = i;
+                    R.push_back(v);
+                }
+            }
+            kubelki[i % liczbaKubelkow].clear();
+            auto t2 = teraz();
+            faza(aktywne, true);
+            auto t3 = teraz();
+            rozloz();
+            st.fazyLekkie++;
+            st.czasKubelki += ms(t2 - t1) + ms(teraz() - t3);
+            st.czasLekkie += ms(t3 - t2);
+        }
+
+        auto t4 = teraz();
+        faza(R, false);
+        auto t5 = teraz();
+        rozloz();
+        st.czasCiezkie += ms(t5 - t4);
+        st.czasKubelki += ms(teraz() - t5);
+        i++;
+    }
+
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    wynik.odleglosci.resize(V);
+    for (int v = 0; v < V; v++)
+        wynik.odleglosci[v] = odl[v].load(std::memory_order_relaxed);
+    for (int64_t r : relaksacje)
+        st.relaksacje += r;
+    LICZ(relaksacje, st.relaksacje);
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+inline std::string opiszStatystyki(const StatystykiDeltaStepping &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(3) << "delta=" << st.delta << " watki=" << st.watki << " kubelki=" << st.kubelki
+         << " fazy_lekkie=" << st.fazyLekkie << " relaksacje=" << st.relaksacje << " lekkie_ms=" << st.czasLekkie
+         << " ciezkie_ms=" << st.czasCiezkie << " kubelki_ms=" << st.czasKubelki;
+    return opis.str();
+}
+
+template <typename Macierz>
+WynikOdleglosci obliczBellmanFordMacierz(const Macierz &macierz, int zrodlo)
+{
+    int V = macierz.pobierzV();
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<int> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, INT_MAX);
+    std::vector<int> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    odleglosci[zrodlo] = 0;
+
+    for (int i = 1; i <= V - 1; i++)
+    {
+        LICZ(komorki, (int64_t)V * V);
+        for (int u = 0; u < V; u++)
+        {
+            for (int v = 0; v < V; v++)
+            {
+                SumaWag<Macierz> nowa = (SumaWag<Macierz>)odleglosci[u] + macierz(u, v);
+                if (macierz(u, v) && odleglosci[u] != INT_MAX && nowa < odleglosci[v])
+                {
+                    LICZ(relaksacje, 1);
+                    odleglosci[v] = (int)nowa;
+                    poprzednik[v] = u;
+                }
+            }
+        }
+    }
+
+    for (int u = 0; u < V; u++)
+    {
+        for (int v = 0; v < V; v++)
+        {
+            if (macierz(u, v) && odleglosci[u] != INT_MAX && (SumaWag<Macierz>)odleglosci[u] + macierz(u, v) < odleglosci[v])
+            {
+                wynik.ujemnyCykl = true;
+                return wynik;
+            }
+        }
+    }
+    return wynik;
+}
+
+inline WynikOdleglosci obliczBellmanFordMacierz(const GrafMacierz &graf, int zrodlo)
+{
+    return zWidokiemMacierzy<WynikOdleglosci>(graf, [&](const auto &macierz)
+                                              { return obliczBellmanFordMacierz(macierz, zrodlo); });
+}
+
+// Przyjmuje WidokCSROgolny albo GrafCSROgolny dowolnych typów wagi i wierzchołka.
+template <typename Graf>
+WynikOdleglosciDla<Graf> obliczBellmanFordLista(const Graf &graf, typename Graf::Wierzcholek zrodlo)
+{
+    using Id = typename Graf::Wierzcholek;
+    using Odleglosc = OdlegloscWag<Graf>;
+    constexpr Odleglosc NIESKONCZONOSC = CechyWagi<typename Graf::Waga>::NIESKONCZONOSC;
+    typename Graf::Widok g = graf;
+    Id V = g.pobierzV();
+    WynikOdleglosciDla<Graf> wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<Odleglosc> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, NIESKONCZONOSC);
+    std::vector<Id> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    odleglosci[zrodlo] = 0;
+
+    for (Id i = 1; i <= V - 1; i++)
+    {
+        LICZ(krawedzie, g.offsety[V]);
+        for (Id u = 0; u < V; u++)
+        {
+            // przy wagach int64 suma z NIESKONCZONOSC by się przepełniła, więc nieosiągalne są pomijane od razu
+            if (odleglosci[u] == NIESKONCZONOSC)
+                continue;
+            for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+            {
+                Id v = g.sasiedzi[j];
+                SumaWag<Graf> nowa = (SumaWag<Graf>)odleglosci[u] + g.wagi[j];
+                if (nowa < odleglosci[v])
+                {
+                    LICZ(relaksacje, 1);
+                    odleglosci[v] = (Odleglosc)nowa;
+                    poprzednik[v] = u;
+                }
+            }
+        }
+    }
+
+    for (Id u = 0; u < V; u++)
+    {
+        if (odleglosci[u] == NIESKONCZONOSC)
+            continue;
+        for (int64_t j = g.offsety[u]; j < g.offsety[u + 1]; j++)
+        {
+            Id v = g.sasiedzi[j];
+            if ((SumaWag<Graf>)odleglosci[u] + g.wagi[j] < odleglosci[v])
+            {
+                wynik.ujemnyCykl = true;
+                return wynik;
+            }
+        }
+    }
+    return wynik;
+}
+
+enum class TrybBellmanaForda
+{
+    Rundy,     // pełne rundy po tablicy krawędzi, koniec po rundzie bez zmian
+    Kolejka,   // SPFA: relaksowane są tylko krawędzie wierzchołków, których odległość zmalała
+    Rownolegly // rundy z krawędziami podzielonymi między wątki
+};
+
+inline const char *nazwaTrybuBellmanaForda(TrybBellmanaForda tryb)
+{
+    switch (tryb)
+    {
+    case TrybBellmanaForda::Kolejka:
+        return "kolejka";
+    case TrybBellmanaForda::Rownolegly:
+        return "rownolegly";
+    default:
+        return "rundy";
+    }
+}
+
+struct StatystykiBellmanaForda
+{
+    int64_t rundy = 0;      // rundy (albo zdjęcia z kolejki w trybie SPFA)
+    int64_t relaksacje = 0; // udane zmniejszenia odległości
+};
+
+// Tablice sasiedzi/wagi grafu CSR są płaską listą łuków uporządkowaną według wierzchołka
+// początkowego, więc rundy Bellmana-Forda przechodzą je liniowo, bez budowania kopii.
+// Zmiana w V-tej rundzie oznacza cykl o ujemnej wadze osiągalny ze źródła - tak samo jak
+// dodatkowe przejście po V - 1 rundach w BellmanFordLista.
+inline WynikOdleglosci obliczBellmanFordRundy(WidokCSR graf, int zrodlo, StatystykiBellmanaForda *statystyki = nullptr)
+{
+    int V = graf.pobierzV();
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<int> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, INT_MAX);
+    std::vector<int> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    odleglosci[zrodlo] = 0;
+    StatystykiBellmanaForda st;
+
+    for (int runda = 1; runda <= V; runda++)
+    {
+        st.rundy++;
+        bool zmiana = false;
+        for (int u = 0; u < V; u++)
+        {
+            int du = odleglosci[u];
+            if (du == INT_MAX)
+                continue;
+            LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+            for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+            {
+                int v = graf.sasiedzi[j];
+                SumaWag<WidokCSR> nowa = (SumaWag<WidokCSR>)du + graf.wagi[j];
+                if (nowa < odleglosci[v])
+                {
+                    odleglosci[v] = (int)nowa;
+                    poprzednik[v] = u;
+                    zmiana = true;
+                    st.relaksacje++;
+                    LICZ(relaksacje, 1);
+                }
+            }
+        }
+        if (!zmiana)
+            break;
+        if (runda == V)
+            wynik.ujemnyCykl = true;
+    }
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+// SPFA z wykrywaniem cyklu przez długość ścieżki: jeśli najkrótsza znaleziona ścieżka do v
+// ma V krawędzi, to powtarza wierzchołek, a więc zawiera cykl o ujemnej wadze.
+inline WynikOdleglosci obliczBellmanFordKolejka(WidokCSR graf, int zrodlo, StatystykiBellmanaForda *statystyki = nullptr)
+{
+    int V = graf.pobierzV();
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+    std::vector<int> &odleglosci = wynik.odleglosci;
+    odleglosci.assign(V, INT_MAX);
+    std::vector<int> &poprzednik = wynik.poprzednik;
+    poprzednik.assign(V, -1);
+    std::vector<int> dlugosc(V, 0);
+    std::vector<bool> wKolejce(V, false);
+    std::vector<int> kolejka(V); // bufor cykliczny - każdy wierzchołek jest w kolejce co najwyżej raz
+    size_t glowa = 0, rozmiar = 0;
+    StatystykiBellmanaForda st;
+
+    odleglosci[zrodlo] = 0;
+    kolejka[0] = zrodlo;
+    rozmiar = 1;
+    wKolejce[zrodlo] = true;
+    while (rozmiar > 0)
+    {
+        int u = kolejka[glowa];
+        glowa = (glowa + 1) % V;
+        rozmiar--;
+        wKolejce[u] = false;
+        st.rundy++;
+        LICZ(krawedzie, graf.offsety[u + 1] - graf.offsety[u]);
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            int v = graf.sasiedzi[j];
+            SumaWag<WidokCSR> nowa = (SumaWag<WidokCSR>)odleglosci[u] + graf.wagi[j];
+            if (nowa < odleglosci[v])
+            {
+                odleglosci[v] = (int)nowa;
+                poprzednik[v] = u;
+                dlugosc[v] = dlugosc[u] + 1;
+                st.relaksacje++;
+                LICZ(relaksacje, 1);
+                if (dlugosc[v] >= V)
+                {
+                    wynik.ujemnyCykl = true;
+                    if (statystyki)
+                        *statystyki = st;
+                    return wynik;
+                }
+                if (!wKolejce[v])
+                {
+                    wKolejce[v] = true;
+                    kolejka[(glowa + rozmiar) % V] = v;
+                    rozmiar++;
+                }
+            }
+        }
+    }
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+// Rundy jak w obliczBellmanFordRundy, ale każdy wątek dostaje ciągły fragment tablicy łuków
+// o równej liczbie krawędzi i zmniejsza odległości atomowo. Relaksacje w dowolnej kolejności
+// nie psują zbieżności: runda zawsze robi co najmniej tyle, co runda Jacobiego, więc bez
+// ujemnego cyklu wystarcza V - 1 rund, a zmiana w V-tej oznacza cykl.
+inline WynikOdleglosci obliczBellmanFordRownolegly(WidokCSR graf, int zrodlo, PulaWatkow &pula,
+                                            StatystykiBellmanaForda *statystyki = nullptr)
+{
+    int V = graf.pobierzV();
+    int64_t luki = graf.offsety[V];
+    std::vector<std::atomic<int>> odl(V);
+    for (auto &d : odl)
+        d.store(INT_MAX, std::memory_order_relaxed);
+    odl[zrodlo].store(0, std::memory_order_relaxed);
+    std::vector<int64_t> relaksacje(pula.rozmiar(), 0);
+    std::vector<char> zmianaWatku(pula.rozmiar(), 0);
+    StatystykiBellmanaForda st;
+    WynikOdleglosci wynik;
+    wynik.zrodlo = zrodlo;
+
+    for (int runda = 1; runda <= V; runda++)
+    {
+        st.rundy++;
+        pula.dlaPrzedzialow(luki, [&](int t, int64_t od, int64_t doLuku)
+                            {
+            bool zmiana = false;
+            LICZ(krawedzie, doLuku - od);
+            int u = int(std::upper_bound(graf.offsety, graf.offsety + V + 1, od) - graf.offsety) - 1;
+            for (int64_t j = od; j < doLuku; u++)
+            {
+                int64_t koniec = std::min(graf.offsety[u + 1], doLuku);
+                int du = odl[u].load(std::memory_order_relaxed);
+                if (du == INT_MAX)
+                {
+                    j = koniec;
+                    continue;
+                }
+                for (; j < koniec; j++)
+                {
+                    int v = graf.sasiedzi[j];
+                    int nowa = (int)std::min<SumaWag<WidokCSR>>((SumaWag<WidokCSR>)du + graf.wagi[j], INT_MAX);
+                    int stara = odl[v].load(std::memory_order_relaxed);
+                    while (nowa < stara && !odl[v].compare_exchange_weak(stara, nowa, std::memory_order_relaxed))
+                    {
+                    }
+                    if (nowa < stara)
+                    {
+                        zmiana = true;
+                        relaksacje[t]++;
+                    }
+                }
+            }
+            zmianaWatku[t] = zmiana; });
+
+        bool zmiana = false;
+        for (char z : zmianaWatku)
+            zmiana = zmiana || z;
+        if (!zmiana)
+            break;
+        if (runda == V)
+            wynik.ujemnyCykl = true;
+    }
+
+    wynik.odleglosci.resize(V);
+    for (int v = 0; v < V; v++)
+        wynik.odleglosci[v] = odl[v].load(std::memory_order_relaxed);
+    for (int64_t r : relaksacje)
+        st.relaksacje += r;
+    LICZ(relaksacje, st.relaksacje);
+    if (statystyki)
+        *statystyki = st;
+    return wynik;
+}
+
+inline WynikOdleglosci obliczBellmanFordLista(WidokCSR graf, int zrodlo, TrybBellmanaForda tryb, PulaWatkow &pula,
+                                       StatystykiBellmanaForda *statystyki = nullptr)
+{
+    switch (tryb)
+    {
+    case TrybBellmanaForda::Kolejka:
+        return obliczBellmanFordKolejka(graf, zrodlo, statystyki);
+    case TrybBellmanaForda::Rownolegly:
+        return obliczBellmanFordRownolegly(graf, zrodlo, pula, statystyki);
+    default:
+        return obliczBellmanFordRundy(graf, zrodlo, statystyki);
+    }
+}
+
+// Potencjały Johnsona: Bellman-Ford z wirtualnego źródła połączonego łukiem o wadze 0 z każdym
+// wierzchołkiem. Zamiast dokładać wierzchołek, rundy startują od h = 0 wszędzie, czyli od stanu
+// po pierwszej rundzie z wirtualnego źródła, więc zmiana w V-tej rundzie oznacza cykl o ujemnej
+// wadze. Potencjały są 64-bitowe, bo suma V - 1 ujemnych wag nie musi mieścić się w int.
+// Zwraca false, gdy graf ma ujemny cykl.
+inline bool obliczPotencjalyJohnsona(WidokCSR graf, std::vector<int64_t> &h, int64_t *rundy = nullptr)
+{
+    int V = graf.pobierzV();
+    h.assign(V, 0);
+    bool cykl = false;
+    int runda = 1;
+    for (; runda <= V; runda++)
+    {
+        bool zmiana = false;
+        LICZ(krawedzie, graf.offsety[V]);
+        for (int u = 0; u < V; u++)
+        {
+            for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+            {
+                int v = graf.sasiedzi[j];
+                if (h[u] + graf.wagi[j] < h[v])
+                {
+                    LICZ(relaksacje, 1);
+                    h[v] = h[u] + graf.wagi[j];
+                    zmiana = true;
+                }
+            }
+        }
+        if (!zmiana)
+            break;
+        if (runda == V)
+            cykl = true;
+    }
+    if (rundy)
+        *rundy = std::min(runda, V);
+    return !cykl;
+}
+
+struct StatystykiJohnsona
+{
+    int64_t rundy = 0;          // rundy Bellmana-Forda liczącego potencjały
+    double czasPotencjalow = 0; // milisekundy Bellmana-Forda i przeważenia wag
+    StatystykiPartii dijkstra;  // Dijkstra ze wszystkich źródeł na przeważonym grafie
+};
+
+inline std::string opiszStatystyki(const StatystykiJohnsona &st)
+{
+    std::ostringstream opis;
+    opis << std::fixed << std::setprecision(1) << "rundy_bf=" << st.rundy << " potencjaly_ms=" << st.czasPotencjalow << ' '
+         << opiszStatystyki(st.dijkstra);
+    return opis.str();
+}
+
+// Johnson (D. B. Johnson, "Efficient Algorithms for Shortest Paths in Sparse Networks", 1977)
+// na łukach grafu CSR: potencjały h, wagi w(u, v) + h(u) - h(v) >= 0 w nowej tablicy (offsety
+// i sąsiedzi są wspólne z oryginałem) i Dijkstra ze źródeł z listy w PartiaZapytan. Przeważenie
+// zmienia długość każdej ścieżki s-v o h(s) - h(v), więc poprzednicy się nie zmieniają, a
+// odległość to d'(s, v) - h(s) + h(v); odległość spoza int jest zgłaszana jako INT_MAX, jak
+// w pozostałych algorytmach. Wyniki trafiają do odbierz(i, wynik) w kolejności kończenia,
+// szeregowane blokadą. Przy ujemnym cyklu odbierz nie jest wołane, a funkcja zwraca false.
+// W grafie nieskierowanym każda ujemna krawędź tworzy cykl u-v-u, więc wagi ujemne mają sens
+// tylko dla grafu skierowanego (GrafCSR::zbudujZKrawedzi ze skierowany albo plik binarny).
+template <typename F>
+bool obliczJohnsonStrumieniowo(WidokCSR graf, const std::vector<int> &zrodla, PulaWatkow &pula, RodzajKolejki rodzaj,
+                               F &&odbierz, StatystykiJohnsona *statystyki = nullptr)
+{
+    int V = graf.pobierzV();
+    StatystykiJohnsona st;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int64_t> h;
+    if (!obliczPotencjalyJohnsona(graf, h, &st.rundy))
+    {
+        if (statystyki)
+            *statystyki = st;
+        return false;
+    }
+
+    std::vector<int> wagi(graf.offsety[V]);
+    int minWaga = 0, maksWaga = 0;
+    for (int u = 0; u < V; u++)
+    {
+        for (int64_t j = graf.offsety[u]; j < graf.offsety[u + 1]; j++)
+        {
+            int64_t w = graf.wagi[j] + h[u] - h[graf.sasiedzi[j]];
+            if (w > INT_MAX)
+            {
+                std::cerr << "Waga łuku " << u << " -> " << graf.sasiedzi[j] << " po przeważeniu (" << w
+                     << ") nie mieści się w int" << std::endl;
+                std::exit(1);
+            }
+            wagi[j] = (int)w;
+            maksWaga = std::max(maksWaga, wagi[j]);
+        }
+    }
+    WidokCSR przewazony{V, graf.offsety, graf.sasiedzi, wagi.data(), minWaga, maksWaga};
+    // przeważone wagi sięgają około V * |najmniejsza waga|, a każdy wątek partii miałby własną
+    // tablicę tylu kubełków - przy zbyt szerokim zakresie kubełki zastępuje kopiec
+    if (rodzaj == RodzajKolejki::Kubelkowa && !KolejkaKubelkowa<>::obsluguje(maksWaga, V))
+        rodzaj = RodzajKolejki::DArna;
+    st.czasPotencjalow = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    PartiaZapytan partia(pula);
+    WynikOdleglosci wynik; // wywołania odbiorcy partii są szeregowane, więc jeden bufor wystarcza
+    st.dijkstra = partia.wykonaj(przewazony, zrodla, rodzaj, [&](int64_t i, const WynikOdleglosci &w, int64_t)
+                                 {
+        wynik = w;
+        int64_t hs = h[w.zrodlo];
+        for (int v = 0; v < V; v++)
+            if (wynik.odleglosci[v] != INT_MAX)
+                wynik.odleglosci[v] = (int)std::min<int64_t>(wynik.odleglosci[v] - hs + h[v], INT_MAX);
+        odbierz(i, wynik); });
+    if (statystyki)
+        *statystyki = st;
+    return true;
+}
+
+// Odległości między wszystkimi parami algorytmem Johnsona w MacierzOdleglosci (4 * V^2 bajtów);
+// przy ujemnym cyklu wynik ma tylko ujemnyCykl. Odległości od NIESKONCZONOSC wzwyż są, jak we
+// Floydzie-Warshallu, nieosiągalne. Dla grafów, których macierz nie mieści się w pamięci,
+// obliczJohnsonStrumieniowo oddaje wiersze pojedynczo.
+inline MacierzOdleglosci obliczJohnsonLista(WidokCSR graf, PulaWatkow &pula, RodzajKolejki rodzaj = RodzajKolejki::Binarna,
+                                            StatystykiJohnsona *statystyki = nullptr)
+{
+    int V = graf.pobierzV();
+    std::vector<int> zrodla(V);
+    std::iota(zrodla.begin(), zrodla.end(), 0);
+    MacierzOdleglosci wynik(V, (size_t)(V + 15) / 16 * 16);
+    int *d = wynik.dane();
+    bool bezCyklu = obliczJohnsonStrumieniowo(graf, zrodla, pula, rodzaj, [&](int64_t, const WynikOdleglosci &w)
+                                              {
+        int *wiersz = d + (size_t)w.zrodlo * wynik.pobierzKrok();
+        for (int v = 0; v < V; v++)
+            wiersz[v] = std::min(w.odleglosci[v], MacierzOdleglosci::NIESKONCZONOSC); },
+                                              statystyki);
+    wynik.ujemnyCykl = !bezCyklu;
+    return wynik;
+}
+
+// Zadania trybu automatycznego: drzewo rozpinające albo odległości od jednego źródła.
+enum class ZadanieAuto
+{
+    MST,
+    Odleglosci
+};
+
+// Cechy grafu, z których model kosztów przewiduje czasy: liczba wierzchołków, krawędzi
+// nieskierowanych i zakres wag.
+struct CechyGrafu
+{
+    int V = 0;
+    int64_t E = 0;
+    int minWaga = 0, maksWaga = 0;
+};
+
+inline CechyGrafu cechyGrafu(int V, const std::vector<Krawedz> &krawedzie)
+{
+    CechyGrafu c;
+    c.V = V;
+    c.E = krawedzie.size();
+    for (size_t i = 0; i < krawedzie.size(); i++)
+    {
+        c.minWaga = i ? std::min(c.minWaga, krawedzie[i].waga) : krawedzie[i].waga;
+        c.maksWaga = i ? std::max(c.maksWaga, krawedzie[i].waga) : krawedzie[i].waga;
+    }
+    return c;
+}
+
+inline CechyGrafu cechyGrafu(WidokCSR graf)
+{
+    int V = graf.pobierzV();
+    return {V, graf.offsety[V] / 2, graf.minWaga, graf.maksWaga};
+}
+
+// Najwęższa szerokość macierzy, w której mieszczą się wagi grafu.
+inline SzerokoscWagi szerokoscDlaWag(const CechyGrafu &c)
+{
+    if (c.minWaga >= 0 && c.maksWaga <= CechyWagi<uint8_t>::MAKS)
+        return SzerokoscWagi::UInt8;
+    if (c.minWaga >= 0 && c.maksWaga <= CechyWagi<uint16_t>::MAKS)
+        return SzerokoscWagi::UInt16;
+    return SzerokoscWagi::Int32;
+}
+
+inline const char *nazwaSzerokosci(SzerokoscWagi szerokosc)
+{
+    return szerokosc == SzerokoscWagi::UInt8 ? "8" : szerokosc == SzerokoscWagi::UInt16 ? "16" : "32";
+}
+
+// Algorytmy, spośród których wybiera tryb automatyczny. Dijkstra odpada przy wagach ujemnych,
+// a Bellman-Ford jest wtedy jedynym poprawnym; na macierzy Prim i Dijkstra to jądra wektorowe,
+// a na liście kolejka binarna, jak w menu.
+inline std::vector<std::string> kandydaciAuto(ZadanieAuto zadanie, const CechyGrafu &c)
+{
+    if (zadanie == ZadanieAuto::MST)
+        return {"prim", "kruskal"};
+    if (c.minWaga < 0)
+        return {"bellman-ford"};
+    return {"dijkstra"};
+}
+
+// Wykonuje algorytm na gotowej reprezentacji; wynik trafia do mst albo odleglosci.
+inline void wykonajAlgorytmAuto(const std::string &algorytm, bool macierz, const GrafMacierz &gm, WidokCSR gc, int zrodlo,
+                                ObszarRoboczy &obszar, WynikMST &mst, WynikOdleglosci &odleglosci)
+{
+    if (algorytm == "prim")
+        mst = macierz ? obliczPrimMSTMacierzWektorowo(gm, obszar) : obliczPrimMSTLista(gc, obszar, RodzajKolejki::Binarna);
+    else if (algorytm == "kruskal")
+        mst = macierz ? obliczKruskalMSTMacierz(gm, obszar) : obliczKruskalMSTLista(gc, obszar);
+    else if (algorytm == "dijkstra")
+        odleglosci = macierz ? obliczDijkstraMacierzWektorowo(gm, zrodlo, obszar)
+                             : obliczDijkstraLista(gc, zrodlo, obszar, RodzajKolejki::Binarna);
+    else
+        odleglosci = macierz ? obliczBellmanFordMacierz(gm, zrodlo) : obliczBellmanFordLista(gc, zrodlo);
+}
+
+// Model kosztów: czas algorytmu (albo budowy reprezentacji) to a * f1 + b * f2 nanosekund,
+// gdzie f1 i f2 to złożoności zależne od V i E, a a i b są dopasowywane do pomiarów na tej
+// maszynie. Klucze to "algorytm-macierz/szerokość", "algorytm-lista", "budowa-macierz/szerokość"
+// i "budowa-lista"; szerokości macierzy mają osobne współczynniki, bo wąskie wagi zmieniają
+// koszt przejścia po wierszu.
+class ModelKosztow
+{
+    std::unordered_map<std::string, std::pair<double, double>> wspolczynniki;
+
+    static constexpr const char *NAGLOWEK = "grafy-kalibracja 1";
+
+    static std::string podstawa(const std::string &klucz)
+    {
+        return klucz.substr(0, klucz.find('/'));
+    }
+
+    // Najmniejsze kwadraty błędu względnego dla a * f1 + b * f2 bez wyrazu wolnego; gdy jeden
+    // ze współczynników wyszedłby ujemny, zostaje lepsze z dopasowań jednej cechy.
+    static std::pair<double, double> dopasuj(const std::vector<std::pair<double, double>> &f, const std::vector<double> &t)
+    {
+        double s11 = 0, s12 = 0, s22 = 0, s1 = 0, s2 = 0;
+        for (size_t i = 0; i < t.size(); i++)
+        {
+            double x1 = f[i].first / t[i], x2 = f[i].second / t[i];
+            s11 += x1 * x1, s12 += x1 * x2, s22 += x2 * x2, s1 += x1, s2 += x2;
+        }
+        double wyznacznik = s11 * s22 - s12 * s12;
+        if (wyznacznik > 1e-12 * s11 * s22)
+        {
+            double a = (s1 * s22 - s2 * s12) / wyznacznik, b = (s2 * s11 - s1 * s12) / wyznacznik;
+            if (a >= 0 && b >= 0)
+                return {a, b};
+        }
+        auto blad = [&](double a, double b)
+        {
+            double suma = 0;
+            for (size_t i = 0; i < t.size(); i++)
+                suma += std::pow((a * f[i].first + b * f[i].second) / t[i] - 1, 2);
+            return suma;
+        };
+        std::pair<double, double> tylkoPierwsza{s11 > 0 ? s1 / s11 : 0, 0}, tylkoDruga{0, s22 > 0 ? s2 / s22 : 0};
+        return blad(tylkoPierwsza.first, 0) <= blad(0, tylkoDruga.second) ? tylkoPierwsza : tylkoDruga;
+    }
+
+    // Najkrótszy z kilku przebiegów f, w nanosekundach.
+    template <typename F>
+    static double zmierz(int przebiegi, F &&f)
+    {
+        double najkrotszy = 1e300;
+        for (int i = 0; i < przebiegi; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            f();
+            najkrotszy = std::min(najkrotszy, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+        return std::max(najkrotszy, 1.0);
+    }
+
+public:
+    static std::pair<double, double> cechy(const std::string &klucz, const CechyGrafu &c)
+    {
+        double V = c.V, E = (double)c.E, logV = std::log2(V + 2), logE = std::log2(E + 2);
+        std::string p = podstawa(klucz);
+        if (p == "prim-macierz" || p == "dijkstra-macierz")
+            return {V * V, V};
+        if (p == "kruskal-macierz")
+            return {V * V, E * logE};
+        if (p == "prim-lista" || p == "dijkstra-lista")
+            return {E * logV, V * logV};
+        if (p == "kruskal-lista")
+            return {E * logE, V};
+        if (p == "bellman-ford-macierz")
+            return {V * V * V, V * V};
+        if (p == "bellman-ford-lista")
+            return {V * E, V};
+        if (p == "budowa-macierz")
+            return {V * V, E};
+        return {E, V}; // budowa-lista
+    }
+
+    static std::string klucz(const std::string &algorytm, bool macierz, SzerokoscWagi szerokosc)
+    {
+        return algorytm + (macierz ? std::string("-macierz/") + nazwaSzerokosci(szerokosc) : std::string("-lista"));
+    }
+
+    // Przewidywany czas w nanosekundach; -1, gdy model nie zna klucza.
+    double przewidz(const std::string &klucz, const CechyGrafu &c) const
+    {
+        auto it = wspolczynniki.find(klucz);
+        if (it == wspolczynniki.end())
+            return -1;
+        std::pair<double, double> f = cechy(klucz, c);
+        return it->second.first * f.first + it->second.second * f.second;
+    }
+
+    bool pusty() const
+    {
+        return wspolczynniki.empty();
+    }
+
+    // Krótki mikrobenchmark (kilka sekund): losowe grafy kilku rozmiarów i gęstości, na każdym
+    // najkrótszy z trzech przebiegów budowy reprezentacji i każdego algorytmu trybu automatycznego,
+    // potem dopasowanie współczynników. Duże rzadkie grafy, na których liczy się chybianie pamięci
+    // podręcznej, są mierzone tylko listowo (macierz nie zmieściłaby się w pamięci), a Bellman-Ford
+    // (O(V^3) na macierzy) - na mniejszych grafach.
+    void kalibruj(std::ostream *postep = nullptr)
+    {
+        struct Punkt
+        {
+            int V;
+            double gestosc;
+            bool macierz;
+            std::vector<const char *> algorytmy;
+        };
+        std::vector<Punkt> punkty;
+        for (int V : {128, 512, 1024})
+            for (double gestosc : {5.0, 40.0, 95.0})
+                punkty.push_back({V, gestosc, true, {"prim", "kruskal", "dijkstra"}});
+        for (int V : {8192, 32768})
+            for (double gestosc : {0.05, 0.5})
+                punkty.push_back({V, gestosc, false, {"prim", "kruskal", "dijkstra"}});
+        for (int V : {64, 160, 320})
+            for (double gestosc : {5.0, 40.0, 95.0})
+                punkty.push_back({V, gestosc, true, {"bellman-ford"}});
+
+        std::unordered_map<std::string, std::vector<std::pair<double, double>>> f;
+        std::unordered_map<std::string, std::vector<double>> t;
+        auto dodaj = [&](const std::string &klucz, const CechyGrafu &c, double ns)
+        {
+            f[klucz].push_back(cechy(klucz, c));
+            t[klucz].push_back(ns);
+        };
+        const int PRZEBIEGI = 3;
+        ObszarRoboczy obszar;
+        WynikMST mst;
+        WynikOdleglosci odleglosci;
+        for (const Punkt &punkt : punkty)
+        {
+            int V = punkt.V;
+            if (postep)
+                *postep << "Kalibracja: V=" << V << " gestosc=" << punkt.gestosc << "\n";
+            std::vector<Krawedz> krawedzie = GeneratorGrafow(V * 131 + (int)(punkt.gestosc * 100), 1, 1, CechyWagi<uint8_t>::MAKS)
+                                            .generujKrawedzie(V, GeneratorGrafow::liczbaKrawedzi(V, punkt.gestosc));
+            CechyGrafu c = cechyGrafu(V, krawedzie);
+            GrafCSR gc(0);
+            dodaj("budowa-lista", c, zmierz(PRZEBIEGI, [&]
+                                            { gc.zbudujZKrawedzi(V, krawedzie); }));
+            for (const char *algorytm : punkt.algorytmy)
+                dodaj(klucz(algorytm, false, SzerokoscWagi::Int32), c, zmierz(PRZEBIEGI, [&]
+                                                                           {
+                    obszar.resetuj();
+                    wykonajAlgorytmAuto(algorytm, false, GrafMacierz(0), gc, 0, obszar, mst, odleglosci); }));
+            if (!punkt.macierz)
+                continue;
+            for (SzerokoscWagi szerokosc : {SzerokoscWagi::Int32, SzerokoscWagi::UInt16, SzerokoscWagi::UInt8})
+            {
+                // Bellman-Ford jest wybierany tylko przy wagach ujemnych, czyli w macierzy 32-bitowej
+                if (punkt.algorytmy[0] == std::string("bellman-ford") && szerokosc != SzerokoscWagi::Int32)
+                    continue;
+                GrafMacierz gm(0, UkladMacierzy::Pelna, szerokosc);
+                dodaj(klucz("budowa", true, szerokosc), c, zmierz(PRZEBIEGI, [&]
+                                                                  {
+                    gm = GrafMacierz(V, UkladMacierzy::Pelna, szerokosc);
+                    for (const auto &k : krawedzie)
+                        gm.dodajKrawedz(k.u, k.v, k.waga); }));
+                for (const char *algorytm : punkt.algorytmy)
+                    dodaj(klucz(algorytm, true, szerokosc), c, zmierz(PRZEBIEGI, [&]
+                                                                      {
+                        obszar.resetuj();
+                        wykonajAlgorytmAuto(algorytm, true, gm, gc, 0, obszar, mst, odleglosci); }));
+            }
+        }
+        wspolczynniki.clear();
+        for (const auto &pomiary : t)
+            wspolczynniki[pomiary.first] = dopasuj(f[pomiary.first], pomiary.second);
+    }
+
+    // Plik: nagłówek z wersją i zestawem instrukcji, potem wiersze "klucz a b". Kalibracja
+    // z innym zestawem instrukcji (inna maszyna albo inna kompilacja) jest odrzucana.
+    bool wczytaj(const std::string &nazwaPliku)
+    {
+        std::ifstream plik(nazwaPliku);
+        std::string naglowek;
+        if (!plik || !std::getline(plik, naglowek) ||
+            naglowek != std::string(NAGLOWEK) + " " + nazwaZestawu(najlepszyZestawInstrukcji()))
+            return false;
+        std::unordered_map<std::string, std::pair<double, double>> wczytane;
+        std::string klucz;
+        double a, b;
+        while (plik >> klucz >> a >> b)
+            wczytane[klucz] = {a, b};
+        if (wczytane.empty())
+            return false;
+        wspolczynniki = std::move(wczytane);
+        return true;
+    }
+
+    bool zapisz(const std::string &nazwaPliku) const
+    {
+        std::ofstream plik(nazwaPliku);
+        if (!plik)
+            return false;
+        plik << NAGLOWEK << " " << nazwaZestawu(najlepszyZestawInstrukcji()) << "\n"
+             << std::setprecision(17);
+        for (const auto &w : wspolczynniki)
+            plik << w.first << " " << w.second.first << " " << w.second.second << "\n";
+        return (bool)plik;
+    }
+};
+
+// Reprezentacje, które wywołujący już ma; ich budowa nic nie kosztuje. Gotowa macierz ma
+// swoją szerokość wag, więc jest oceniana w niej, a nie w najwęższej możliwej.
+struct GotoweReprezentacje
+{
+    bool lista = false;
+    bool macierz = false;
+    SzerokoscWagi szerokosc = SzerokoscWagi::Int32;
+};
+
+struct OcenaAuto
+{
+    std::string algorytm;
+    bool macierz = false;
+    SzerokoscWagi szerokosc = SzerokoscWagi::Int32;
+    double budowa = 0, obliczenie = 0; // przewidywane nanosekundy
+};
+
+// Wszystkie kandydaty na obu reprezentacjach, od najtańszego (budowa + obliczenie).
+inline std::vector<OcenaAuto> ocenKandydatow(const ModelKosztow &model, ZadanieAuto zadanie, const CechyGrafu &c,
+                                        const GotoweReprezentacje &gotowe = {})
+{
+    std::vector<OcenaAuto> oceny;
+    for (const std::string &algorytm : kandydaciAuto(zadanie, c))
+    {
+        for (bool macierz : {true, false})
+        {
+            OcenaAuto o;
+            o.algorytm = algorytm;
+            o.macierz = macierz;
+            o.szerokosc = macierz && gotowe.macierz ? gotowe.szerokosc : szerokoscDlaWag(c);
+            bool gotowa = macierz ? gotowe.macierz : gotowe.lista;
+            o.budowa = gotowa ? 0 : model.przewidz(ModelKosztow::klucz("budowa", macierz, o.szerokosc), c);
+            o.obliczenie = model.przewidz(ModelKosztow::klucz(algorytm, macierz, o.szerokosc), c);
+            if (o.budowa >= 0 && o.obliczenie >= 0)
+                oceny.push_back(o);
+        }
+    }
+    std::stable_sort(oceny.begin(), oceny.end(), [](const OcenaAuto &a, const OcenaAuto &b)
+                { return a.budowa + a.obliczenie < b.budowa + b.obliczenie; });
+    return oceny;
+}
+
+} // namespace grafy
+
+#endif // GRAFY_H
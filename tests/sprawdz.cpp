@@ -0,0 +1,382 @@
+// Testy krzyżowe biblioteki: każdy porównuje wynik algorytmu z prostszym, niezależnie liczonym
+// wzorcem na losowych grafach. Bez argumentów uruchamia wszystkie testy, z nazwą - tylko ten
+// jeden (tak woła je ctest). Kod wyjścia 1 oznacza, że któryś test znalazł błąd.
+#include "grafy.h"
+
+using namespace grafy;
+
+// Pierwsze błędy każdego testu trafiają na cerr, reszta jest tylko liczona.
+static int bledy = 0;
+
+static std::ostream &blad()
+{
+    static std::ostringstream zbedne;
+    if (++bledy <= 10)
+        return std::cerr << "  ";
+    zbedne.str("");
+    return zbedne;
+}
+
+// Waga MST liczona Kruskalem od zera; wagi[u * V + v] < 0 oznacza brak krawędzi.
+static int64_t wagaKruskala(int V, const std::vector<int> &wagi, int64_t &krawedzieLasu)
+{
+    std::vector<Krawedz> lista;
+    for (int u = 0; u < V; u++)
+        for (int v = u + 1; v < V; v++)
+            if (wagi[u * V + v] >= 0)
+                lista.push_back({u, v, wagi[u * V + v]});
+    std::sort(lista.begin(), lista.end());
+    ZbiorRozlaczny zbiory(V);
+    int64_t suma = 0;
+    krawedzieLasu = 0;
+    for (const Krawedz &k : lista)
+    {
+        if (zbiory.polacz(k.u, k.v))
+        {
+            suma += k.waga;
+            krawedzieLasu++;
+        }
+    }
+    return suma;
+}
+
+// DynamiczneMST po każdej zmianie (dodanie, usunięcie, zmiana wagi) kontra Kruskal od zera.
+// Gęste grafy zajmują wiele liści drzewa sparsyfikacji, a dodawanie do pustego grafu wymusza
+// jego przebudowy.
+static void sprawdzDynamiczneMST()
+{
+    std::mt19937 gen(13);
+    for (int test = 0; test < 90; test++)
+    {
+        int V = 1 + gen() % 60;
+        int E = test % 3 == 2 ? 0 : gen() % (test % 3 == 0 ? V * 3 + 1 : V * V * 2 + 1);
+        int maksWaga = test % 2 ? 4 : 1000; // małe wagi dają dużo remisów
+        std::vector<int> wagi(V * V, -1);
+        std::vector<Krawedz> lista;
+        for (int i = 0; i < E; i++)
+        {
+            int u = gen() % V, v = gen() % V, w = gen() % maksWaga;
+            if (u == v)
+                continue;
+            lista.push_back({u, v, w});
+            int &stara = wagi[std::min(u, v) * V + std::max(u, v)];
+            if (stara < 0 || stara > w)
+                stara = w;
+        }
+        GrafCSR gc;
+        gc.zbudujZKrawedzi(V, lista);
+        DynamiczneMST mst(gc.widok());
+
+        for (int zmiana = 0; zmiana < 400; zmiana++)
+        {
+            int u = gen() % V, v = gen() % V;
+            if (u == v)
+                continue;
+            int &waga = wagi[std::min(u, v) * V + std::max(u, v)];
+            if (gen() % 3 == 0)
+            {
+                if (mst.usunKrawedz(u, v) != (waga >= 0))
+                    blad() << "test " << test << ": usunKrawedz(" << u << ", " << v << ") zwraca zły wynik\n";
+                waga = -1;
+            }
+            else
+            {
+                waga = gen() % maksWaga;
+                mst.dodajKrawedz(u, v, waga);
+            }
+
+            int64_t oczekiwaneKrawedzie;
+            int64_t oczekiwana = wagaKruskala(V, wagi, oczekiwaneKrawedzie);
+            if (mst.calkowitaWaga() != oczekiwana || mst.liczbaKrawedziLasu() != oczekiwaneKrawedzie ||
+                mst.drzewoRozpinajace().waga != oczekiwana)
+            {
+                blad() << "test " << test << ", zmiana " << zmiana << ": waga " << mst.calkowitaWaga()
+                       << ", oczekiwana " << oczekiwana << "\n";
+                break;
+            }
+        }
+    }
+}
+
+// Zapytania punkt-punkt (do celu, dwukierunkowe, ALT, macierzowe) kontra pełny Dijkstra:
+// odległość musi się zgadzać, a zwrócona ścieżka musi istnieć w grafie i mieć tę długość.
+static void sprawdzPunktPunkt()
+{
+    for (int test = 0; test < 40; test++)
+    {
+        int V = 50 + test * 13;
+        double gestosc = test % 3 == 0 ? 0.2 : (test % 3 == 1 ? 2 : 20);
+        GrafMacierz gm(0);
+        GrafCSR gc;
+        // co drugi graf ma wagi od 0, a macierz zna tylko wagi dodatnie (0 to brak krawędzi)
+        GeneratorGrafow(test, 1, test % 2 ? 0 : 1, 50).generuj(V, gestosc, &gm, nullptr, &gc);
+        WidokCSR graf = gc.widok();
+        PunktyOrientacyjne punkty(graf, 4);
+        PrzeszukiwanieDoCelu przod, tyl;
+        ObszarRoboczy obszar;
+        std::mt19937_64 gen(test);
+
+        auto sprawdz = [&](const char *nazwa, const WynikZapytania &z, int oczekiwana)
+        {
+            if (z.odleglosc != oczekiwana)
+            {
+                blad() << nazwa << ", test " << test << ": " << z.zrodlo << " -> " << z.cel << " = " << z.odleglosc
+                       << ", oczekiwana " << oczekiwana << "\n";
+                return;
+            }
+            if (oczekiwana == INT_MAX)
+            {
+                if (!z.sciezka.empty())
+                    blad() << nazwa << ", test " << test << ": ścieżka do nieosiągalnego celu\n";
+                return;
+            }
+            if (z.sciezka.empty() || z.sciezka.front() != z.zrodlo || z.sciezka.back() != z.cel)
+            {
+                blad() << nazwa << ", test " << test << ": ścieżka nie łączy " << z.zrodlo << " z " << z.cel << "\n";
+                return;
+            }
+            int64_t suma = 0;
+            for (size_t i = 0; i + 1 < z.sciezka.size(); i++)
+            {
+                int najlzejsza = INT_MAX;
+                for (int64_t j = graf.offsety[z.sciezka[i]]; j < graf.offsety[z.sciezka[i] + 1]; j++)
+                    if (graf.sasiedzi[j] == z.sciezka[i + 1])
+                        najlzejsza = std::min(najlzejsza, graf.wagi[j]);
+                if (najlzejsza == INT_MAX)
+                {
+                    blad() << nazwa << ", test " << test << ": ścieżka idzie nieistniejącą krawędzią\n";
+                    return;
+                }
+                suma += najlzejsza;
+            }
+            if (suma != oczekiwana)
+                blad() << nazwa << ", test " << test << ": ścieżka ma długość " << suma << ", a nie " << oczekiwana << "\n";
+        };
+
+        for (int zapytanie = 0; zapytanie < 60; zapytanie++)
+        {
+            int s = gen() % V, t = zapytanie % 10 == 0 ? s : gen() % V;
+            obszar.resetuj();
+            int oczekiwana = obliczDijkstraLista(graf, s, obszar).odleglosci[t];
+            sprawdz("do celu", obliczDijkstraDoCelu(graf, s, t, przod), oczekiwana);
+            sprawdz("dwukierunkowy", obliczDijkstraDwukierunkowy(graf, s, t, przod, tyl), oczekiwana);
+            sprawdz("ALT", obliczALT(graf, s, t, punkty, przod), oczekiwana);
+            obszar.resetuj();
+            WynikZapytania macierzowy = obliczDijkstraMacierzDoCelu(gm, s, t, obszar);
+            if (test % 2 == 0)
+                sprawdz("macierzowy", macierzowy, oczekiwana);
+        }
+    }
+}
+
+// PartiaZapytan na 1-4 wątkach i z każdą kolejką kontra pojedynczy Dijkstra z kolejką binarną:
+// każde źródło ma być odebrane dokładnie raz, z tymi samymi odległościami.
+static void sprawdzPartieZapytan()
+{
+    const RodzajKolejki kolejki[] = {RodzajKolejki::Binarna, RodzajKolejki::DArna, RodzajKolejki::Parujaca,
+                                     RodzajKolejki::Kubelkowa};
+    for (int test = 0; test < 4; test++)
+    {
+        int V = 200 + test * 150;
+        // ostatni graf ma wagi za szerokie dla kolejki kubełkowej, więc sprawdza też jej zastępstwo
+        GrafCSR gc;
+        GeneratorGrafow(100 + test, 1, test % 2 ? 0 : 1, test < 3 ? 100 : 10000000).generuj(V, test % 2 ? 1 : 5, nullptr,
+                                                                                           nullptr, &gc);
+        WidokCSR graf = gc.widok();
+        std::mt19937 gen(test);
+        std::vector<int> zrodla(41);
+        for (int &z : zrodla)
+            z = gen() % V;
+
+        std::vector<std::vector<int>> oczekiwane;
+        ObszarRoboczy obszar;
+        for (int z : zrodla)
+        {
+            obszar.resetuj();
+            oczekiwane.push_back(obliczDijkstraLista(graf, z, obszar, RodzajKolejki::Binarna).odleglosci);
+        }
+
+        for (int watki = 1; watki <= 4; watki++)
+        {
+            PulaWatkow pula(watki);
+            PartiaZapytan partia(pula);
+            for (RodzajKolejki rodzaj : kolejki)
+            {
+                // dwie partie z rzędu sprawdzają też obszary robocze zachowane między partiami
+                for (int powtorzenie = 0; powtorzenie < 2; powtorzenie++)
+                {
+                    std::vector<int> odebrane(zrodla.size(), 0);
+                    StatystykiPartii st = partia.wykonaj(graf, zrodla, rodzaj, [&](int64_t i, const WynikOdleglosci &w, int64_t)
+                                                         {
+                                                             odebrane[i]++;
+                                                             if (w.zrodlo != zrodla[i] || w.odleglosci != oczekiwane[i])
+                                                                 blad() << "test " << test << ", " << watki << " wątki, kolejka "
+                                                                        << nazwaKolejki(rodzaj) << ": złe odległości ze źródła "
+                                                                        << zrodla[i] << "\n"; });
+                    if (count(odebrane.begin(), odebrane.end(), 1) != (int64_t)zrodla.size() ||
+                        st.zapytania != (int64_t)zrodla.size())
+                        blad() << "test " << test << ", " << watki << " wątki, kolejka " << nazwaKolejki(rodzaj)
+                               << ": źródła odebrane nie dokładnie raz\n";
+                }
+            }
+        }
+    }
+}
+
+// HarmonogramProb przy każdej konfiguracji wątków ma wypisać wyniki w kolejności prób, a każda
+// próba ma dostać graf przygotowany dla niej.
+static void sprawdzHarmonogramProb()
+{
+    const int proby = 57;
+    std::ostringstream oczekiwane;
+    for (int i = 0; i < proby; i++)
+        oczekiwane << i << " ";
+
+    for (int rownolegle = 1; rownolegle <= 6; rownolegle++)
+        for (int generatory = 0; generatory <= 3; generatory++)
+            for (int izolowany = 0; izolowany < 2; izolowany++)
+            {
+                KonfiguracjaProb k;
+                k.proby = proby;
+                k.rownolegle = rownolegle;
+                k.generatory = generatory;
+                k.izolowany = izolowany;
+                HarmonogramProb<std::vector<int>> harmonogram(k);
+                std::ostringstream wyjscie;
+                harmonogram.wykonaj([](int i, std::vector<int> &graf)
+                                    { graf.assign(1000 + i % 7, i); },
+                                    [](int i, const std::vector<int> &graf, ObszarRoboczy &, std::ostream &w)
+                                    {
+                                        if (graf.size() != size_t(1000 + i % 7) || graf[0] != i)
+                                            w << "zły graf ";
+                                        w << i << " ";
+                                    },
+                                    wyjscie);
+                if (wyjscie.str() != oczekiwane.str())
+                    blad() << "rownolegle=" << rownolegle << " generatory=" << generatory << " izolowany=" << izolowany
+                           << ": " << wyjscie.str().substr(0, 60) << "...\n";
+            }
+}
+
+// Algorytmy listowe na grafach z wagami uint8 (numery int) i z wagami int64 pomnożonymi przez
+// 2^33 (numery int64) kontra te same algorytmy na GrafCSR: pomnożenie wszystkich wag nie zmienia
+// drzew ani ścieżek, więc krawędzie MST i poprzednicy muszą być identyczni, a wagi i odległości
+// pomnożone przez 2^33. Wag int64 kolejka kubełkowa nie obsługuje, więc te porównywane są
+// z przebiegiem na kopcu 4-arnym, którym jest wtedy zastępowana (remisy rozstrzyga inaczej).
+static void sprawdzTypyOgolne()
+{
+    const int64_t MNOZNIK = int64_t(1) << 33;
+    const RodzajKolejki kolejki[] = {RodzajKolejki::Binarna, RodzajKolejki::DArna, RodzajKolejki::Parujaca,
+                                     RodzajKolejki::Kubelkowa};
+    for (int test = 0; test < 12; test++)
+    {
+        int V = 1 + test * 37;
+        std::vector<Krawedz> lista;
+        GrafCSR gc;
+        GeneratorGrafow(test, 1, test % 2 ? 0 : 1, 255).generuj(V, test % 3 == 0 ? 1 : 10, nullptr, nullptr, &gc, &lista);
+        std::vector<KrawedzOgolna<uint8_t, int>> lista8;
+        std::vector<KrawedzOgolna<int64_t, int64_t>> lista64;
+        for (const Krawedz &k : lista)
+        {
+            lista8.push_back({k.u, k.v, (uint8_t)k.waga});
+            lista64.push_back({k.u, k.v, k.waga * MNOZNIK});
+        }
+        GrafCSROgolny<uint8_t, int> gc8;
+        gc8.zbudujZKrawedzi(V, lista8);
+        GrafCSROgolny<int64_t, int64_t> gc64;
+        gc64.zbudujZKrawedzi(V, lista64);
+        ObszarRoboczy obszar;
+
+        auto sprawdzMST = [&](const char *nazwa, const WynikMST &w, const WynikMSTOgolny<int> &w8, const WynikMST &wDla64,
+                              const WynikMSTOgolny<int64_t> &w64)
+        {
+            bool zgodne = w.krawedzie == w8.krawedzie && w.waga == w8.waga && w64.waga == w.waga * MNOZNIK &&
+                          w64.krawedzie.size() == wDla64.krawedzie.size();
+            for (size_t i = 0; zgodne && i < wDla64.krawedzie.size(); i++)
+                zgodne = w64.krawedzie[i].first == wDla64.krawedzie[i].first &&
+                         w64.krawedzie[i].second == wDla64.krawedzie[i].second;
+            if (!zgodne)
+                blad() << nazwa << ", test " << test << ": inne MST niż na GrafCSR (waga " << w.waga << ", uint8 " << w8.waga
+                       << ", int64 " << w64.waga << ")\n";
+        };
+        auto sprawdzOdleglosci = [&](const char *nazwa, const WynikOdleglosci &w, const WynikOdleglosciOgolny<int, int> &w8,
+                                     const WynikOdleglosci &wDla64, const WynikOdleglosciOgolny<int64_t, int64_t> &w64)
+        {
+            bool zgodne = w.odleglosci == w8.odleglosci && w.poprzednik == w8.poprzednik && w64.odleglosci.size() == (size_t)V &&
+                          w64.poprzednik.size() == (size_t)V;
+            for (int v = 0; zgodne && v < V; v++)
+                zgodne = w64.poprzednik[v] == wDla64.poprzednik[v] &&
+                         (w.odleglosci[v] == INT_MAX ? w64.odleglosci[v] == INT64_MAX : w64.odleglosci[v] == w.odleglosci[v] * MNOZNIK);
+            if (!zgodne)
+                blad() << nazwa << ", test " << test << ": inne odległości niż na GrafCSR\n";
+        };
+
+        for (RodzajKolejki rodzaj : kolejki)
+        {
+            RodzajKolejki rodzaj64 = rodzaj == RodzajKolejki::Kubelkowa ? RodzajKolejki::DArna : rodzaj;
+            WynikMST prim = obliczPrimMSTLista(gc, obszar, rodzaj);
+            obszar.resetuj();
+            WynikMST primDla64 = obliczPrimMSTLista(gc, obszar, rodzaj64);
+            obszar.resetuj();
+            auto prim8 = obliczPrimMSTLista(gc8, obszar, rodzaj);
+            obszar.resetuj();
+            auto prim64 = obliczPrimMSTLista(gc64, obszar, rodzaj);
+            obszar.resetuj();
+            sprawdzMST("Prim", prim, prim8, primDla64, prim64);
+
+            int zrodlo = test % V;
+            WynikOdleglosci dijkstra = obliczDijkstraLista(gc, zrodlo, obszar, rodzaj);
+            obszar.resetuj();
+            WynikOdleglosci dijkstraDla64 = obliczDijkstraLista(gc, zrodlo, obszar, rodzaj64);
+            obszar.resetuj();
+            auto dijkstra8 = obliczDijkstraLista(gc8, zrodlo, obszar, rodzaj);
+            obszar.resetuj();
+            auto dijkstra64 = obliczDijkstraLista(gc64, zrodlo, obszar, rodzaj);
+            obszar.resetuj();
+            sprawdzOdleglosci("Dijkstra", dijkstra, dijkstra8, dijkstraDla64, dijkstra64);
+        }
+        WynikMST kruskal = obliczKruskalMSTLista(gc, obszar);
+        obszar.resetuj();
+        auto kruskal8 = obliczKruskalMSTLista(gc8, obszar);
+        obszar.resetuj();
+        auto kruskal64 = obliczKruskalMSTLista(gc64, obszar);
+        obszar.resetuj();
+        sprawdzMST("Kruskal", kruskal, kruskal8, kruskal, kruskal64);
+        WynikOdleglosci bellmanFord = obliczBellmanFordLista(gc, 0);
+        sprawdzOdleglosci("Bellman-Ford", bellmanFord, obliczBellmanFordLista(gc8, 0), bellmanFord,
+                          obliczBellmanFordLista(gc64, 0));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::pair<const char *, void (*)()> testy[] = {
+        {"dynamiczne-mst", sprawdzDynamiczneMST},
+        {"punkt-punkt", sprawdzPunktPunkt},
+        {"partia-zapytan", sprawdzPartieZapytan},
+        {"harmonogram-prob", sprawdzHarmonogramProb},
+        {"typy-ogolne", sprawdzTypyOgolne},
+    };
+
+    bool znaleziony = false;
+    int nieudane = 0;
+    for (const auto &[nazwa, test] : testy)
+    {
+        if (argc > 1 && strcmp(argv[1], nazwa) != 0)
+            continue;
+        znaleziony = true;
+        bledy = 0;
+        auto start = std::chrono::steady_clock::now();
+        test();
+        std::cout << nazwa << ": " << (bledy ? std::to_string(bledy) + " błędów" : std::string("OK")) << " ("
+             << (int)std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms)\n";
+        if (bledy)
+            nieudane++;
+    }
+    if (!znaleziony)
+    {
+        std::cerr << "Nieznany test: " << argv[1] << "\n";
+        return 1;
+    }
+    return nieudane ? 1 : 0;
+}